@@ -0,0 +1,66 @@
+/*
+    Runs several coroutines on one ESPressio CoroutineThread.
+
+    A producer pushes readings into a queue, a consumer awaits them, and a
+    heartbeat blinks on a delay, all resumed by one FreeRTOS task. Requires
+    a C++20 toolchain (Arduino-ESP32 3.x builds with gnu++2b).
+*/
+
+#include <Arduino.h>
+#include <ESPressio_CoroutineThread.hpp>
+
+using namespace ESPressio::Threads;
+
+CoroutineThread coroutines;
+CoroutineQueue<uint32_t, 8> readings;
+CoroutineSignal reportRequested;
+
+CoroutineTask<uint32_t> Average(uint32_t count) {
+    uint32_t total = 0;
+
+    for (uint32_t index = 0; index < count; ++index) {
+        total += co_await readings.Pop();
+    }
+
+    co_return total / count;
+}
+
+CoroutineTask<> Consumer() {
+    for (;;) {
+        const uint32_t average = co_await Average(4);
+
+        Serial.printf("Average of 4 readings: %u\n", static_cast<unsigned>(average));
+    }
+}
+
+CoroutineTask<> Heartbeat() {
+    for (;;) {
+        co_await reportRequested.Wait();
+
+        Serial.printf("Coroutines running: %u\n", static_cast<unsigned>(coroutines.GetCoroutineCount()));
+    }
+}
+
+CoroutineTask<> Producer() {
+    for (uint32_t reading = 0;; ++reading) {
+        readings.Push(reading);
+
+        co_await Delay(250);
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+
+    coroutines.Spawn(Producer());
+    coroutines.Spawn(Consumer());
+    coroutines.Spawn(Heartbeat());
+    coroutines.Initialize();
+}
+
+void loop() {
+    // Signals and queues may be used from any task.
+    reportRequested.Notify();
+
+    delay(5000);
+}
@@ -0,0 +1,66 @@
+/*
+    Runs many small-stack fibers on one ESPressio FiberThread.
+
+    Each fiber polls a simulated connection in plain blocking style, yielding
+    while it waits, so a hundred handlers share one FreeRTOS task. Fibers
+    run on every ESP32 (Xtensa and RISC-V) and on host builds.
+*/
+
+#include <Arduino.h>
+#include <ESPressio_FiberScheduler.hpp>
+
+using namespace ESPressio::Threads;
+
+#if ESPRESSIO_THREAD_FIBERS
+
+FiberThread fibers;
+std::atomic<uint32_t> requestsServed{0};
+
+void Handler(FiberScheduler& scheduler, uint32_t connection) {
+    for (;;) {
+        // Wait for the (simulated) next request on this connection.
+        scheduler.Sleep(100 + connection % 50);
+
+        // Fiber stacks are small; keep large buffers off them.
+        requestsServed.fetch_add(1);
+        scheduler.Yield();
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+
+    for (uint32_t connection = 0; connection < 100; ++connection) {
+        fibers.Spawn(
+            [connection](FiberScheduler& scheduler) {
+                Handler(scheduler, connection);
+            },
+            1024
+        );
+    }
+
+    fibers.Initialize();
+}
+
+void loop() {
+    Serial.printf(
+        "Fibers: %u, requests served: %u\n",
+        static_cast<unsigned>(fibers.GetScheduler().GetFiberCount()),
+        static_cast<unsigned>(requestsServed.load())
+    );
+
+    delay(1000);
+}
+
+#else
+
+void setup() {
+    Serial.begin(115200);
+    Serial.println("Fibers are not available on this target; see CoroutineThread.");
+}
+
+void loop() {
+    delay(1000);
+}
+
+#endif
@@ -0,0 +1,90 @@
+/*
+    Reports the stack usage of every registered Thread and suggests a
+    SetStackSize() for each.
+
+    The ThreadManager samples once a second on its low-priority sampler task
+    and reports each snapshot to the observer below. Let the application run
+    through its worst case, then copy the suggestions into your code.
+*/
+
+#include <Arduino.h>
+#include <ESPressio_IThreadManagerObserver.hpp>
+#include <ESPressio_Thread.hpp>
+#include <ESPressio_ThreadGarbageCollector.hpp>
+#include <ESPressio_ThreadManager.hpp>
+
+using namespace ESPressio::Threads;
+
+class RecursiveThread : public Thread {
+    private:
+        uint32_t _depth = 0;
+
+        uint32_t Recurse(uint32_t depth) {
+            volatile uint8_t frame[32];
+
+            frame[0] = static_cast<uint8_t>(depth);
+
+            return
+                depth == 0
+                    ? frame[0]
+                    : Recurse(depth - 1) + frame[0];
+        }
+
+    protected:
+        void OnLoop() override {
+            // Stack usage grows each iteration, up to a limit.
+            Recurse(_depth);
+
+            if (_depth < 40) {
+                ++_depth;
+            }
+
+            delay(100);
+        }
+};
+
+class StackReporter : public IThreadManagerObserver {
+    public:
+        void OnThreadRuntimeSampled(
+            IThread* thread,
+            const ThreadRuntimeSnapshot& snapshot
+        ) override {
+            if (
+                !snapshot.StackAvailable ||
+                !snapshot.Stack.Sampled
+            ) {
+                return;
+            }
+
+            Serial.printf(
+                "Thread %u: %u of %u used, suggest SetStackSize(%u)%s\n",
+                static_cast<unsigned>(snapshot.Thread.ThreadID),
+                static_cast<unsigned>(snapshot.Stack.PeakUsed),
+                static_cast<unsigned>(snapshot.Stack.StackSize),
+                static_cast<unsigned>(snapshot.Stack.SuggestedStackSize),
+                snapshot.Stack.Recycled ? " (upper bound, recycled task)" : ""
+            );
+        }
+};
+
+RecursiveThread thread;
+StackReporter reporter;
+
+void setup() {
+    Serial.begin(115200);
+
+    ThreadManager::GetInstance()->RegisterObserver(&reporter);
+    ThreadManager::GetInstance()->Initialize();
+    ThreadManager::GetInstance()->StartSampling(1000);
+}
+
+void loop() {
+    Serial.printf(
+        "Garbage collector stack high-water mark: %u\n",
+        static_cast<unsigned>(
+            ThreadGarbageCollector::GetInstance()->GetStackHighWaterMark()
+        )
+    );
+
+    delay(10000);
+}
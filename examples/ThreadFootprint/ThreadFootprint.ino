@@ -0,0 +1,80 @@
+/*
+    Reports the memory footprint of ESPressio Thread objects.
+
+    Prints sizeof() for each Thread type, then constructs a batch of
+    uninitialized Threads and reports the heap each one costs, excluding
+    any FreeRTOS task. Run it before and after changing Thread members to
+    compare footprints on your target.
+*/
+
+#include <Arduino.h>
+#include <ESPressio_PrecisionThread.hpp>
+#include <ESPressio_StaticThread.hpp>
+#include <ESPressio_Thread.hpp>
+
+using namespace ESPressio::Threads;
+
+constexpr size_t ThreadCount = 60;
+
+class FootprintThread : public Thread {
+    public:
+        ~FootprintThread() override {
+            Shutdown();
+        }
+};
+
+class FootprintPrecisionThread : public PrecisionThread<> {
+    protected:
+        void Iterate(
+            IterationTime,
+            IterationTime,
+            SkippedIterationCount
+        ) override {
+        }
+};
+
+FootprintThread* threads[ThreadCount];
+
+void setup() {
+    Serial.begin(115200);
+
+    Serial.printf(
+        "sizeof(Thread): %u\n",
+        static_cast<unsigned>(sizeof(Thread))
+    );
+
+    Serial.printf(
+        "sizeof(PrecisionThread<>): %u\n",
+        static_cast<unsigned>(sizeof(FootprintPrecisionThread))
+    );
+
+    Serial.printf(
+        "sizeof(StaticThread<4096>): %u\n",
+        static_cast<unsigned>(sizeof(StaticThread<4096>))
+    );
+
+    const uint32_t heapBefore =
+        ESP.getFreeHeap();
+
+    for (size_t index = 0; index < ThreadCount; ++index) {
+        threads[index] = new FootprintThread();
+    }
+
+    const uint32_t heapAfter =
+        ESP.getFreeHeap();
+
+    Serial.printf(
+        "%u Threads: %u bytes of heap, %u bytes each\n",
+        static_cast<unsigned>(ThreadCount),
+        heapBefore - heapAfter,
+        (heapBefore - heapAfter) / ThreadCount
+    );
+
+    for (size_t index = 0; index < ThreadCount; ++index) {
+        delete threads[index];
+        threads[index] = nullptr;
+    }
+}
+
+void loop() {
+}
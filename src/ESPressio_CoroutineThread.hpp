@@ -0,0 +1,1068 @@
+#pragma once
+
+// Coroutine support needs a C++20 compiler; without one this header is empty
+// and ESPRESSIO_THREAD_COROUTINES is 0.
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+    #if __has_include(<coroutine>)
+        #define ESPRESSIO_THREAD_COROUTINES 1
+    #endif
+#endif
+
+#ifndef ESPRESSIO_THREAD_COROUTINES
+    #define ESPRESSIO_THREAD_COROUTINES 0
+#endif
+
+// Longest a CoroutineThread sleeps with nothing to resume, so Pause() and
+// Terminate() are noticed.
+#ifndef ESPRESSIO_THREAD_COROUTINE_MAX_WAIT_MILLISECONDS
+    #define ESPRESSIO_THREAD_COROUTINE_MAX_WAIT_MILLISECONDS 10
+#endif
+
+#if ESPRESSIO_THREAD_COROUTINES
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ESPressio_Thread.hpp"
+
+namespace ESPressio {
+namespace Threads {
+
+    class CoroutineThread;
+
+    template <typename T>
+    class CoroutineTask;
+
+
+    /*
+     * State shared by every CoroutineTask promise.
+     *
+     * `Scheduler` is the CoroutineThread that resumes the coroutine. A root
+     * task gets it from CoroutineThread::Spawn(); an awaited task inherits
+     * it from the coroutine awaiting it.
+     */
+    struct CoroutinePromiseBase {
+        CoroutineThread* Scheduler = nullptr;
+        std::coroutine_handle<> Continuation;
+        std::exception_ptr Exception;
+
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept {
+                return false;
+            }
+
+            template <typename TPromise>
+            std::coroutine_handle<> await_suspend(
+                std::coroutine_handle<TPromise> handle
+            ) noexcept;
+
+            void await_resume() noexcept {
+            }
+        };
+
+
+        // Tasks are lazy: nothing runs until spawned or awaited.
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() noexcept {
+            return {};
+        }
+
+        void unhandled_exception() noexcept {
+            Exception =
+                std::current_exception();
+        }
+    };
+
+
+    template <typename T>
+    struct CoroutinePromise :
+        CoroutinePromiseBase {
+
+        std::optional<T> Value;
+
+        CoroutineTask<T> get_return_object() noexcept;
+
+        template <typename TValue>
+        void return_value(
+            TValue&& value
+        ) {
+            Value.emplace(
+                std::forward<TValue>(value)
+            );
+        }
+
+        T TakeResult() {
+            if (Exception != nullptr) {
+                std::rethrow_exception(
+                    Exception
+                );
+            }
+
+            return
+                std::move(
+                    *Value
+                );
+        }
+    };
+
+
+    template <>
+    struct CoroutinePromise<void> :
+        CoroutinePromiseBase {
+
+        CoroutineTask<void> get_return_object() noexcept;
+
+        void return_void() noexcept {
+        }
+
+        void TakeResult() {
+            if (Exception != nullptr) {
+                std::rethrow_exception(
+                    Exception
+                );
+            }
+        }
+    };
+
+
+    /*
+     * A lazily started coroutine returning `T`, run by a CoroutineThread.
+     *
+     * Spawn a `CoroutineTask<>` on a CoroutineThread, or `co_await` one from
+     * another CoroutineTask. Awaiting resumes the caller with the result, or
+     * rethrows the task's exception. The task object owns the coroutine frame.
+     */
+    template <typename T = void>
+    class CoroutineTask {
+        public:
+            using promise_type =
+                CoroutinePromise<T>;
+
+            using Handle =
+                std::coroutine_handle<
+                    promise_type
+                >;
+
+
+        private:
+            Handle _handle;
+
+
+        public:
+            explicit CoroutineTask(
+                Handle handle
+            ) noexcept :
+                _handle(handle) {
+            }
+
+            CoroutineTask(
+                CoroutineTask&& other
+            ) noexcept :
+                _handle(
+                    std::exchange(
+                        other._handle,
+                        nullptr
+                    )
+                ) {
+            }
+
+            CoroutineTask& operator=(
+                CoroutineTask&& other
+            ) noexcept {
+                if (this != &other) {
+                    if (_handle) {
+                        _handle.destroy();
+                    }
+
+                    _handle =
+                        std::exchange(
+                            other._handle,
+                            nullptr
+                        );
+                }
+
+                return *this;
+            }
+
+            CoroutineTask(
+                const CoroutineTask&
+            ) = delete;
+
+            CoroutineTask& operator=(
+                const CoroutineTask&
+            ) = delete;
+
+            ~CoroutineTask() {
+                if (_handle) {
+                    _handle.destroy();
+                }
+            }
+
+
+            bool IsDone() const noexcept {
+                return
+                    !_handle ||
+                    _handle.done();
+            }
+
+
+            /// Gives up ownership of the coroutine frame.
+            Handle Release() noexcept {
+                return
+                    std::exchange(
+                        _handle,
+                        nullptr
+                    );
+            }
+
+
+            struct Awaiter {
+                Handle Task;
+
+                bool await_ready() noexcept {
+                    return
+                        !Task ||
+                        Task.done();
+                }
+
+                template <typename TPromise>
+                std::coroutine_handle<> await_suspend(
+                    std::coroutine_handle<TPromise> awaiting
+                ) noexcept {
+                    Task.promise().Scheduler =
+                        awaiting.promise().Scheduler;
+
+                    Task.promise().Continuation =
+                        awaiting;
+
+                    return Task;
+                }
+
+                T await_resume() {
+                    return
+                        Task.promise().TakeResult();
+                }
+            };
+
+
+            Awaiter operator co_await() const noexcept {
+                return
+                    Awaiter{
+                        _handle
+                    };
+            }
+    };
+
+
+    template <typename T>
+    CoroutineTask<T>
+    CoroutinePromise<T>::get_return_object() noexcept {
+        return
+            CoroutineTask<T>(
+                CoroutineTask<T>::Handle::from_promise(
+                    *this
+                )
+            );
+    }
+
+
+    inline CoroutineTask<void>
+    CoroutinePromise<void>::get_return_object() noexcept {
+        return
+            CoroutineTask<void>(
+                CoroutineTask<void>::Handle::from_promise(
+                    *this
+                )
+            );
+    }
+
+
+    /*
+     * A Thread whose work is a set of coroutines, all resumed by its one
+     * FreeRTOS task.
+     *
+     * Each coroutine is a `CoroutineTask<>` started with Spawn(). Instead of
+     * polling in OnLoop(), a coroutine suspends with `co_await`:
+     *
+     *   - `co_await Delay(milliseconds)` or `co_await Yield()`
+     *   - `co_await signal.Wait()` on a CoroutineSignal
+     *   - `co_await queue.Pop()` on a CoroutineQueue
+     *   - `co_await SomeOtherTask()` on another CoroutineTask
+     *
+     * While every coroutine waits, the task blocks on a task notification,
+     * so dozens of mostly idle activities share one stack. Coroutine frames
+     * are heap-allocated by the compiler. A coroutine that throws ends; the
+     * exception is passed to OnCoroutineFailed().
+     */
+    class CoroutineThread :
+        public Thread {
+
+        friend struct CoroutinePromiseBase;
+        friend struct CoroutineDelay;
+        friend class CoroutineSignal;
+
+        template <
+            typename T,
+            std::size_t TCapacity
+        >
+        friend class CoroutineQueue;
+
+        private:
+            using RootHandle =
+                std::coroutine_handle<
+                    CoroutinePromise<void>
+                >;
+
+            struct Timer {
+                uint64_t Deadline;
+                std::coroutine_handle<> Handle;
+
+                bool operator>(
+                    const Timer& other
+                ) const {
+                    return Deadline > other.Deadline;
+                }
+            };
+
+
+            // Guards `_ready` and `_roots`, which other tasks touch.
+            std::mutex _coroutineMutex;
+
+            std::vector<
+                std::coroutine_handle<>
+            > _ready;
+
+            std::vector<
+                RootHandle
+            > _roots;
+
+            // Only touched by the worker task.
+            std::vector<
+                std::coroutine_handle<>
+            > _resuming;
+
+            std::vector<
+                Timer
+            > _timers;
+
+            std::vector<
+                RootHandle
+            > _completed;
+
+            uint64_t _ticks = 0;
+            TickType_t _lastTick = 0;
+
+            std::atomic<TaskHandle_t>
+                _schedulerTask{
+                    nullptr
+                };
+
+
+            // Monotonic tick count that does not wrap.
+            uint64_t _now() {
+                const TickType_t tick =
+                    xTaskGetTickCount();
+
+                _ticks +=
+                    static_cast<TickType_t>(
+                        tick - _lastTick
+                    );
+
+                _lastTick = tick;
+
+                return _ticks;
+            }
+
+
+            void _schedule(
+                std::coroutine_handle<> handle
+            ) {
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_coroutineMutex);
+
+                    _ready.push_back(
+                        handle
+                    );
+                }
+
+                const TaskHandle_t task =
+                    _schedulerTask.load(
+                        std::memory_order_acquire
+                    );
+
+                if (task != nullptr) {
+                    xTaskNotifyGive(
+                        task
+                    );
+                }
+            }
+
+
+            void _sleep(
+                std::coroutine_handle<> handle,
+                uint32_t milliseconds
+            ) {
+                if (milliseconds == 0) {
+                    _schedule(handle);
+                    return;
+                }
+
+                const TickType_t ticks =
+                    pdMS_TO_TICKS(milliseconds);
+
+                _timers.push_back({
+                    _now() +
+                        (ticks > 0 ? ticks : 1),
+                    handle
+                });
+
+                std::push_heap(
+                    _timers.begin(),
+                    _timers.end(),
+                    std::greater<Timer>()
+                );
+            }
+
+
+            void _completeRoots() {
+                for (
+                    RootHandle root :
+                    _completed
+                ) {
+                    {
+                        std::lock_guard<
+                            std::mutex
+                        > lock(_coroutineMutex);
+
+                        _roots.erase(
+                            std::remove(
+                                _roots.begin(),
+                                _roots.end(),
+                                root
+                            ),
+                            _roots.end()
+                        );
+                    }
+
+                    const std::exception_ptr exception =
+                        root.promise().Exception;
+
+                    root.destroy();
+
+                    if (exception != nullptr) {
+                        try {
+                            OnCoroutineFailed(
+                                exception
+                            );
+                        } catch (...) {
+                        }
+                    }
+                }
+
+                _completed.clear();
+            }
+
+
+        protected:
+            void OnLoop() override {
+                _schedulerTask.store(
+                    xTaskGetCurrentTaskHandle(),
+                    std::memory_order_release
+                );
+
+                const uint64_t now =
+                    _now();
+
+                while (
+                    !_timers.empty() &&
+                    _timers.front().Deadline <= now
+                ) {
+                    std::pop_heap(
+                        _timers.begin(),
+                        _timers.end(),
+                        std::greater<Timer>()
+                    );
+
+                    const std::coroutine_handle<> handle =
+                        _timers.back().Handle;
+
+                    _timers.pop_back();
+
+                    handle.resume();
+                }
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_coroutineMutex);
+
+                    _resuming.swap(
+                        _ready
+                    );
+                }
+
+                for (
+                    std::coroutine_handle<> handle :
+                    _resuming
+                ) {
+                    handle.resume();
+                }
+
+                _resuming.clear();
+
+                _completeRoots();
+
+                TickType_t wait =
+                    pdMS_TO_TICKS(
+                        ESPRESSIO_THREAD_COROUTINE_MAX_WAIT_MILLISECONDS
+                    );
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_coroutineMutex);
+
+                    if (!_ready.empty()) {
+                        wait = 0;
+                    }
+                }
+
+                if (!_timers.empty()) {
+                    const uint64_t current =
+                        _now();
+
+                    const uint64_t untilDeadline =
+                        _timers.front().Deadline > current
+                            ? _timers.front().Deadline - current
+                            : 0;
+
+                    if (untilDeadline < wait) {
+                        wait =
+                            static_cast<TickType_t>(
+                                untilDeadline
+                            );
+                    }
+                }
+
+                if (wait > 0) {
+                    ulTaskNotifyTake(
+                        pdTRUE,
+                        wait
+                    );
+                }
+            }
+
+
+            /// Called on the worker task when a spawned coroutine ends with
+            /// an exception.
+            virtual void OnCoroutineFailed(
+                std::exception_ptr exception
+            ) {
+                (void)exception;
+            }
+
+
+        public:
+            CoroutineThread() :
+                Thread() {
+                _lastTick =
+                    xTaskGetTickCount();
+            }
+
+
+            explicit CoroutineThread(
+                bool freeOnTerminate
+            ) :
+                Thread(
+                    freeOnTerminate
+                ) {
+                _lastTick =
+                    xTaskGetTickCount();
+            }
+
+
+            /// Stops the worker, then destroys every unfinished coroutine.
+            ~CoroutineThread() override {
+                Shutdown();
+
+                for (
+                    RootHandle root :
+                    _roots
+                ) {
+                    root.destroy();
+                }
+            }
+
+
+            /// Starts `task` on this Thread. Safe to call from any task and
+            /// before Initialize(); the coroutine first runs once the Thread
+            /// is Running.
+            void Spawn(
+                CoroutineTask<> task
+            ) {
+                const RootHandle root =
+                    task.Release();
+
+                if (!root) {
+                    return;
+                }
+
+                root.promise().Scheduler = this;
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_coroutineMutex);
+
+                    _roots.push_back(
+                        root
+                    );
+                }
+
+                _schedule(root);
+            }
+
+
+            /// Number of spawned coroutines that have not finished.
+            std::size_t GetCoroutineCount() {
+                std::lock_guard<
+                    std::mutex
+                > lock(_coroutineMutex);
+
+                return _roots.size();
+            }
+    };
+
+
+    template <typename TPromise>
+    std::coroutine_handle<>
+    CoroutinePromiseBase::FinalAwaiter::await_suspend(
+        std::coroutine_handle<TPromise> handle
+    ) noexcept {
+        CoroutinePromiseBase& promise =
+            handle.promise();
+
+        if (promise.Continuation) {
+            return promise.Continuation;
+        }
+
+        // A root task: the worker destroys it after this resumption.
+        if constexpr (
+            std::is_same<
+                TPromise,
+                CoroutinePromise<void>
+            >::value
+        ) {
+            if (promise.Scheduler != nullptr) {
+                promise.Scheduler->_completed.push_back(
+                    handle
+                );
+            }
+        }
+
+        return std::noop_coroutine();
+    }
+
+
+    struct CoroutineDelay {
+        uint32_t Milliseconds;
+
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        template <typename TPromise>
+        void await_suspend(
+            std::coroutine_handle<TPromise> handle
+        ) {
+            handle.promise().Scheduler->_sleep(
+                handle,
+                Milliseconds
+            );
+        }
+
+        void await_resume() noexcept {
+        }
+    };
+
+
+    /// Suspends the calling coroutine for at least `milliseconds`.
+    inline CoroutineDelay Delay(
+        uint32_t milliseconds
+    ) {
+        return
+            CoroutineDelay{
+                milliseconds
+            };
+    }
+
+
+    /// Lets every other ready coroutine run before the caller continues.
+    inline CoroutineDelay Yield() {
+        return
+            Delay(
+                0
+            );
+    }
+
+
+    /*
+     * Wakes coroutines waiting for work.
+     *
+     * Notify() resumes one waiter, or is remembered until the next Wait() if
+     * none is waiting (like a binary semaphore). Call it from any task, not
+     * from an ISR. Destroy a signal only once no coroutine waits on it.
+     */
+    class CoroutineSignal {
+        private:
+            struct Waiter {
+                CoroutineThread* Scheduler;
+                std::coroutine_handle<> Handle;
+            };
+
+            std::mutex _mutex;
+            bool _signaled = false;
+
+            std::vector<
+                Waiter
+            > _waiters;
+
+
+        public:
+            void Notify() {
+                Waiter waiter{
+                    nullptr,
+                    nullptr
+                };
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    if (_waiters.empty()) {
+                        _signaled = true;
+                        return;
+                    }
+
+                    waiter =
+                        _waiters.front();
+
+                    _waiters.erase(
+                        _waiters.begin()
+                    );
+                }
+
+                waiter.Scheduler->_schedule(
+                    waiter.Handle
+                );
+            }
+
+
+            /// Resumes every current waiter.
+            void NotifyAll() {
+                std::vector<
+                    Waiter
+                > waiters;
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    waiters.swap(
+                        _waiters
+                    );
+                }
+
+                for (
+                    const Waiter& waiter :
+                    waiters
+                ) {
+                    waiter.Scheduler->_schedule(
+                        waiter.Handle
+                    );
+                }
+            }
+
+
+            struct Awaiter {
+                CoroutineSignal& Signal;
+
+                bool await_ready() {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(Signal._mutex);
+
+                    return
+                        std::exchange(
+                            Signal._signaled,
+                            false
+                        );
+                }
+
+                template <typename TPromise>
+                bool await_suspend(
+                    std::coroutine_handle<TPromise> handle
+                ) {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(Signal._mutex);
+
+                    if (
+                        std::exchange(
+                            Signal._signaled,
+                            false
+                        )
+                    ) {
+                        return false;
+                    }
+
+                    Signal._waiters.push_back({
+                        handle.promise().Scheduler,
+                        handle
+                    });
+
+                    return true;
+                }
+
+                void await_resume() noexcept {
+                }
+            };
+
+
+            Awaiter Wait() {
+                return
+                    Awaiter{
+                        *this
+                    };
+            }
+    };
+
+
+    /*
+     * Fixed-capacity queue whose Pop() suspends a coroutine until an item
+     * arrives.
+     *
+     * Push() may be called from any task (not an ISR) and returns `false`
+     * when full. An item pushed while a coroutine waits is handed straight
+     * to the longest waiter. Destroy a queue only once no coroutine waits
+     * on it.
+     */
+    template <
+        typename T,
+        std::size_t TCapacity
+    >
+    class CoroutineQueue {
+        static_assert(
+            TCapacity > 0,
+            "CoroutineQueue capacity must be at least 1"
+        );
+
+        private:
+            struct Waiter {
+                CoroutineThread* Scheduler;
+                std::coroutine_handle<> Handle;
+                std::optional<T>* Slot;
+            };
+
+            std::mutex _mutex;
+
+            std::array<
+                std::optional<T>,
+                TCapacity
+            > _items;
+
+            std::size_t _head = 0;
+            std::size_t _count = 0;
+
+            std::vector<
+                Waiter
+            > _waiters;
+
+
+            bool _tryPopLocked(
+                std::optional<T>& value
+            ) {
+                if (_count == 0) {
+                    return false;
+                }
+
+                value =
+                    std::move(
+                        _items[_head]
+                    );
+
+                _items[_head].reset();
+
+                _head =
+                    (_head + 1) %
+                    TCapacity;
+
+                --_count;
+
+                return true;
+            }
+
+
+        public:
+            bool Push(
+                T value
+            ) {
+                Waiter waiter{
+                    nullptr,
+                    nullptr,
+                    nullptr
+                };
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    if (_waiters.empty()) {
+                        if (_count == TCapacity) {
+                            return false;
+                        }
+
+                        _items[(_head + _count) % TCapacity].emplace(
+                            std::move(value)
+                        );
+
+                        ++_count;
+
+                        return true;
+                    }
+
+                    waiter =
+                        _waiters.front();
+
+                    _waiters.erase(
+                        _waiters.begin()
+                    );
+
+                    waiter.Slot->emplace(
+                        std::move(value)
+                    );
+                }
+
+                waiter.Scheduler->_schedule(
+                    waiter.Handle
+                );
+
+                return true;
+            }
+
+
+            /// Pops without waiting. Returns `false` when empty.
+            bool TryPop(
+                T& value
+            ) {
+                std::optional<T> item;
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    if (!_tryPopLocked(item)) {
+                        return false;
+                    }
+                }
+
+                value =
+                    std::move(
+                        *item
+                    );
+
+                return true;
+            }
+
+
+            std::size_t GetCount() {
+                std::lock_guard<
+                    std::mutex
+                > lock(_mutex);
+
+                return _count;
+            }
+
+
+            struct Awaiter {
+                CoroutineQueue& Queue;
+                std::optional<T> Value;
+
+                bool await_ready() {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(Queue._mutex);
+
+                    return
+                        Queue._tryPopLocked(
+                            Value
+                        );
+                }
+
+                template <typename TPromise>
+                bool await_suspend(
+                    std::coroutine_handle<TPromise> handle
+                ) {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(Queue._mutex);
+
+                    if (Queue._tryPopLocked(Value)) {
+                        return false;
+                    }
+
+                    Queue._waiters.push_back({
+                        handle.promise().Scheduler,
+                        handle,
+                        &Value
+                    });
+
+                    return true;
+                }
+
+                T await_resume() {
+                    return
+                        std::move(
+                            *Value
+                        );
+                }
+            };
+
+
+            Awaiter Pop() {
+                return
+                    Awaiter{
+                        *this,
+                        std::nullopt
+                    };
+            }
+    };
+
+}
+}
+
+#endif
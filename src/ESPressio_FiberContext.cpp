@@ -0,0 +1,439 @@
+#include "ESPressio_FiberContext.hpp"
+
+#if ESPRESSIO_THREAD_FIBERS
+
+#include <cstring>
+
+#if ESPRESSIO_THREAD_FIBER_RISCV || ESPRESSIO_THREAD_FIBER_XTENSA
+    #include "freertos/FreeRTOS.h"
+    #include "freertos/task.h"
+
+    #if ESPRESSIO_THREAD_FIBER_RISCV && defined(CONFIG_ESP_SYSTEM_HW_STACK_GUARD)
+        #include "esp_private/hw_stack_guard.h"
+
+        #define ESPRESSIO_FIBER_STACK_GUARD 1
+    #endif
+#endif
+
+#if ESPRESSIO_THREAD_FIBER_RISCV
+
+/*
+ * Frame saved on a fiber's stack by espressio_fiber_switch: ra, s0-s11 and,
+ * with an FPU, fs0-fs11. The frame size keeps the 16-byte stack alignment.
+ */
+#if defined(__riscv_flen) && __riscv_flen == 64
+    #define ESPRESSIO_FIBER_FRAME "160"
+    #define ESPRESSIO_FIBER_FLOAT(op) \
+        "    " #op " fs0, 56(sp)\n" \
+        "    " #op " fs1, 64(sp)\n" \
+        "    " #op " fs2, 72(sp)\n" \
+        "    " #op " fs3, 80(sp)\n" \
+        "    " #op " fs4, 88(sp)\n" \
+        "    " #op " fs5, 96(sp)\n" \
+        "    " #op " fs6, 104(sp)\n" \
+        "    " #op " fs7, 112(sp)\n" \
+        "    " #op " fs8, 120(sp)\n" \
+        "    " #op " fs9, 128(sp)\n" \
+        "    " #op " fs10, 136(sp)\n" \
+        "    " #op " fs11, 144(sp)\n"
+    #define ESPRESSIO_FIBER_FLOAT_SAVE ESPRESSIO_FIBER_FLOAT(fsd)
+    #define ESPRESSIO_FIBER_FLOAT_RESTORE ESPRESSIO_FIBER_FLOAT(fld)
+    #define ESPRESSIO_FIBER_FRAME_BYTES 160
+#elif defined(__riscv_flen) && __riscv_flen == 32
+    #define ESPRESSIO_FIBER_FRAME "112"
+    #define ESPRESSIO_FIBER_FLOAT(op) \
+        "    " #op " fs0, 52(sp)\n" \
+        "    " #op " fs1, 56(sp)\n" \
+        "    " #op " fs2, 60(sp)\n" \
+        "    " #op " fs3, 64(sp)\n" \
+        "    " #op " fs4, 68(sp)\n" \
+        "    " #op " fs5, 72(sp)\n" \
+        "    " #op " fs6, 76(sp)\n" \
+        "    " #op " fs7, 80(sp)\n" \
+        "    " #op " fs8, 84(sp)\n" \
+        "    " #op " fs9, 88(sp)\n" \
+        "    " #op " fs10, 92(sp)\n" \
+        "    " #op " fs11, 96(sp)\n"
+    #define ESPRESSIO_FIBER_FLOAT_SAVE ESPRESSIO_FIBER_FLOAT(fsw)
+    #define ESPRESSIO_FIBER_FLOAT_RESTORE ESPRESSIO_FIBER_FLOAT(flw)
+    #define ESPRESSIO_FIBER_FRAME_BYTES 112
+#else
+    #define ESPRESSIO_FIBER_FRAME "64"
+    #define ESPRESSIO_FIBER_FLOAT_SAVE ""
+    #define ESPRESSIO_FIBER_FLOAT_RESTORE ""
+    #define ESPRESSIO_FIBER_FRAME_BYTES 64
+#endif
+
+#define ESPRESSIO_FIBER_INTEGER(op) \
+    "    " #op " ra, 0(sp)\n" \
+    "    " #op " s0, 4(sp)\n" \
+    "    " #op " s1, 8(sp)\n" \
+    "    " #op " s2, 12(sp)\n" \
+    "    " #op " s3, 16(sp)\n" \
+    "    " #op " s4, 20(sp)\n" \
+    "    " #op " s5, 24(sp)\n" \
+    "    " #op " s6, 28(sp)\n" \
+    "    " #op " s7, 32(sp)\n" \
+    "    " #op " s8, 36(sp)\n" \
+    "    " #op " s9, 40(sp)\n" \
+    "    " #op " s10, 44(sp)\n" \
+    "    " #op " s11, 48(sp)\n"
+
+extern "C" {
+    // a0: where to store the current stack pointer; a1: stack to resume.
+    void espressio_fiber_switch(
+        void** from,
+        void* to
+    );
+
+    void espressio_fiber_start();
+}
+
+asm(
+    "    .text\n"
+    "    .align 2\n"
+    "    .globl espressio_fiber_switch\n"
+    "    .type espressio_fiber_switch, @function\n"
+    "espressio_fiber_switch:\n"
+    "    addi sp, sp, -" ESPRESSIO_FIBER_FRAME "\n"
+    ESPRESSIO_FIBER_INTEGER(sw)
+    ESPRESSIO_FIBER_FLOAT_SAVE
+    "    sw sp, 0(a0)\n"
+    "    mv sp, a1\n"
+    ESPRESSIO_FIBER_INTEGER(lw)
+    ESPRESSIO_FIBER_FLOAT_RESTORE
+    "    addi sp, sp, " ESPRESSIO_FIBER_FRAME "\n"
+    "    ret\n"
+    "    .size espressio_fiber_switch, . - espressio_fiber_switch\n"
+    "\n"
+    // First resumption of a fiber "returns" here with s0 = start and
+    // s1 = its FiberContext. The start function never returns.
+    "    .align 2\n"
+    "    .globl espressio_fiber_start\n"
+    "    .type espressio_fiber_start, @function\n"
+    "espressio_fiber_start:\n"
+    "    mv a0, s1\n"
+    "    jalr s0\n"
+    "1:\n"
+    "    j 1b\n"
+    "    .size espressio_fiber_start, . - espressio_fiber_start\n"
+);
+
+#elif ESPRESSIO_THREAD_FIBER_XTENSA
+
+extern "C" {
+    void xthal_window_spill();
+
+    // a2: where to store the current stack pointer; a3: stack to resume.
+    void espressio_fiber_switch(
+        void** from,
+        void* to
+    );
+
+    // As espressio_fiber_switch, but calls start(context) on a fresh stack.
+    void espressio_fiber_enter(
+        void** from,
+        void* stackPointer,
+        void (*start)(void*),
+        void* context
+    );
+}
+
+/*
+ * Both routines spill every caller window, so only their own frame is live,
+ * and keep its return address at 0(sp). Resuming loads the other stack's
+ * sp and return address and `retw`s; the window underflow that follows
+ * reloads SwitchFiberContext()'s frame from that stack.
+ */
+asm(
+    "    .text\n"
+    "    .literal_position\n"
+    "    .align 4\n"
+    "    .globl espressio_fiber_switch\n"
+    "    .type espressio_fiber_switch, @function\n"
+    "espressio_fiber_switch:\n"
+    "    entry a1, 48\n"
+    "    movi a8, xthal_window_spill\n"
+    "    callx8 a8\n"
+    "    s32i a0, a1, 0\n"
+    "    s32i a1, a2, 0\n"
+    "    mov a1, a3\n"
+    "    l32i a0, a1, 0\n"
+    "    retw\n"
+    "    .size espressio_fiber_switch, . - espressio_fiber_switch\n"
+    "\n"
+    "    .literal_position\n"
+    "    .align 4\n"
+    "    .globl espressio_fiber_enter\n"
+    "    .type espressio_fiber_enter, @function\n"
+    "espressio_fiber_enter:\n"
+    "    entry a1, 48\n"
+    "    movi a8, xthal_window_spill\n"
+    "    callx8 a8\n"
+    "    s32i a0, a1, 0\n"
+    "    s32i a1, a2, 0\n"
+    "    mov a1, a3\n"
+    // A null return address ends backtraces at the fiber's first frame.
+    "    movi a0, 0\n"
+    "    mov a10, a5\n"
+    "    callx8 a4\n"
+    "1:\n"
+    "    j 1b\n"
+    "    .size espressio_fiber_enter, . - espressio_fiber_enter\n"
+);
+
+#endif
+
+namespace ESPressio {
+namespace Threads {
+
+    #if ESPRESSIO_THREAD_FIBER_UCONTEXT
+
+        namespace {
+
+            void _ucontextEntry(
+                unsigned int high,
+                unsigned int low
+            ) {
+                const uintptr_t address =
+                    (static_cast<uintptr_t>(high) << 16 << 16) |
+                    static_cast<uintptr_t>(low);
+
+                FiberContext* context =
+                    reinterpret_cast<FiberContext*>(address);
+
+                context->Entry(
+                    context->Argument
+                );
+            }
+
+        }
+
+
+        void PrepareFiberContext(
+            FiberContext& context,
+            void* stack,
+            std::size_t stackSize,
+            FiberEntry entry,
+            void* argument
+        ) {
+            getcontext(&context.Context);
+
+            context.Context.uc_stack.ss_sp = stack;
+            context.Context.uc_stack.ss_size = stackSize;
+            context.Context.uc_link = nullptr;
+
+            context.Entry = entry;
+            context.Argument = argument;
+
+            const uintptr_t address =
+                reinterpret_cast<uintptr_t>(&context);
+
+            makecontext(
+                &context.Context,
+                reinterpret_cast<void (*)()>(_ucontextEntry),
+                2,
+                static_cast<unsigned int>(address >> 16 >> 16),
+                static_cast<unsigned int>(address)
+            );
+        }
+
+
+        void SwitchFiberContext(
+            FiberContext& from,
+            FiberContext& to
+        ) {
+            swapcontext(
+                &from.Context,
+                &to.Context
+            );
+        }
+
+    #else
+
+        namespace {
+
+            // tskSTACK_FILL_BYTE: FreeRTOS reads it for the overflow canary
+            // and the high-water mark.
+            constexpr int _stackFillByte = 0xa5;
+
+
+            /*
+             * Points the task's TCB, and the hardware stack guard where
+             * enabled, at the stack of `to`, keeping the current bounds in
+             * `from`. Interrupts stay masked until `to` runs, since a
+             * context switch in between would check the TCB bounds against
+             * the wrong stack.
+             */
+            void _beginSwitch(
+                FiberContext& from,
+                FiberContext& to
+            ) {
+                to.InterruptState =
+                    portSET_INTERRUPT_MASK_FROM_ISR();
+
+                StaticTask_t* task =
+                    reinterpret_cast<StaticTask_t*>(
+                        xTaskGetCurrentTaskHandle()
+                    );
+
+                from.StackStart = task->pxDummy6;
+                task->pxDummy6 = to.StackStart;
+
+                #if configRECORD_STACK_HIGH_ADDRESS
+                    from.StackEnd = task->pxDummy8;
+                    task->pxDummy8 = to.StackEnd;
+                #endif
+
+                #if ESPRESSIO_FIBER_STACK_GUARD
+                    esp_hw_stack_guard_monitor_stop();
+
+                    esp_hw_stack_guard_set_bounds(
+                        reinterpret_cast<uint32_t>(to.StackStart),
+                        reinterpret_cast<uint32_t>(to.StackEnd)
+                    );
+                #endif
+            }
+
+
+            // Runs on the stack of the context just resumed.
+            void _endSwitch(
+                FiberContext& context
+            ) {
+                #if ESPRESSIO_FIBER_STACK_GUARD
+                    esp_hw_stack_guard_monitor_start();
+                #endif
+
+                portCLEAR_INTERRUPT_MASK_FROM_ISR(
+                    context.InterruptState
+                );
+            }
+
+
+            void _startFiber(
+                void* argument
+            ) {
+                FiberContext& context =
+                    *static_cast<FiberContext*>(argument);
+
+                _endSwitch(
+                    context
+                );
+
+                context.Entry(
+                    context.Argument
+                );
+            }
+
+        }
+
+
+        void PrepareFiberContext(
+            FiberContext& context,
+            void* stack,
+            std::size_t stackSize,
+            FiberEntry entry,
+            void* argument
+        ) {
+            std::memset(
+                stack,
+                _stackFillByte,
+                stackSize
+            );
+
+            uintptr_t top =
+                reinterpret_cast<uintptr_t>(stack) + stackSize;
+
+            top &= ~static_cast<uintptr_t>(15);
+
+            context.StackStart = stack;
+            context.StackEnd = reinterpret_cast<void*>(top);
+
+            context.Entry = entry;
+            context.Argument = argument;
+            context.Started = false;
+
+            #if ESPRESSIO_THREAD_FIBER_RISCV
+                uint32_t* frame =
+                    reinterpret_cast<uint32_t*>(
+                        top - ESPRESSIO_FIBER_FRAME_BYTES
+                    );
+
+                std::memset(
+                    frame,
+                    0,
+                    ESPRESSIO_FIBER_FRAME_BYTES
+                );
+
+                frame[0] = reinterpret_cast<uint32_t>(&espressio_fiber_start);
+                frame[1] = reinterpret_cast<uint32_t>(&_startFiber);
+                frame[2] = reinterpret_cast<uint32_t>(&context);
+
+                context.StackPointer = frame;
+            #else
+                // The first frame's sp leaves 32 scratch bytes above it.
+                // Below it sits the base save area of its (absent) caller:
+                // a0 = 0 ends backtraces, and a1 points at the scratch
+                // area, where a window overflow parks that frame's a4-a7.
+                const uintptr_t stackPointer =
+                    top - 32;
+
+                uint32_t* callerSaveArea =
+                    reinterpret_cast<uint32_t*>(
+                        stackPointer - 16
+                    );
+
+                callerSaveArea[0] = 0;
+                callerSaveArea[1] = static_cast<uint32_t>(top);
+                callerSaveArea[2] = 0;
+                callerSaveArea[3] = 0;
+
+                context.StackPointer =
+                    reinterpret_cast<void*>(stackPointer);
+            #endif
+        }
+
+
+        void SwitchFiberContext(
+            FiberContext& from,
+            FiberContext& to
+        ) {
+            _beginSwitch(
+                from,
+                to
+            );
+
+            #if ESPRESSIO_THREAD_FIBER_XTENSA
+                if (!to.Started) {
+                    to.Started = true;
+
+                    espressio_fiber_enter(
+                        &from.StackPointer,
+                        to.StackPointer,
+                        _startFiber,
+                        &to
+                    );
+                } else {
+                    espressio_fiber_switch(
+                        &from.StackPointer,
+                        to.StackPointer
+                    );
+                }
+            #else
+                espressio_fiber_switch(
+                    &from.StackPointer,
+                    to.StackPointer
+                );
+            #endif
+
+            _endSwitch(
+                from
+            );
+        }
+
+    #endif
+
+}
+}
+
+#endif
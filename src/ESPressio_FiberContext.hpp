@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * User-space context switching for FiberScheduler.
+ *
+ * Backends:
+ *   - POSIX `ucontext` on host builds (including the FreeRTOS POSIX port).
+ *   - Hand-written assembly on 32-bit RISC-V (ESP32-C and -H series),
+ *     saving the callee-saved integer and, with an FPU, float registers.
+ *   - Hand-written assembly on windowed-ABI Xtensa (ESP32, -S2, -S3). Caller
+ *     frames may still sit in the register file, so every live window is
+ *     spilled with xthal_window_spill() before the stack pointer moves; the
+ *     resumed context then reloads its callers from its own stack.
+ *
+ * On both targets the task's TCB stack bounds follow the running fiber, so
+ * FreeRTOS overflow checks see the stack actually in use. On RISC-V the
+ * ESP-IDF hardware stack guard, which the port reloads from the TCB, is
+ * also reprogrammed on every switch.
+ *
+ * ESPRESSIO_THREAD_FIBERS is 1 where a backend exists.
+ */
+#ifndef ESPRESSIO_THREAD_FIBERS
+    #if defined(__riscv) && __riscv_xlen == 32
+        #define ESPRESSIO_THREAD_FIBERS 1
+        #define ESPRESSIO_THREAD_FIBER_RISCV 1
+    #elif defined(__XTENSA__) && defined(__XTENSA_WINDOWED_ABI__)
+        #define ESPRESSIO_THREAD_FIBERS 1
+        #define ESPRESSIO_THREAD_FIBER_XTENSA 1
+    #elif !defined(ESP_PLATFORM) && defined(__has_include)
+        #if __has_include(<ucontext.h>)
+            #define ESPRESSIO_THREAD_FIBERS 1
+            #define ESPRESSIO_THREAD_FIBER_UCONTEXT 1
+        #endif
+    #endif
+#endif
+
+#ifndef ESPRESSIO_THREAD_FIBERS
+    #define ESPRESSIO_THREAD_FIBERS 0
+#endif
+
+#if ESPRESSIO_THREAD_FIBER_UCONTEXT
+    #include <ucontext.h>
+#endif
+
+namespace ESPressio {
+namespace Threads {
+
+    #if ESPRESSIO_THREAD_FIBERS
+
+        using FiberEntry =
+            void (*)(void*);
+
+        #if ESPRESSIO_THREAD_FIBER_UCONTEXT
+            struct FiberContext {
+                ucontext_t Context;
+
+                // makecontext() only passes ints, so the trampoline finds
+                // these through the context itself.
+                FiberEntry Entry = nullptr;
+                void* Argument = nullptr;
+            };
+        #else
+            // Saved registers live on the fiber's own stack.
+            struct FiberContext {
+                void* StackPointer = nullptr;
+
+                // Written into the task's TCB while this context runs.
+                void* StackStart = nullptr;
+                void* StackEnd = nullptr;
+
+                // Interrupt mask restored once this context resumes.
+                uint32_t InterruptState = 0;
+
+                FiberEntry Entry = nullptr;
+                void* Argument = nullptr;
+
+                // Xtensa enters a fiber through its own routine the first
+                // time.
+                bool Started = false;
+            };
+        #endif
+
+
+        /// Prepares `context` to call `entry(argument)` on the given stack
+        /// when first switched to. `entry` must never return.
+        void PrepareFiberContext(
+            FiberContext& context,
+            void* stack,
+            std::size_t stackSize,
+            FiberEntry entry,
+            void* argument
+        );
+
+        /// Saves the running context in `from` and resumes `to`.
+        void SwitchFiberContext(
+            FiberContext& from,
+            FiberContext& to
+        );
+
+    #endif
+
+}
+}
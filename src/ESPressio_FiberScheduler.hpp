@@ -0,0 +1,606 @@
+#pragma once
+
+#include "ESPressio_FiberContext.hpp"
+
+// Stack of a fiber spawned without an explicit size, in bytes.
+#ifndef ESPRESSIO_THREAD_FIBER_DEFAULT_STACK_SIZE
+    #define ESPRESSIO_THREAD_FIBER_DEFAULT_STACK_SIZE 1024
+#endif
+
+// Longest a FiberThread sleeps with no fiber ready, so Pause(), Terminate()
+// and fibers waiting on a condition are noticed.
+#ifndef ESPRESSIO_THREAD_FIBER_MAX_WAIT_MILLISECONDS
+    #define ESPRESSIO_THREAD_FIBER_MAX_WAIT_MILLISECONDS 10
+#endif
+
+#if ESPRESSIO_THREAD_FIBERS
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "ESPressio_Thread.hpp"
+
+namespace ESPressio {
+namespace Threads {
+
+    class FiberScheduler;
+
+    using TFiberBody =
+        std::function<
+            void(FiberScheduler&)
+        >;
+
+    using TOnFiberFailed =
+        std::function<
+            void(std::exception_ptr)
+        >;
+
+
+    /*
+     * Runs many small-stack fibers on the task that calls RunOnce().
+     *
+     * Fibers switch cooperatively in user space: a fiber runs until it calls
+     * Yield(), Sleep() or WaitUntil() on the scheduler passed to its body,
+     * so each activity costs only its own stack rather than a FreeRTOS task.
+     * Host it from any Thread's OnLoop(), or use FiberThread.
+     *
+     * Only Spawn() and Wake() may be called from other tasks. A fiber must
+     * not block its host task for long (with vTaskDelay(), a mutex and so
+     * on), since every other fiber waits with it. Exceptions cannot cross
+     * fiber stacks: one escaping a body ends that fiber and is passed to
+     * the OnFiberFailed callback.
+     */
+    class FiberScheduler {
+        private:
+            enum class FiberState : uint8_t {
+                Ready,
+                Sleeping,
+                Waiting,
+                Finished
+            };
+
+            struct Fiber {
+                FiberContext Context;
+                FiberScheduler* Scheduler = nullptr;
+                TFiberBody Body;
+                std::unique_ptr<unsigned char[]> Stack;
+                std::size_t StackSize = 0;
+                FiberState State = FiberState::Ready;
+                uint64_t WakeTick = 0;
+                std::function<bool()> Condition;
+            };
+
+
+            FiberContext _hostContext;
+            Fiber* _current = nullptr;
+
+            // Owned by the hosting task.
+            std::vector<
+                std::unique_ptr<Fiber>
+            > _fibers;
+
+            // Spawned from any task, adopted by the next RunOnce().
+            std::mutex _spawnMutex;
+
+            std::vector<
+                std::unique_ptr<Fiber>
+            > _spawned;
+
+            std::atomic<std::size_t>
+                _fiberCount{
+                    0
+                };
+
+            std::atomic<bool>
+                _wakeRequested{
+                    false
+                };
+
+            std::atomic<TaskHandle_t>
+                _hostTask{
+                    nullptr
+                };
+
+            std::mutex _callbackMutex;
+            TOnFiberFailed _onFiberFailed;
+
+            uint64_t _ticks = 0;
+            TickType_t _lastTick = xTaskGetTickCount();
+
+
+            uint64_t _now() {
+                const TickType_t tick =
+                    xTaskGetTickCount();
+
+                _ticks +=
+                    static_cast<TickType_t>(
+                        tick - _lastTick
+                    );
+
+                _lastTick = tick;
+
+                return _ticks;
+            }
+
+
+            static void _fiberEntry(
+                void* argument
+            ) {
+                Fiber* fiber =
+                    static_cast<Fiber*>(argument);
+
+                FiberScheduler& scheduler =
+                    *fiber->Scheduler;
+
+                try {
+                    fiber->Body(
+                        scheduler
+                    );
+                } catch (...) {
+                    TOnFiberFailed onFiberFailed;
+
+                    {
+                        std::lock_guard<
+                            std::mutex
+                        > lock(scheduler._callbackMutex);
+
+                        onFiberFailed =
+                            scheduler._onFiberFailed;
+                    }
+
+                    if (onFiberFailed != nullptr) {
+                        try {
+                            onFiberFailed(
+                                std::current_exception()
+                            );
+                        } catch (...) {
+                        }
+                    }
+                }
+
+                // Release captures while still on this fiber's stack.
+                fiber->Body = nullptr;
+                fiber->Condition = nullptr;
+                fiber->State = FiberState::Finished;
+
+                // Never resumed again; RunOnce() frees the stack.
+                SwitchFiberContext(
+                    fiber->Context,
+                    scheduler._hostContext
+                );
+            }
+
+
+            void _suspend(
+                FiberState state
+            ) {
+                Fiber* fiber = _current;
+
+                fiber->State = state;
+
+                SwitchFiberContext(
+                    fiber->Context,
+                    _hostContext
+                );
+            }
+
+
+        public:
+            FiberScheduler() = default;
+
+            FiberScheduler(
+                const FiberScheduler&
+            ) = delete;
+
+            FiberScheduler& operator=(
+                const FiberScheduler&
+            ) = delete;
+
+
+            /// Frees every fiber, finished or not, without running it
+            /// further. Destroy the scheduler only while RunOnce() is not
+            /// running; objects on unfinished fiber stacks are not
+            /// destroyed.
+            ~FiberScheduler() = default;
+
+
+            /// Adds a fiber running `body` with a stack of `stackSize` bytes
+            /// (ESPRESSIO_THREAD_FIBER_DEFAULT_STACK_SIZE when 0). Safe from
+            /// any task. Returns `false` if the stack cannot be allocated.
+            bool Spawn(
+                TFiberBody body,
+                std::size_t stackSize = 0
+            ) {
+                if (body == nullptr) {
+                    return false;
+                }
+
+                std::unique_ptr<Fiber> fiber(
+                    new (std::nothrow) Fiber()
+                );
+
+                if (fiber == nullptr) {
+                    return false;
+                }
+
+                fiber->StackSize =
+                    stackSize > 0
+                        ? stackSize
+                        : ESPRESSIO_THREAD_FIBER_DEFAULT_STACK_SIZE;
+
+                fiber->Stack.reset(
+                    new (std::nothrow) unsigned char[
+                        fiber->StackSize
+                    ]
+                );
+
+                if (fiber->Stack == nullptr) {
+                    return false;
+                }
+
+                fiber->Scheduler = this;
+
+                fiber->Body =
+                    std::move(body);
+
+                PrepareFiberContext(
+                    fiber->Context,
+                    fiber->Stack.get(),
+                    fiber->StackSize,
+                    _fiberEntry,
+                    fiber.get()
+                );
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_spawnMutex);
+
+                    _spawned.push_back(
+                        std::move(fiber)
+                    );
+                }
+
+                _fiberCount.fetch_add(
+                    1,
+                    std::memory_order_relaxed
+                );
+
+                Wake();
+
+                return true;
+            }
+
+
+            /// Resumes every ready fiber once, on the calling task. Returns
+            /// the number of fibers resumed. Must not be called from a fiber.
+            std::size_t RunOnce() {
+                _hostTask.store(
+                    xTaskGetCurrentTaskHandle(),
+                    std::memory_order_release
+                );
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_spawnMutex);
+
+                    for (
+                        std::unique_ptr<Fiber>& fiber :
+                        _spawned
+                    ) {
+                        _fibers.push_back(
+                            std::move(fiber)
+                        );
+                    }
+
+                    _spawned.clear();
+                }
+
+                const bool woken =
+                    _wakeRequested.exchange(
+                        false,
+                        std::memory_order_acq_rel
+                    );
+
+                const uint64_t now =
+                    _now();
+
+                std::size_t resumed = 0;
+
+                for (
+                    std::size_t index = 0;
+                    index < _fibers.size();
+                    ++index
+                ) {
+                    Fiber* fiber =
+                        _fibers[index].get();
+
+                    switch (fiber->State) {
+                        case FiberState::Sleeping:
+                            if (fiber->WakeTick > now) {
+                                continue;
+                            }
+                            break;
+
+                        case FiberState::Waiting:
+                            // Conditions are re-checked on the fiber.
+                            if (!woken) {
+                                continue;
+                            }
+                            break;
+
+                        case FiberState::Finished:
+                            continue;
+
+                        case FiberState::Ready:
+                            break;
+                    }
+
+                    fiber->State = FiberState::Ready;
+                    _current = fiber;
+
+                    SwitchFiberContext(
+                        _hostContext,
+                        fiber->Context
+                    );
+
+                    _current = nullptr;
+                    ++resumed;
+                }
+
+                std::size_t remaining = 0;
+
+                for (
+                    std::unique_ptr<Fiber>& fiber :
+                    _fibers
+                ) {
+                    if (fiber->State != FiberState::Finished) {
+                        _fibers[remaining++] =
+                            std::move(fiber);
+                    }
+                }
+
+                _fiberCount.fetch_sub(
+                    _fibers.size() - remaining,
+                    std::memory_order_relaxed
+                );
+
+                _fibers.resize(
+                    remaining
+                );
+
+                return resumed;
+            }
+
+
+            /// Ticks the host may block before a fiber is due, capped at
+            /// `maximumTicks`. 0 when a fiber is ready now.
+            TickType_t GetIdleTicks(
+                TickType_t maximumTicks
+            ) {
+                if (
+                    _wakeRequested.load(
+                        std::memory_order_acquire
+                    )
+                ) {
+                    return 0;
+                }
+
+                const uint64_t now =
+                    _now();
+
+                uint64_t idle = maximumTicks;
+
+                for (
+                    const std::unique_ptr<Fiber>& fiber :
+                    _fibers
+                ) {
+                    if (fiber->State == FiberState::Ready) {
+                        return 0;
+                    }
+
+                    if (fiber->State == FiberState::Sleeping) {
+                        const uint64_t untilWake =
+                            fiber->WakeTick > now
+                                ? fiber->WakeTick - now
+                                : 0;
+
+                        if (untilWake < idle) {
+                            idle = untilWake;
+                        }
+                    }
+                }
+
+                return
+                    static_cast<TickType_t>(
+                        idle
+                    );
+            }
+
+
+            /// Re-checks every waiting fiber's condition on the next
+            /// RunOnce() and wakes the host task. Safe from any task.
+            void Wake() {
+                _wakeRequested.store(
+                    true,
+                    std::memory_order_release
+                );
+
+                const TaskHandle_t host =
+                    _hostTask.load(
+                        std::memory_order_acquire
+                    );
+
+                if (host != nullptr) {
+                    xTaskNotifyGive(
+                        host
+                    );
+                }
+            }
+
+
+            /// Number of fibers spawned and not yet finished.
+            std::size_t GetFiberCount() const {
+                return
+                    _fiberCount.load(
+                        std::memory_order_relaxed
+                    );
+            }
+
+
+            void SetOnFiberFailed(
+                TOnFiberFailed value
+            ) {
+                std::lock_guard<
+                    std::mutex
+                > lock(_callbackMutex);
+
+                _onFiberFailed =
+                    std::move(value);
+            }
+
+
+            // Called from a fiber body only.
+
+            /// Lets every other ready fiber run first.
+            void Yield() {
+                _suspend(
+                    FiberState::Ready
+                );
+            }
+
+
+            /// Suspends the calling fiber for at least `milliseconds`.
+            void Sleep(
+                uint32_t milliseconds
+            ) {
+                const TickType_t ticks =
+                    pdMS_TO_TICKS(milliseconds);
+
+                _current->WakeTick =
+                    _now() + ticks;
+
+                _suspend(
+                    FiberState::Sleeping
+                );
+            }
+
+
+            /// Suspends the calling fiber until `condition` holds. The
+            /// condition runs on the fiber, after each Wake() and at least
+            /// every ESPRESSIO_THREAD_FIBER_MAX_WAIT_MILLISECONDS when hosted
+            /// by a FiberThread.
+            void WaitUntil(
+                std::function<bool()> condition
+            ) {
+                while (!condition()) {
+                    _suspend(
+                        FiberState::Waiting
+                    );
+                }
+            }
+    };
+
+
+    /*
+     * A Thread that hosts a FiberScheduler: each OnLoop() resumes the ready
+     * fibers, then blocks until the next one is due or Wake() is called.
+     */
+    class FiberThread :
+        public Thread {
+
+        private:
+            FiberScheduler _scheduler;
+            TickType_t _lastWaitingPass = 0;
+
+
+        protected:
+            void OnLoop() override {
+                _scheduler.RunOnce();
+
+                const TickType_t maximumTicks =
+                    pdMS_TO_TICKS(
+                        ESPRESSIO_THREAD_FIBER_MAX_WAIT_MILLISECONDS
+                    );
+
+                const TickType_t idleTicks =
+                    _scheduler.GetIdleTicks(
+                        maximumTicks > 0
+                            ? maximumTicks
+                            : 1
+                    );
+
+                if (idleTicks > 0) {
+                    ulTaskNotifyTake(
+                        pdTRUE,
+                        idleTicks
+                    );
+                }
+
+                // Let waiting fibers poll their conditions periodically,
+                // for state that changes without a Wake().
+                const TickType_t now =
+                    xTaskGetTickCount();
+
+                if (
+                    static_cast<TickType_t>(
+                        now - _lastWaitingPass
+                    ) >= maximumTicks
+                ) {
+                    _lastWaitingPass = now;
+                    _scheduler.Wake();
+                }
+            }
+
+
+        public:
+            FiberThread() = default;
+
+
+            explicit FiberThread(
+                bool freeOnTerminate
+            ) :
+                Thread(
+                    freeOnTerminate
+                ) {
+            }
+
+
+            ~FiberThread() override {
+                Shutdown();
+            }
+
+
+            FiberScheduler& GetScheduler() {
+                return _scheduler;
+            }
+
+
+            bool Spawn(
+                TFiberBody body,
+                std::size_t stackSize = 0
+            ) {
+                return
+                    _scheduler.Spawn(
+                        std::move(body),
+                        stackSize
+                    );
+            }
+    };
+
+}
+}
+
+#endif
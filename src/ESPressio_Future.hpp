@@ -0,0 +1,1164 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ESPressio_IThreadExecutor.hpp"
+
+// Freed future states kept for reuse, per state size.
+#ifndef ESPRESSIO_THREAD_FUTURE_POOL_CAPACITY
+    #define ESPRESSIO_THREAD_FUTURE_POOL_CAPACITY 16
+#endif
+
+namespace ESPressio {
+namespace Threads {
+
+    /// Thrown by Future::Get() when the Promise was destroyed unfulfilled,
+    /// or when a continuation or Async() work could not be posted.
+    class FutureError :
+        public std::runtime_error {
+
+        public:
+            explicit FutureError(
+                const char* message
+            ) :
+                std::runtime_error(
+                    message
+                ) {
+            }
+    };
+
+
+    /*
+     * Free list of equally sized blocks, one per block size.
+     *
+     * Future states are small and short-lived; reusing their blocks keeps
+     * request/response traffic from fragmenting the heap. Up to
+     * ESPRESSIO_THREAD_FUTURE_POOL_CAPACITY freed blocks are kept.
+     */
+    template <
+        std::size_t TBlockSize
+    >
+    class FutureStatePool {
+        private:
+            std::mutex _mutex;
+            std::vector<void*> _blocks;
+
+
+            FutureStatePool() {
+                _blocks.reserve(
+                    ESPRESSIO_THREAD_FUTURE_POOL_CAPACITY
+                );
+            }
+
+
+        public:
+            static FutureStatePool*
+            GetInstance() {
+                // Process-lifetime by design, like ThreadTaskPool.
+                static FutureStatePool* instance =
+                    new FutureStatePool();
+
+                return instance;
+            }
+
+
+            void* Allocate() {
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    if (!_blocks.empty()) {
+                        void* block =
+                            _blocks.back();
+
+                        _blocks.pop_back();
+
+                        return block;
+                    }
+                }
+
+                return
+                    ::operator new(
+                        TBlockSize
+                    );
+            }
+
+
+            void Free(
+                void* block
+            ) {
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    if (
+                        _blocks.size() <
+                            ESPRESSIO_THREAD_FUTURE_POOL_CAPACITY
+                    ) {
+                        _blocks.push_back(
+                            block
+                        );
+
+                        return;
+                    }
+                }
+
+                ::operator delete(
+                    block
+                );
+            }
+    };
+
+
+    /// Allocator that draws single objects from FutureStatePool, used with
+    /// std::allocate_shared() so a state and its control block share one
+    /// pooled block.
+    template <
+        typename T
+    >
+    struct FutureStateAllocator {
+        using value_type = T;
+
+        FutureStateAllocator() = default;
+
+        template <
+            typename U
+        >
+        FutureStateAllocator(
+            const FutureStateAllocator<U>&
+        ) {
+        }
+
+
+        T* allocate(
+            std::size_t count
+        ) {
+            static_assert(
+                alignof(T) <= alignof(std::max_align_t),
+                "Over-aligned future states are not supported"
+            );
+
+            if (count != 1) {
+                return
+                    static_cast<T*>(
+                        ::operator new(
+                            count * sizeof(T)
+                        )
+                    );
+            }
+
+            return
+                static_cast<T*>(
+                    FutureStatePool<
+                        sizeof(T)
+                    >::GetInstance()->
+                        Allocate()
+                );
+        }
+
+
+        void deallocate(
+            T* pointer,
+            std::size_t count
+        ) {
+            if (count != 1) {
+                ::operator delete(
+                    pointer
+                );
+
+                return;
+            }
+
+            FutureStatePool<
+                sizeof(T)
+            >::GetInstance()->
+                Free(
+                    pointer
+                );
+        }
+
+
+        template <
+            typename U
+        >
+        bool operator==(
+            const FutureStateAllocator<U>&
+        ) const {
+            return true;
+        }
+
+
+        template <
+            typename U
+        >
+        bool operator!=(
+            const FutureStateAllocator<U>&
+        ) const {
+            return false;
+        }
+    };
+
+
+    /// Internal: std::make_shared() drawing from FutureStatePool, for the
+    /// promises and bookkeeping that continuations and combinators share.
+    template <
+        typename T,
+        typename... TArguments
+    >
+    std::shared_ptr<T> MakePooledShared(
+        TArguments&&... arguments
+    ) {
+        return
+            std::allocate_shared<
+                T
+            >(
+                FutureStateAllocator<T>(),
+                std::forward<TArguments>(
+                    arguments
+                )...
+            );
+    }
+
+
+    /*
+     * Completion, waiting and callbacks shared by every FutureState<T>.
+     *
+     * Waiters block on a binary semaphore created by the first blocking
+     * Wait(), replacing the hand-rolled semaphore or task-notification
+     * handshake. Each waiter gives the semaphore back after taking it, so
+     * every waiter is released once the state completes.
+     */
+    class FutureStateBase {
+        private:
+            std::mutex _mutex;
+
+            std::atomic<bool>
+                _ready{
+                    false
+                };
+
+            SemaphoreHandle_t _readySemaphore = nullptr;
+
+            std::vector<
+                std::function<void()>
+            > _callbacks;
+
+
+        protected:
+            std::exception_ptr _exception;
+
+
+            /// Runs `store` under the lock unless already complete, then
+            /// releases waiters and runs callbacks on the calling task.
+            template <
+                typename TStore
+            >
+            bool _complete(
+                TStore store
+            ) {
+                SemaphoreHandle_t readySemaphore;
+
+                std::vector<
+                    std::function<void()>
+                > callbacks;
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    if (
+                        _ready.load(
+                            std::memory_order_relaxed
+                        )
+                    ) {
+                        return false;
+                    }
+
+                    store();
+
+                    _ready.store(
+                        true,
+                        std::memory_order_release
+                    );
+
+                    readySemaphore = _readySemaphore;
+
+                    callbacks.swap(
+                        _callbacks
+                    );
+                }
+
+                if (readySemaphore != nullptr) {
+                    xSemaphoreGive(
+                        readySemaphore
+                    );
+                }
+
+                for (
+                    std::function<void()>& callback :
+                    callbacks
+                ) {
+                    try {
+                        callback();
+                    } catch (...) {
+                    }
+                }
+
+                return true;
+            }
+
+
+        public:
+            FutureStateBase() = default;
+
+            FutureStateBase(
+                const FutureStateBase&
+            ) = delete;
+
+            FutureStateBase& operator=(
+                const FutureStateBase&
+            ) = delete;
+
+
+            ~FutureStateBase() {
+                if (_readySemaphore != nullptr) {
+                    vSemaphoreDelete(
+                        _readySemaphore
+                    );
+                }
+            }
+
+
+            bool IsReady() const {
+                return
+                    _ready.load(
+                        std::memory_order_acquire
+                    );
+            }
+
+
+            bool SetException(
+                std::exception_ptr exception
+            ) {
+                return
+                    _complete(
+                        [&]() {
+                            _exception = exception;
+                        }
+                    );
+            }
+
+
+            /// Runs `callback` once complete: on the completing task, or
+            /// now on the calling task if already complete.
+            void AddCallback(
+                std::function<void()> callback
+            ) {
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    if (
+                        !_ready.load(
+                            std::memory_order_relaxed
+                        )
+                    ) {
+                        _callbacks.push_back(
+                            std::move(callback)
+                        );
+
+                        return;
+                    }
+                }
+
+                callback();
+            }
+
+
+            /// Waits up to `ticks` for completion. Returns `true` once
+            /// complete.
+            bool Wait(
+                TickType_t ticks
+            ) {
+                if (IsReady()) {
+                    return true;
+                }
+
+                SemaphoreHandle_t readySemaphore;
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    if (
+                        _ready.load(
+                            std::memory_order_relaxed
+                        )
+                    ) {
+                        return true;
+                    }
+
+                    if (_readySemaphore == nullptr) {
+                        _readySemaphore =
+                            xSemaphoreCreateBinary();
+                    }
+
+                    readySemaphore = _readySemaphore;
+                }
+
+                if (readySemaphore == nullptr) {
+                    // Out of memory for the semaphore: poll instead.
+                    const TickType_t start =
+                        xTaskGetTickCount();
+
+                    while (
+                        !IsReady() &&
+                        static_cast<TickType_t>(
+                            xTaskGetTickCount() - start
+                        ) < ticks
+                    ) {
+                        vTaskDelay(1);
+                    }
+
+                    return IsReady();
+                }
+
+                if (
+                    xSemaphoreTake(
+                        readySemaphore,
+                        ticks
+                    ) == pdTRUE
+                ) {
+                    // Pass completion on to the next waiter.
+                    xSemaphoreGive(
+                        readySemaphore
+                    );
+                }
+
+                return IsReady();
+            }
+    };
+
+
+    template <
+        typename T
+    >
+    class FutureState :
+        public FutureStateBase {
+
+        private:
+            typename std::aligned_storage<
+                sizeof(T),
+                alignof(T)
+            >::type _storage;
+
+            bool _hasValue = false;
+
+
+        public:
+            ~FutureState() {
+                if (_hasValue) {
+                    reinterpret_cast<T*>(
+                        &_storage
+                    )->~T();
+                }
+            }
+
+
+            template <
+                typename... TArguments
+            >
+            bool SetValue(
+                TArguments&&... arguments
+            ) {
+                return
+                    _complete(
+                        [&]() {
+                            new (&_storage) T(
+                                std::forward<TArguments>(
+                                    arguments
+                                )...
+                            );
+
+                            _hasValue = true;
+                        }
+                    );
+            }
+
+
+            /// The value, or rethrows the exception. Only once complete.
+            const T& GetValue() const {
+                if (_exception) {
+                    std::rethrow_exception(
+                        _exception
+                    );
+                }
+
+                return
+                    *reinterpret_cast<const T*>(
+                        &_storage
+                    );
+            }
+    };
+
+
+    template <>
+    class FutureState<void> :
+        public FutureStateBase {
+
+        public:
+            bool SetValue() {
+                return
+                    _complete(
+                        []() {
+                        }
+                    );
+            }
+
+
+            void GetValue() const {
+                if (_exception) {
+                    std::rethrow_exception(
+                        _exception
+                    );
+                }
+            }
+    };
+
+
+    template <
+        typename T
+    >
+    class Future;
+
+    template <
+        typename T
+    >
+    class Promise;
+
+
+    /// Result of calling `TFunction` with `TArguments`, decayed.
+    template <
+        typename TFunction,
+        typename... TArguments
+    >
+    using FutureResultOf =
+        typename std::decay<
+            decltype(
+                std::declval<TFunction&>()(
+                    std::declval<TArguments>()...
+                )
+            )
+        >::type;
+
+
+    /// Fulfils a Promise with the result of a call, or its exception.
+    template <
+        typename T
+    >
+    struct FutureInvoke;
+
+
+    /*
+     * The result of work that completes later, possibly on another task.
+     *
+     * Futures are copyable; every copy refers to the same result. Get()
+     * blocks the calling task until the result is set, then returns it or
+     * rethrows the exception it completed with. Then() attaches a
+     * continuation instead of blocking.
+     */
+    template <
+        typename T
+    >
+    class Future {
+        private:
+            std::shared_ptr<
+                FutureState<T>
+            > _state;
+
+
+            template <
+                typename TFunction
+            >
+            using TThenResult =
+                FutureResultOf<
+                    TFunction,
+                    Future<T>
+                >;
+
+
+        public:
+            Future() = default;
+
+
+            explicit Future(
+                std::shared_ptr<
+                    FutureState<T>
+                > state
+            ) :
+                _state(
+                    std::move(state)
+                ) {
+            }
+
+
+            /// `false` for a default-constructed Future.
+            bool IsValid() const {
+                return _state != nullptr;
+            }
+
+
+            bool IsReady() const {
+                return
+                    _state != nullptr &&
+                    _state->IsReady();
+            }
+
+
+            /// Waits up to `milliseconds` for the result. Returns `true`
+            /// once it is set.
+            bool Wait(
+                uint32_t milliseconds
+            ) const {
+                return
+                    _state != nullptr &&
+                    _state->Wait(
+                        pdMS_TO_TICKS(milliseconds)
+                    );
+            }
+
+
+            void Wait() const {
+                if (_state != nullptr) {
+                    _state->Wait(
+                        portMAX_DELAY
+                    );
+                }
+            }
+
+
+            /// Blocks until complete, then returns the value or rethrows
+            /// the exception. Throws FutureError on an invalid Future.
+            auto Get() const ->
+                decltype(
+                    std::declval<
+                        const FutureState<T>&
+                    >().GetValue()
+                ) {
+                if (_state == nullptr) {
+                    throw FutureError(
+                        "Future has no state"
+                    );
+                }
+
+                Wait();
+
+                return _state->GetValue();
+            }
+
+
+            /// Calls `continuation(Future<T>)` with this (now complete)
+            /// Future on the task that completes it, or immediately if it
+            /// is already complete. Returns a Future of its result.
+            template <
+                typename TFunction
+            >
+            auto Then(
+                TFunction continuation
+            ) const ->
+                Future<
+                    TThenResult<TFunction>
+                > {
+                using TResult =
+                    TThenResult<TFunction>;
+
+                std::shared_ptr<
+                    Promise<TResult>
+                > promise =
+                    MakePooledShared<
+                        Promise<TResult>
+                    >();
+
+                Future<TResult> result =
+                    promise->GetFuture();
+
+                if (_state == nullptr) {
+                    promise->SetException(
+                        std::make_exception_ptr(
+                            FutureError(
+                                "Future has no state"
+                            )
+                        )
+                    );
+
+                    return result;
+                }
+
+                const Future<T> self = *this;
+
+                _state->AddCallback(
+                    [promise, self, continuation]() mutable {
+                        FutureInvoke<TResult>::Run(
+                            *promise,
+                            continuation,
+                            self
+                        );
+                    }
+                );
+
+                return result;
+            }
+
+
+            /// As Then(continuation), but the continuation is posted to
+            /// `executor` and runs on its task. If posting fails the
+            /// returned Future completes with FutureError. `executor` is
+            /// held by reference until this Future completes, so it must
+            /// outlive that.
+            template <
+                typename TFunction
+            >
+            auto Then(
+                IThreadExecutor& executor,
+                TFunction continuation
+            ) const ->
+                Future<
+                    TThenResult<TFunction>
+                > {
+                using TResult =
+                    TThenResult<TFunction>;
+
+                std::shared_ptr<
+                    Promise<TResult>
+                > promise =
+                    MakePooledShared<
+                        Promise<TResult>
+                    >();
+
+                Future<TResult> result =
+                    promise->GetFuture();
+
+                if (_state == nullptr) {
+                    promise->SetException(
+                        std::make_exception_ptr(
+                            FutureError(
+                                "Future has no state"
+                            )
+                        )
+                    );
+
+                    return result;
+                }
+
+                const Future<T> self = *this;
+                IThreadExecutor* target = &executor;
+
+                _state->AddCallback(
+                    [promise, self, target, continuation]() {
+                        const bool posted =
+                            target->Post(
+                                [promise, self, continuation]() mutable {
+                                    FutureInvoke<TResult>::Run(
+                                        *promise,
+                                        continuation,
+                                        self
+                                    );
+                                }
+                            );
+
+                        if (!posted) {
+                            promise->SetException(
+                                std::make_exception_ptr(
+                                    FutureError(
+                                        "Continuation could not be posted"
+                                    )
+                                )
+                            );
+                        }
+                    }
+                );
+
+                return result;
+            }
+
+
+            /// Internal: the shared state, for WhenAll() and WhenAny().
+            const std::shared_ptr<
+                FutureState<T>
+            >& GetState() const {
+                return _state;
+            }
+    };
+
+
+    /*
+     * The producing side of a Future.
+     *
+     * Set the result once with SetValue() or SetException(); later calls
+     * return `false`. A Promise destroyed without a result completes its
+     * Future with FutureError, so no waiter blocks forever. Every
+     * GetFuture() refers to the same result.
+     */
+    template <
+        typename T
+    >
+    class Promise {
+        private:
+            std::shared_ptr<
+                FutureState<T>
+            > _state;
+
+
+        public:
+            Promise() :
+                _state(
+                    std::allocate_shared<
+                        FutureState<T>
+                    >(
+                        FutureStateAllocator<
+                            FutureState<T>
+                        >()
+                    )
+                ) {
+            }
+
+
+            Promise(
+                const Promise&
+            ) = delete;
+
+            Promise& operator=(
+                const Promise&
+            ) = delete;
+
+            Promise(
+                Promise&&
+            ) = default;
+
+
+            Promise& operator=(
+                Promise&& other
+            ) {
+                if (this != &other) {
+                    _abandon();
+
+                    _state =
+                        std::move(other._state);
+                }
+
+                return *this;
+            }
+
+
+            ~Promise() {
+                _abandon();
+            }
+
+
+            Future<T> GetFuture() const {
+                return Future<T>(
+                    _state
+                );
+            }
+
+
+            template <
+                typename... TArguments
+            >
+            bool SetValue(
+                TArguments&&... arguments
+            ) {
+                return
+                    _state != nullptr &&
+                    _state->SetValue(
+                        std::forward<TArguments>(
+                            arguments
+                        )...
+                    );
+            }
+
+
+            bool SetException(
+                std::exception_ptr exception
+            ) {
+                return
+                    _state != nullptr &&
+                    _state->SetException(
+                        exception
+                    );
+            }
+
+
+        private:
+            void _abandon() {
+                if (
+                    _state != nullptr &&
+                    !_state->IsReady()
+                ) {
+                    _state->SetException(
+                        std::make_exception_ptr(
+                            FutureError(
+                                "Promise destroyed without a result"
+                            )
+                        )
+                    );
+                }
+            }
+    };
+
+
+    template <
+        typename T
+    >
+    struct FutureInvoke {
+        template <
+            typename TFunction,
+            typename... TArguments
+        >
+        static void Run(
+            Promise<T>& promise,
+            TFunction& function,
+            TArguments&&... arguments
+        ) {
+            try {
+                promise.SetValue(
+                    function(
+                        std::forward<TArguments>(
+                            arguments
+                        )...
+                    )
+                );
+            } catch (...) {
+                promise.SetException(
+                    std::current_exception()
+                );
+            }
+        }
+    };
+
+
+    template <>
+    struct FutureInvoke<void> {
+        template <
+            typename TFunction,
+            typename... TArguments
+        >
+        static void Run(
+            Promise<void>& promise,
+            TFunction& function,
+            TArguments&&... arguments
+        ) {
+            try {
+                function(
+                    std::forward<TArguments>(
+                        arguments
+                    )...
+                );
+
+                promise.SetValue();
+            } catch (...) {
+                promise.SetException(
+                    std::current_exception()
+                );
+            }
+        }
+    };
+
+
+    /// Runs `work()` on `executor` and returns a Future of its result. If
+    /// posting fails the Future completes with FutureError.
+    template <
+        typename TFunction
+    >
+    auto Async(
+        IThreadExecutor& executor,
+        TFunction work
+    ) ->
+        Future<
+            FutureResultOf<TFunction>
+        > {
+        using TResult =
+            FutureResultOf<TFunction>;
+
+        std::shared_ptr<
+            Promise<TResult>
+        > promise =
+            MakePooledShared<
+                Promise<TResult>
+            >();
+
+        Future<TResult> result =
+            promise->GetFuture();
+
+        const bool posted =
+            executor.Post(
+                [promise, work]() mutable {
+                    FutureInvoke<TResult>::Run(
+                        *promise,
+                        work
+                    );
+                }
+            );
+
+        if (!posted) {
+            promise->SetException(
+                std::make_exception_ptr(
+                    FutureError(
+                        "Work could not be posted"
+                    )
+                )
+            );
+        }
+
+        return result;
+    }
+
+
+    /// Completes with `futures`, every one complete, once the last of them
+    /// completes. Failed futures do not fail the result; call Get() on each.
+    template <
+        typename T
+    >
+    Future<
+        std::vector<Future<T>>
+    > WhenAll(
+        std::vector<Future<T>> futures
+    ) {
+        std::shared_ptr<
+            Promise<std::vector<Future<T>>>
+        > promise =
+            MakePooledShared<
+                Promise<std::vector<Future<T>>>
+            >();
+
+        Future<std::vector<Future<T>>> result =
+            promise->GetFuture();
+
+        // One count per future plus one held until every callback is
+        // attached, so an already-complete future cannot finish early.
+        std::shared_ptr<
+            std::atomic<std::size_t>
+        > remaining =
+            MakePooledShared<
+                std::atomic<std::size_t>
+            >(
+                futures.size() + 1
+            );
+
+        std::shared_ptr<
+            std::vector<Future<T>>
+        > all =
+            MakePooledShared<
+                std::vector<Future<T>>
+            >(
+                std::move(futures)
+            );
+
+        auto arrive =
+            [promise, remaining, all]() {
+                if (
+                    remaining->fetch_sub(
+                        1,
+                        std::memory_order_acq_rel
+                    ) == 1
+                ) {
+                    promise->SetValue(
+                        *all
+                    );
+                }
+            };
+
+        for (
+            const Future<T>& future :
+            *all
+        ) {
+            if (future.GetState() == nullptr) {
+                arrive();
+                continue;
+            }
+
+            future.GetState()->AddCallback(
+                arrive
+            );
+        }
+
+        arrive();
+
+        return result;
+    }
+
+
+    /// Completes with the index of the first of `futures` to complete.
+    /// Fails with FutureError when `futures` is empty.
+    template <
+        typename T
+    >
+    Future<std::size_t> WhenAny(
+        const std::vector<Future<T>>& futures
+    ) {
+        std::shared_ptr<
+            Promise<std::size_t>
+        > promise =
+            MakePooledShared<
+                Promise<std::size_t>
+            >();
+
+        Future<std::size_t> result =
+            promise->GetFuture();
+
+        if (futures.empty()) {
+            promise->SetException(
+                std::make_exception_ptr(
+                    FutureError(
+                        "WhenAny() of no futures"
+                    )
+                )
+            );
+
+            return result;
+        }
+
+        for (
+            std::size_t index = 0;
+            index < futures.size() && !result.IsReady();
+            ++index
+        ) {
+            if (futures[index].GetState() == nullptr) {
+                continue;
+            }
+
+            // Only the first completion sets the value.
+            futures[index].GetState()->AddCallback(
+                [promise, index]() {
+                    promise->SetValue(
+                        index
+                    );
+                }
+            );
+        }
+
+        return result;
+    }
+
+}
+}
@@ -54,6 +54,17 @@ namespace ESPressio {
                     SkippedIterationCount
                 ) {
                 }
+
+
+                /// The period governor changed the period in use from the
+                /// first time to the second.
+                virtual void
+                OnPrecisionThreadPeriodAdapted(
+                    ThreadType*,
+                    TTime,
+                    TTime
+                ) {
+                }
         };
 
     }
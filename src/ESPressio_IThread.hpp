@@ -1,5 +1,6 @@
 #pragma once
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <functional>
@@ -33,6 +34,39 @@ namespace ESPressio {
             TerminatedDuringInitialization,
             InitializationException
         };
+        constexpr std::size_t ThreadStateCount =
+            static_cast<std::size_t>(ThreadState::Destroyed) + 1;
+        /// Cumulative runtime accounting of a Thread. Counters that the
+        /// platform cannot provide stay zero and are flagged unavailable.
+        struct ThreadRuntimeStatistics {
+            bool CpuTimeAvailable = false;
+            bool ContextSwitchesAvailable = false;
+
+            /// Passes through the loop body (`OnLoop()` calls).
+            uint64_t LoopIterations = 0;
+            /// CPU time consumed inside the loop body.
+            uint64_t LoopCpuNanoseconds = 0;
+
+            uint64_t VoluntaryContextSwitches = 0;
+            uint64_t InvoluntaryContextSwitches = 0;
+
+            /// Wall time spent in each `ThreadState`, indexed by state.
+            uint64_t StateNanoseconds[ThreadStateCount] = {};
+        };
+        /// Stack usage of a Thread's task, in the units `SetStackSize()` takes.
+        struct ThreadStackStatistics {
+            /// `false` until the Thread's task has run and been sampled.
+            bool Sampled = false;
+
+            uint32_t StackSize = 0;
+            /// Lowest free stack ever observed (the high-water mark).
+            uint32_t MinimumFree = 0;
+            uint32_t PeakUsed = 0;
+            /// Peak usage plus a safety margin; see ESPRESSIO_THREAD_STACK_MARGIN.
+            uint32_t SuggestedStackSize = 0;
+            /// `true` once the Thread has run on a recycled task, whose high-water mark also covers its earlier Threads. `PeakUsed` and `SuggestedStackSize` are then upper bounds.
+            bool Recycled = false;
+        };
         class ThreadException : public std::runtime_error {
             public:
                 explicit ThreadException(const char* message)
@@ -181,6 +215,20 @@ namespace ESPressio {
 
                 /// `GetStartOnInitialize` returns whether this Thread should start running when it is initialized.
                 virtual bool GetStartOnInitialize() = 0;
+
+                /// `GetRuntimeStatistics` fills `statistics` and returns `true` when the Thread keeps runtime accounting.
+                /// The default preserves compatibility for custom IThread implementations.
+                virtual bool GetRuntimeStatistics(ThreadRuntimeStatistics& statistics) { (void)statistics; return false; }
+
+                /// `IsCoreIDPinned` returns `true` once `SetCoreID` chose the Core, so placement policies leave the Thread there.
+                virtual bool IsCoreIDPinned() { return false; }
+
+                /// `MigrateToCore` asks a running Thread to move to another Core between loop iterations. Returns `false` if the Thread cannot migrate or `coreID` is not below the core count.
+                virtual bool MigrateToCore(int coreID) { (void)coreID; return false; }
+
+                /// `GetStackStatistics` fills `statistics` and returns `true` when the Thread tracks its stack usage.
+                /// The default preserves compatibility for custom IThread implementations.
+                virtual bool GetStackStatistics(ThreadStackStatistics& statistics) { (void)statistics; return false; }
             // Utility Getters
 
                 bool IsRunning() { return GetThreadState() == ThreadState::Running; }
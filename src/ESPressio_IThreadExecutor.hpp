@@ -0,0 +1,27 @@
+#pragma once
+
+#include <functional>
+
+namespace ESPressio {
+namespace Threads {
+
+    /*
+     * Runs posted work on a task it owns.
+     *
+     * Future continuations and Async() use an executor to choose which
+     * Thread their work runs on.
+     */
+    class IThreadExecutor {
+        public:
+            virtual ~IThreadExecutor() = default;
+
+            /// Queues `work` to run later on the executor's task. Safe from
+            /// any task, but not from an ISR. Returns `false`, without
+            /// running `work`, when it cannot be queued.
+            virtual bool Post(
+                std::function<void()> work
+            ) = 0;
+    };
+
+}
+}
@@ -5,11 +5,35 @@
 #include <ESPressio_IObserver.hpp>
 
 #include "ESPressio_IThread.hpp"
+#include "ESPressio_ObserverInterests.hpp"
 #include "ESPressio_ThreadManagerTypes.hpp"
 
 namespace ESPressio {
 namespace Threads {
 
+    using ThreadManagerObserverEvents =
+        ObserverEventMask;
+
+    /// IThreadManagerObserver callbacks, for ThreadManager::RegisterObserver()
+    /// masks.
+    namespace ThreadManagerObserverEvent {
+        enum : ThreadManagerObserverEvents {
+            Registered = 1u << 0,
+            RegistrationFailed = 1u << 1,
+            Removed = 1u << 2,
+            CleanupClaimed = 1u << 3,
+            CleanupDeferred = 1u << 4,
+            CleanupStarted = 1u << 5,
+            CleanupCompleted = 1u << 6,
+            CleanupFailed = 1u << 7,
+            InitializationCompleted = 1u << 8,
+            MigrationRequested = 1u << 9,
+            RuntimeSampled = 1u << 10,
+            All = ObserverEventsAll
+        };
+    }
+
+
     class IThreadManagerObserver :
         public virtual Observable::IObserver {
 
@@ -55,6 +79,21 @@ namespace Threads {
         virtual void OnThreadManagerInitializationCompleted(
             const ThreadManagerInitializationResult&
         ) {}
+
+        /// `snapshot.CoreID` is the core the Thread is leaving. It moves
+        /// once its current loop iteration returns, unless the new task
+        /// cannot be created or the Thread terminates first; it then stays
+        /// where it is. `GetCoreID()` reports the core it actually runs on.
+        virtual void OnThreadMigrationRequested(
+            IThread*,
+            const ThreadManagerThreadSnapshot&,
+            int
+        ) {}
+
+        virtual void OnThreadRuntimeSampled(
+            IThread*,
+            const ThreadRuntimeSnapshot&
+        ) {}
     };
 
 }
@@ -5,10 +5,33 @@
 #include <ESPressio_IObserver.hpp>
 
 #include "ESPressio_IThread.hpp"
+#include "ESPressio_ObserverInterests.hpp"
 
 namespace ESPressio {
 namespace Threads {
 
+    using ThreadObserverEvents =
+        ObserverEventMask;
+
+    /// IThreadObserver callbacks, for RegisterThreadObserver() masks.
+    namespace ThreadObserverEvent {
+        enum : ThreadObserverEvents {
+            StateChanged = 1u << 0,
+            Uninitialized = 1u << 1,
+            Initialized = 1u << 2,
+            Started = 1u << 3,
+            Paused = 1u << 4,
+            TerminationRequested = 1u << 5,
+            Terminated = 1u << 6,
+            Destroyed = 1u << 7,
+            TaskExited = 1u << 8,
+            InitializationFailed = 1u << 9,
+            ExecutionFailed = 1u << 10,
+            All = ObserverEventsAll
+        };
+    }
+
+
     class IThreadObserver :
         public virtual Observable::IObserver {
 
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+#include "ESPressio_IThread.hpp"
+#include "ESPressio_ThreadManagerTypes.hpp"
+
+namespace ESPressio {
+namespace Threads {
+
+    /*
+     * Chooses the core a Thread runs on.
+     *
+     * The ThreadManager consults its policy when a Thread initializes, not
+     * when it is constructed, so the policy sees the Threads that are
+     * already active. Threads pinned with SetCoreID() are never placed.
+     * Calls are serialized by the ThreadManager.
+     */
+    class IThreadPlacementPolicy {
+        public:
+            virtual ~IThreadPlacementPolicy() = default;
+
+            /// Returns the core for `thread`. `activeThreads` lists every
+            /// other Thread that is Initialized, Running, Paused or
+            /// Terminating, with the core it is on. A result outside
+            /// `[0, coreCount)` leaves the Thread where it is.
+            virtual int PlaceThread(
+                IThread* thread,
+                const ThreadPlacementLoad& placing,
+                const std::vector<
+                    ThreadPlacementLoad
+                >& activeThreads,
+                int coreCount
+            ) = 0;
+    };
+
+}
+}
@@ -21,6 +21,8 @@ namespace Threads {
             const ThreadManagerThreadSnapshot&
         ) {}
 
+        /// A termination could not be queued because the dispatcher task
+        /// could not be created, so it will not be dispatched.
         virtual void OnThreadTerminationDispatchQueueFailed(
             const ThreadManagerThreadSnapshot&
         ) {}
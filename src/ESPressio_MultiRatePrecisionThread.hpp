@@ -0,0 +1,309 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ESPressio_PrecisionThread.hpp"
+
+namespace ESPressio {
+
+    namespace Threads {
+
+        /*
+         * A PrecisionThread that runs several harmonic sub-tasks on one task
+         * and one stack.
+         *
+         * The iteration period is the base tick. Each sub-task runs every
+         * `divisor` ticks, on the ticks where tick % divisor == phase, so
+         * 1 kHz, 100 Hz and 10 Hz work is a 1 ms period with divisors 1, 10
+         * and 100. Within a tick, due sub-tasks run in the order they were
+         * added, which makes their relative timing deterministic. Phases let
+         * slow sub-tasks share out the ticks instead of all landing on tick
+         * zero.
+         *
+         * Every sub-task gets its own delta, start to start between its own
+         * runs, and its own skip count: the number of its slots that passed
+         * without it running. A sub-task whose slot fell in a skipped base
+         * tick runs on the next tick that does run. Tick zero is the first
+         * iteration after initialization or resume, and each sub-task's
+         * first delta after it is zero.
+         *
+         * Add sub-tasks before starting the thread. AddTask() and
+         * ClearTasks() may also be called while it runs, from any task but
+         * not from within a sub-task.
+         */
+        template<
+            typename TTime = Timing::DefaultClockTime,
+            typename TRepresentationTraits =
+                PrecisionThreadTraits<TTime>
+        >
+        class MultiRatePrecisionThread :
+            public PrecisionThread<
+                TTime,
+                TRepresentationTraits
+            > {
+            public:
+                using BaseType =
+                    PrecisionThread<
+                        TTime,
+                        TRepresentationTraits
+                    >;
+
+                using IterationTime =
+                    typename BaseType::IterationTime;
+
+                using ClockType =
+                    typename BaseType::ClockType;
+
+                using TaskCallback =
+                    std::function<
+                        void(
+                            IterationTime delta,
+                            IterationTime startTime,
+                            SkippedIterationCount skippedIterations
+                        )
+                    >;
+
+            private:
+                struct SubTask {
+                    uint32_t Divisor;
+                    uint32_t Phase;
+
+                    TaskCallback Callback;
+
+                    bool HasPrevious;
+                    uint64_t PreviousStartNanoseconds;
+                };
+
+                std::mutex _tasksMutex;
+
+                std::vector<SubTask> _tasks;
+
+                // The base tick of the next iteration.
+                uint64_t _nextTick = 0;
+
+
+                static uint64_t _toNanoseconds(
+                    const IterationTime& time
+                ) {
+                    return
+                        Timing::TimeTraits<
+                            IterationTime
+                        >::template ToNanoseconds<
+                            uint64_t
+                        >(time);
+                }
+
+
+                static IterationTime _fromNanoseconds(
+                    uint64_t nanoseconds
+                ) {
+                    return
+                        Timing::TimeTraits<
+                            IterationTime
+                        >::template FromNanoseconds<
+                            uint64_t
+                        >(
+                            nanoseconds,
+                            1
+                        );
+                }
+
+
+                // Slots of `task` among ticks 0 to `tick`.
+                static uint64_t _countSlotsThrough(
+                    const SubTask& task,
+                    uint64_t tick
+                ) {
+                    return
+                        tick >= task.Phase
+                            ? (tick - task.Phase) /
+                                  task.Divisor +
+                              1
+                            : 0;
+                }
+
+
+                void _resetTicks() {
+                    std::lock_guard<std::mutex>
+                        lock(_tasksMutex);
+
+                    _nextTick = 0;
+
+                    for (
+                        SubTask& task :
+                        _tasks
+                    ) {
+                        task.HasPrevious = false;
+                    }
+                }
+
+
+            protected:
+                void Iterate(
+                    IterationTime,
+                    IterationTime startTime,
+                    SkippedIterationCount skippedIterations
+                ) final override {
+                    std::lock_guard<std::mutex>
+                        lock(_tasksMutex);
+
+                    // This iteration stands for ticks first to last; all but
+                    // the last were skipped.
+                    const uint64_t first =
+                        _nextTick;
+
+                    const uint64_t last =
+                        first +
+                        skippedIterations;
+
+                    _nextTick =
+                        last + 1;
+
+                    const uint64_t start =
+                        _toNanoseconds(
+                            startTime
+                        );
+
+                    for (
+                        SubTask& task :
+                        _tasks
+                    ) {
+                        const uint64_t slots =
+                            _countSlotsThrough(
+                                task,
+                                last
+                            ) -
+                            (
+                                first > 0
+                                    ? _countSlotsThrough(
+                                        task,
+                                        first - 1
+                                      )
+                                    : 0
+                            );
+
+                        if (slots == 0) {
+                            continue;
+                        }
+
+                        const uint64_t delta =
+                            task.HasPrevious &&
+                                start >=
+                                    task.PreviousStartNanoseconds
+                                ? start -
+                                  task.PreviousStartNanoseconds
+                                : 0;
+
+                        task.HasPrevious = true;
+                        task.PreviousStartNanoseconds = start;
+
+                        task.Callback(
+                            _fromNanoseconds(
+                                delta
+                            ),
+                            startTime,
+                            slots - 1
+                        );
+                    }
+                }
+
+
+            public:
+                explicit MultiRatePrecisionThread(
+                    ClockType* clock = nullptr
+                ) :
+                    BaseType(
+                        clock
+                    ) {
+                }
+
+
+                MultiRatePrecisionThread(
+                    bool freeOnTerminate,
+                    ClockType* clock = nullptr
+                ) :
+                    BaseType(
+                        freeOnTerminate,
+                        clock
+                    ) {
+                }
+
+
+                ThreadInitializationStatus
+                Initialize() override {
+                    _resetTicks();
+
+                    return
+                        BaseType::Initialize();
+                }
+
+
+                ThreadInitializationStatus
+                Start() override {
+                    if (
+                        this->GetThreadState() ==
+                        ThreadState::Paused
+                    ) {
+                        _resetTicks();
+                    }
+
+                    return
+                        BaseType::Start();
+                }
+
+
+                /// Runs `callback` every `divisor` base ticks, on the ticks
+                /// where tick % divisor == phase. Returns `false` when
+                /// `divisor` is zero, `phase` is not below it, or `callback`
+                /// is empty.
+                bool AddTask(
+                    uint32_t divisor,
+                    TaskCallback callback,
+                    uint32_t phase = 0
+                ) {
+                    if (
+                        divisor == 0 ||
+                        phase >= divisor ||
+                        !callback
+                    ) {
+                        return false;
+                    }
+
+                    std::lock_guard<std::mutex>
+                        lock(_tasksMutex);
+
+                    _tasks.push_back({
+                        divisor,
+                        phase,
+                        std::move(callback),
+                        false,
+                        0
+                    });
+
+                    return true;
+                }
+
+
+                void ClearTasks() {
+                    std::lock_guard<std::mutex>
+                        lock(_tasksMutex);
+
+                    _tasks.clear();
+                }
+
+
+                std::size_t GetTaskCount() {
+                    std::lock_guard<std::mutex>
+                        lock(_tasksMutex);
+
+                    return _tasks.size();
+                }
+        };
+
+    }
+
+}
@@ -0,0 +1,609 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Events the asynchronous observer ring holds; a power of two. Events
+// published while it is full are dropped and counted.
+#ifndef ESPRESSIO_THREAD_OBSERVER_RING_CAPACITY
+    #define ESPRESSIO_THREAD_OBSERVER_RING_CAPACITY 64
+#endif
+
+#ifndef ESPRESSIO_THREAD_OBSERVER_DISPATCHER_STACK_SIZE
+    #define ESPRESSIO_THREAD_OBSERVER_DISPATCHER_STACK_SIZE 4000
+#endif
+
+#ifndef ESPRESSIO_THREAD_OBSERVER_DISPATCHER_PRIORITY
+    #define ESPRESSIO_THREAD_OBSERVER_DISPATCHER_PRIORITY 1
+#endif
+
+static_assert(
+    ESPRESSIO_THREAD_OBSERVER_RING_CAPACITY >= 2 &&
+    (
+        ESPRESSIO_THREAD_OBSERVER_RING_CAPACITY &
+        (ESPRESSIO_THREAD_OBSERVER_RING_CAPACITY - 1)
+    ) == 0,
+    "ESPRESSIO_THREAD_OBSERVER_RING_CAPACITY must be a power of two"
+);
+
+namespace ESPressio {
+namespace Threads {
+
+    /// How a Thread notifies its observers.
+    enum class ObserverDelivery : uint8_t {
+        // On the task making the transition or iteration, before it
+        // continues.
+        Synchronous,
+
+        // Queued and delivered later on the observer dispatcher task.
+        Asynchronous
+    };
+
+
+    /// A queued observer notification. Plain data, so publishing copies a
+    /// few words into a preallocated slot and never allocates.
+    struct ObserverEvent {
+        using TCallback =
+            void (*)(
+                const ObserverEvent&
+            );
+
+        // Notifies the observers, on the dispatcher task.
+        TCallback Deliver = nullptr;
+
+        // Runs after Deliver, whether or not it threw.
+        TCallback Complete = nullptr;
+
+        void* Source = nullptr;
+        uint8_t Kind = 0;
+
+        uint64_t Values[3] = {
+            0,
+            0,
+            0
+        };
+    };
+
+
+    struct ObserverDispatcherStatistics {
+        uint64_t Published = 0;
+        uint64_t Delivered = 0;
+
+        // Events refused because the ring was full or the dispatcher task
+        // was not running.
+        uint64_t Dropped = 0;
+
+        // Deepest the ring has been, in events.
+        uint32_t PeakDepth = 0;
+    };
+
+
+    /*
+     * Delivers asynchronous observer notifications on one low-priority task.
+     *
+     * Producers claim a ring slot with a compare-and-swap and publish it
+     * through the slot's sequence number (a bounded multi-producer queue),
+     * so publishing never blocks or allocates, even from a PrecisionThread
+     * iteration. The task is created when a Thread selects asynchronous
+     * delivery, not by a publish, and blocks on its task notification while
+     * the ring is empty.
+     */
+    class ObserverDispatcher {
+        private:
+            struct Slot {
+                std::atomic<std::size_t> Sequence;
+                ObserverEvent Event;
+            };
+
+
+            Slot _slots[
+                ESPRESSIO_THREAD_OBSERVER_RING_CAPACITY
+            ];
+
+            std::atomic<std::size_t>
+                _enqueuePosition{
+                    0
+                };
+
+            // Owned by the dispatcher task.
+            std::size_t _dequeuePosition = 0;
+
+            std::mutex _startMutex;
+
+            std::atomic<TaskHandle_t>
+                _task{
+                    nullptr
+                };
+
+            // Set while the dispatcher task is about to block.
+            std::atomic<bool>
+                _waiting{
+                    false
+                };
+
+            // An event being delivered on the dispatcher task. Deliveries
+            // nest when a source is destroyed there and drains the ring.
+            struct Delivery {
+                void* Source;
+                bool SourceDestroyed;
+                Delivery* Outer;
+            };
+
+            // Owned by the dispatcher task.
+            Delivery* _delivery = nullptr;
+
+            std::atomic<uint64_t>
+                _published{
+                    0
+                };
+
+            std::atomic<uint64_t>
+                _delivered{
+                    0
+                };
+
+            std::atomic<uint64_t>
+                _dropped{
+                    0
+                };
+
+            std::atomic<uint32_t>
+                _peakDepth{
+                    0
+                };
+
+
+            ObserverDispatcher() {
+                for (
+                    std::size_t index = 0;
+                    index < ESPRESSIO_THREAD_OBSERVER_RING_CAPACITY;
+                    ++index
+                ) {
+                    _slots[index].Sequence.store(
+                        index,
+                        std::memory_order_relaxed
+                    );
+                }
+            }
+
+
+            bool _tryDequeue(
+                ObserverEvent& event
+            ) {
+                Slot& slot =
+                    _slots[
+                        _dequeuePosition &
+                        (ESPRESSIO_THREAD_OBSERVER_RING_CAPACITY - 1)
+                    ];
+
+                if (
+                    slot.Sequence.load(
+                        std::memory_order_acquire
+                    ) != _dequeuePosition + 1
+                ) {
+                    return false;
+                }
+
+                event = slot.Event;
+
+                slot.Sequence.store(
+                    _dequeuePosition +
+                        ESPRESSIO_THREAD_OBSERVER_RING_CAPACITY,
+                    std::memory_order_release
+                );
+
+                ++_dequeuePosition;
+
+                return true;
+            }
+
+
+            void _deliver(
+                const ObserverEvent& event
+            ) {
+                Delivery delivery{
+                    event.Source,
+                    false,
+                    _delivery
+                };
+
+                _delivery = &delivery;
+
+                try {
+                    if (event.Deliver != nullptr) {
+                        event.Deliver(
+                            event
+                        );
+                    }
+                } catch (...) {
+                }
+
+                _delivery = delivery.Outer;
+
+                // Skipped once an observer has destroyed the source.
+                try {
+                    if (
+                        event.Complete != nullptr &&
+                        !delivery.SourceDestroyed
+                    ) {
+                        event.Complete(
+                            event
+                        );
+                    }
+                } catch (...) {
+                }
+
+                _delivered.fetch_add(
+                    1,
+                    std::memory_order_relaxed
+                );
+            }
+
+
+            static void _taskEntry(
+                void* parameter
+            ) {
+                ObserverDispatcher* dispatcher =
+                    static_cast<
+                        ObserverDispatcher*
+                    >(parameter);
+
+                ObserverEvent event;
+
+                for (;;) {
+                    while (
+                        dispatcher->_tryDequeue(
+                            event
+                        )
+                    ) {
+                        dispatcher->_deliver(
+                            event
+                        );
+                    }
+
+                    dispatcher->_waiting.store(
+                        true,
+                        std::memory_order_seq_cst
+                    );
+
+                    /*
+                     * Orders the flag before the re-check below. Publish()
+                     * fences between its slot store and reading the flag,
+                     * so at least one side sees the other's store.
+                     */
+                    std::atomic_thread_fence(
+                        std::memory_order_seq_cst
+                    );
+
+                    // An event published before the flag was visible.
+                    if (
+                        dispatcher->_tryDequeue(
+                            event
+                        )
+                    ) {
+                        dispatcher->_waiting.store(
+                            false,
+                            std::memory_order_relaxed
+                        );
+
+                        dispatcher->_deliver(
+                            event
+                        );
+
+                        continue;
+                    }
+
+                    ulTaskNotifyTake(
+                        pdTRUE,
+                        portMAX_DELAY
+                    );
+
+                    dispatcher->_waiting.store(
+                        false,
+                        std::memory_order_relaxed
+                    );
+                }
+            }
+
+
+        public:
+            static ObserverDispatcher*
+            GetInstance() {
+                // Process-lifetime by design: the task runs for the life of
+                // the application.
+                static ObserverDispatcher* instance =
+                    new ObserverDispatcher();
+
+                return instance;
+            }
+
+
+            ObserverDispatcher(
+                const ObserverDispatcher&
+            ) = delete;
+
+            ObserverDispatcher& operator=(
+                const ObserverDispatcher&
+            ) = delete;
+
+
+            /// Creates the dispatcher task if it is not running. Returns
+            /// `false` if it cannot be created.
+            bool EnsureStarted() {
+                if (
+                    _task.load(
+                        std::memory_order_acquire
+                    ) != nullptr
+                ) {
+                    return true;
+                }
+
+                std::lock_guard<
+                    std::mutex
+                > lock(_startMutex);
+
+                if (
+                    _task.load(
+                        std::memory_order_acquire
+                    ) != nullptr
+                ) {
+                    return true;
+                }
+
+                TaskHandle_t task = nullptr;
+
+                if (
+                    xTaskCreate(
+                        _taskEntry,
+                        "threadObserverDispatcher",
+                        ESPRESSIO_THREAD_OBSERVER_DISPATCHER_STACK_SIZE,
+                        this,
+                        ESPRESSIO_THREAD_OBSERVER_DISPATCHER_PRIORITY,
+                        &task
+                    ) != pdPASS
+                ) {
+                    return false;
+                }
+
+                _task.store(
+                    task,
+                    std::memory_order_release
+                );
+
+                return true;
+            }
+
+
+            /// Queues `event` for delivery. Lock-free; safe from any task,
+            /// but not from an ISR. Returns `false`, counting a drop, when
+            /// the ring is full or EnsureStarted() has not succeeded.
+            bool Publish(
+                const ObserverEvent& event
+            ) {
+                if (
+                    _task.load(
+                        std::memory_order_acquire
+                    ) == nullptr
+                ) {
+                    _dropped.fetch_add(
+                        1,
+                        std::memory_order_relaxed
+                    );
+
+                    return false;
+                }
+
+                std::size_t position =
+                    _enqueuePosition.load(
+                        std::memory_order_relaxed
+                    );
+
+                Slot* slot;
+
+                for (;;) {
+                    slot =
+                        &_slots[
+                            position &
+                            (ESPRESSIO_THREAD_OBSERVER_RING_CAPACITY - 1)
+                        ];
+
+                    const std::size_t sequence =
+                        slot->Sequence.load(
+                            std::memory_order_acquire
+                        );
+
+                    if (sequence == position) {
+                        if (
+                            _enqueuePosition.compare_exchange_weak(
+                                position,
+                                position + 1,
+                                std::memory_order_relaxed
+                            )
+                        ) {
+                            break;
+                        }
+                    } else if (
+                        static_cast<std::ptrdiff_t>(
+                            sequence - position
+                        ) < 0
+                    ) {
+                        // The slot from one lap ago is still unread.
+                        _dropped.fetch_add(
+                            1,
+                            std::memory_order_relaxed
+                        );
+
+                        return false;
+                    } else {
+                        position =
+                            _enqueuePosition.load(
+                                std::memory_order_relaxed
+                            );
+                    }
+                }
+
+                slot->Event = event;
+
+                slot->Sequence.store(
+                    position + 1,
+                    std::memory_order_release
+                );
+
+                const uint64_t published =
+                    _published.fetch_add(
+                        1,
+                        std::memory_order_relaxed
+                    ) + 1;
+
+                const uint64_t depth =
+                    published -
+                    _delivered.load(
+                        std::memory_order_relaxed
+                    );
+
+                uint32_t peakDepth =
+                    _peakDepth.load(
+                        std::memory_order_relaxed
+                    );
+
+                while (
+                    depth > peakDepth &&
+                    !_peakDepth.compare_exchange_weak(
+                        peakDepth,
+                        static_cast<uint32_t>(depth),
+                        std::memory_order_relaxed
+                    )
+                ) {
+                }
+
+                std::atomic_thread_fence(
+                    std::memory_order_seq_cst
+                );
+
+                if (
+                    _waiting.exchange(
+                        false,
+                        std::memory_order_seq_cst
+                    )
+                ) {
+                    xTaskNotifyGive(
+                        _task.load(
+                            std::memory_order_acquire
+                        )
+                    );
+                }
+
+                return true;
+            }
+
+
+            /// `true` on the dispatcher task, where waiting for delivery
+            /// would deadlock.
+            bool IsDispatcherTask() const {
+                const TaskHandle_t task =
+                    _task.load(
+                        std::memory_order_acquire
+                    );
+
+                return
+                    task != nullptr &&
+                    task == xTaskGetCurrentTaskHandle();
+            }
+
+
+            /// Delivers every queued event inline. For a source that must
+            /// not wait for delivery because it runs on the dispatcher task.
+            void DeliverQueued() {
+                if (!IsDispatcherTask()) {
+                    return;
+                }
+
+                ObserverEvent event;
+
+                while (
+                    _tryDequeue(
+                        event
+                    )
+                ) {
+                    _deliver(
+                        event
+                    );
+                }
+            }
+
+
+            /// Called on the dispatcher task by a source being destroyed
+            /// there, typically by one of its own observers. Deliveries of
+            /// it still in progress then skip their completion, which would
+            /// touch the destroyed object.
+            void SourceDestroyed(
+                void* source
+            ) {
+                if (!IsDispatcherTask()) {
+                    return;
+                }
+
+                for (
+                    Delivery* delivery = _delivery;
+                    delivery != nullptr;
+                    delivery = delivery->Outer
+                ) {
+                    if (delivery->Source == source) {
+                        delivery->SourceDestroyed = true;
+                    }
+                }
+            }
+
+
+            ObserverDispatcherStatistics GetStatistics() const {
+                ObserverDispatcherStatistics statistics;
+
+                statistics.Published =
+                    _published.load(
+                        std::memory_order_relaxed
+                    );
+
+                statistics.Delivered =
+                    _delivered.load(
+                        std::memory_order_relaxed
+                    );
+
+                statistics.Dropped =
+                    _dropped.load(
+                        std::memory_order_relaxed
+                    );
+
+                statistics.PeakDepth =
+                    _peakDepth.load(
+                        std::memory_order_relaxed
+                    );
+
+                return statistics;
+            }
+
+
+            /// Minimum free stack of the dispatcher task since it started,
+            /// in the units `SetStackSize()` takes, or 0 if it is not
+            /// running.
+            uint32_t GetStackHighWaterMark() const {
+                const TaskHandle_t task =
+                    _task.load(
+                        std::memory_order_acquire
+                    );
+
+                return
+                    task != nullptr
+                        ? static_cast<uint32_t>(
+                            uxTaskGetStackHighWaterMark(task)
+                          )
+                        : 0;
+            }
+    };
+
+}
+}
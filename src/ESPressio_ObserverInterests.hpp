@@ -0,0 +1,270 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ESPressio {
+namespace Threads {
+
+    /// Bit set of observer callbacks, one bit per callback.
+    using ObserverEventMask =
+        uint32_t;
+
+    constexpr ObserverEventMask ObserverEventsAll =
+        0xFFFFFFFFu;
+
+
+    /*
+     * The callbacks each registered observer asked for.
+     *
+     * The OR of every mask is kept in one atomic, so a notification nobody
+     * wants costs a single bit test. Per-observer masks are only consulted
+     * when some observer registered with less than every event; the list is
+     * copy-on-write, so a notification takes one short lock to pin it and
+     * observers may register or unregister from inside a callback.
+     */
+    template <
+        typename TObserver
+    >
+    class ObserverInterestTable {
+        private:
+            struct Interest {
+                TObserver* Observer;
+                ObserverEventMask Mask;
+            };
+
+            using TInterests =
+                std::vector<Interest>;
+
+
+            mutable std::mutex _mutex;
+
+            // Replaced, never modified, so a Filter can keep its copy.
+            std::shared_ptr<
+                const TInterests
+            > _interests;
+
+            std::atomic<ObserverEventMask>
+                _combined{
+                    0
+                };
+
+            // Set while some observer wants less than every event.
+            std::atomic<bool>
+                _selective{
+                    false
+                };
+
+
+            // Rebuilds the shared list from `interests`; under `_mutex`.
+            void _publish(
+                const TInterests& interests
+            ) {
+                ObserverEventMask combined = 0;
+                bool selective = false;
+
+                for (
+                    const Interest& interest :
+                    interests
+                ) {
+                    combined |= interest.Mask;
+
+                    if (interest.Mask != ObserverEventsAll) {
+                        selective = true;
+                    }
+                }
+
+                _interests =
+                    std::make_shared<
+                        const TInterests
+                    >(
+                        interests
+                    );
+
+                _selective.store(
+                    selective,
+                    std::memory_order_release
+                );
+
+                _combined.store(
+                    combined,
+                    std::memory_order_release
+                );
+            }
+
+
+        public:
+            /*
+             * One notification's view of the table. Observers are usually
+             * visited in registration order, so each lookup starts where
+             * the previous one matched.
+             */
+            class Filter {
+                private:
+                    std::shared_ptr<
+                        const TInterests
+                    > _interests;
+
+                    std::size_t _cursor = 0;
+
+
+                public:
+                    Filter() = default;
+
+
+                    explicit Filter(
+                        std::shared_ptr<
+                            const TInterests
+                        > interests
+                    ) :
+                        _interests(
+                            std::move(interests)
+                        ) {
+                    }
+
+
+                    /// `true` if `observer` wants any event in `events`.
+                    /// Observers not in the table want everything.
+                    bool Accepts(
+                        TObserver* observer,
+                        ObserverEventMask events
+                    ) {
+                        if (_interests == nullptr) {
+                            return true;
+                        }
+
+                        const std::size_t count =
+                            _interests->size();
+
+                        for (
+                            std::size_t offset = 0;
+                            offset < count;
+                            ++offset
+                        ) {
+                            const std::size_t index =
+                                (_cursor + offset) % count;
+
+                            const Interest& interest =
+                                (*_interests)[index];
+
+                            if (interest.Observer == observer) {
+                                _cursor = index;
+
+                                return
+                                    (interest.Mask & events) != 0;
+                            }
+                        }
+
+                        return true;
+                    }
+            };
+
+
+            /// Records `observer`'s interests, replacing earlier ones.
+            void Set(
+                TObserver* observer,
+                ObserverEventMask events
+            ) {
+                std::lock_guard<
+                    std::mutex
+                > lock(_mutex);
+
+                TInterests interests;
+
+                if (_interests != nullptr) {
+                    interests = *_interests;
+                }
+
+                bool found = false;
+
+                for (
+                    Interest& interest :
+                    interests
+                ) {
+                    if (interest.Observer == observer) {
+                        interest.Mask = events;
+                        found = true;
+                    }
+                }
+
+                if (!found) {
+                    interests.push_back({
+                        observer,
+                        events
+                    });
+                }
+
+                _publish(
+                    interests
+                );
+            }
+
+
+            void Remove(
+                TObserver* observer
+            ) {
+                std::lock_guard<
+                    std::mutex
+                > lock(_mutex);
+
+                if (_interests == nullptr) {
+                    return;
+                }
+
+                TInterests interests;
+
+                for (
+                    const Interest& interest :
+                    *_interests
+                ) {
+                    if (interest.Observer != observer) {
+                        interests.push_back(
+                            interest
+                        );
+                    }
+                }
+
+                _publish(
+                    interests
+                );
+            }
+
+
+            /// `true` if any observer wants an event in `events`.
+            bool IsAnyInterested(
+                ObserverEventMask events
+            ) const {
+                return
+                    (
+                        _combined.load(
+                            std::memory_order_acquire
+                        ) & events
+                    ) != 0;
+            }
+
+
+            Filter GetFilter() const {
+                if (
+                    !_selective.load(
+                        std::memory_order_acquire
+                    )
+                ) {
+                    return Filter();
+                }
+
+                std::lock_guard<
+                    std::mutex
+                > lock(_mutex);
+
+                return Filter(
+                    _interests
+                );
+            }
+    };
+
+}
+}
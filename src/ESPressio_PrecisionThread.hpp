@@ -15,9 +15,11 @@
 
 #include "ESPressio_Frequency.hpp"
 #include "ESPressio_IPrecisionThreadObserver.hpp"
+#include "ESPressio_PrecisionThreadStatistics.hpp"
 #include "ESPressio_PrecisionThreadTraits.hpp"
 #include "ESPressio_ISystemClock.hpp"
 #include "ESPressio_SystemClock.hpp"
+#include "ESPressio_ThreadDeadline.hpp"
 #include "ESPressio_TimeTraits.hpp"
 #include "ESPressio_Thread.hpp"
 #include "ESPressio_ThreadSafeObservable.hpp"
@@ -30,6 +32,114 @@ namespace ESPressio {
             EndToStart
         };
 
+
+        enum class IterationCatchUpMode : uint8_t {
+            // Skip every missed slot and run once now; the schedule keeps
+            // its phase.
+            SkipToNow,
+
+            // Run missed slots back to back, at most BurstLimit of them;
+            // older ones are skipped.
+            BurstUpTo,
+
+            // As SkipToNow, but an iteration more than half a period past
+            // its slot is dropped too, and the thread waits for the next
+            // slot. Iterations therefore always start near their phase.
+            PreservePhase,
+
+            // Run once now as if on time: nothing is reported skipped and
+            // the schedule restarts from now.
+            Coalesce
+        };
+
+
+        /*
+         * Settings of the PrecisionThread period governor. Every
+         * WindowIterations iterations it compares the mean Iterate() time
+         * with the period in use. At OverloadPercent, or when an iteration
+         * was skipped, it stretches the period at once so that the load
+         * lands midway between the two thresholds, never beyond the desired
+         * iteration period. Below RelaxPercent it shortens the period again,
+         * by at most RelaxStepPercent per window, never below the iteration
+         * period. The gap between the thresholds is the hysteresis.
+         */
+        struct PrecisionThreadGovernorConfiguration {
+            bool Enabled = false;
+
+            uint8_t OverloadPercent = 85;
+            uint8_t RelaxPercent = 50;
+            uint8_t RelaxStepPercent = 10;
+
+            uint16_t WindowIterations = 16;
+        };
+
+
+        /// What a PrecisionThread does with slots it missed.
+        struct IterationCatchUpPolicy {
+            IterationCatchUpMode Mode =
+                IterationCatchUpMode::SkipToNow;
+
+            // BurstUpTo only.
+            uint32_t BurstLimit = 0;
+
+
+            static constexpr IterationCatchUpPolicy SkipToNow() {
+                return {
+                    IterationCatchUpMode::SkipToNow,
+                    0
+                };
+            }
+
+
+            static constexpr IterationCatchUpPolicy BurstUpTo(
+                uint32_t limit
+            ) {
+                return {
+                    IterationCatchUpMode::BurstUpTo,
+                    limit
+                };
+            }
+
+
+            static constexpr IterationCatchUpPolicy PreservePhase() {
+                return {
+                    IterationCatchUpMode::PreservePhase,
+                    0
+                };
+            }
+
+
+            static constexpr IterationCatchUpPolicy Coalesce() {
+                return {
+                    IterationCatchUpMode::Coalesce,
+                    0
+                };
+            }
+
+
+            bool operator==(
+                const IterationCatchUpPolicy& other
+            ) const {
+                return
+                    Mode == other.Mode &&
+                    BurstLimit == other.BurstLimit;
+            }
+
+
+            bool operator!=(
+                const IterationCatchUpPolicy& other
+            ) const {
+                return !(*this == other);
+            }
+        };
+
+        template<
+            typename TTime,
+            typename TRepresentationTraits
+        >
+        class PrecisionThreadGroup;
+
+
         /*
          * PrecisionThread is parameterized by its public time representation,
          * matching ESPressio Timing 2.x.
@@ -78,9 +188,40 @@ namespace ESPressio {
                         SignedIterationTime;
 
             private:
+                friend class
+                    PrecisionThreadGroup<TTime, TRepresentationTraits>;
+
                 class IterationObservable final :
                     public Observable::ThreadSafeObservable {
                     public:
+                        void NotifyPeriodAdapted(
+                            PrecisionThread<TTime, TRepresentationTraits>* thread,
+                            IterationTime oldPeriod,
+                            IterationTime newPeriod
+                        ) {
+                            ExecuteNotification([&](
+                                NotificationContext& notification
+                            ) {
+                                notification.WithObservers<
+                                    IPrecisionThreadObserver<TTime, TRepresentationTraits>
+                                >([&](
+                                    IPrecisionThreadObserver<TTime, TRepresentationTraits>* observer
+                                ) {
+                                    try {
+                                        observer->OnPrecisionThreadPeriodAdapted(
+                                            thread,
+                                            oldPeriod,
+                                            newPeriod
+                                        );
+                                    } catch (...) {
+                                        // Observer diagnostics must not
+                                        // interrupt precision scheduling.
+                                    }
+                                });
+                            });
+                        }
+
+
                         void Notify(
                             PrecisionThread<TTime, TRepresentationTraits>* thread,
                             IterationTime delta,
@@ -113,8 +254,12 @@ namespace ESPressio {
 
                 ClockType* _clock;
 
-                std::shared_ptr<IterationObservable> _iterationObservable =
-                    std::make_shared<IterationObservable>();
+                // Allocated on the first RegisterIterationObserver() call;
+                // unobserved iterations then cost a single pointer load.
+                std::shared_ptr<IterationObservable> _iterationObservable;
+
+                std::atomic<IterationObservable*>
+                    _iterationObservableInstance{nullptr};
 
                 SemaphoreHandle_t _scheduleSignal =
                     xSemaphoreCreateBinary();
@@ -124,14 +269,43 @@ namespace ESPressio {
                 IterationDeltaMode _deltaMode =
                     IterationDeltaMode::StartToStart;
 
+                IterationCatchUpPolicy _catchUpPolicy;
+
+                // Slots PreservePhase dropped, reported with the next
+                // iteration that runs.
+                SkippedIterationCount _droppedIterations = 0;
+
                 uint64_t _iterationPeriodNanoseconds = 0;
                 uint64_t _desiredIterationPeriodNanoseconds = 0;
 
-                uint32_t _iterationSampleCount = 10;
-                std::deque<uint64_t> _iterationSamples;
+                // The period scheduled, between the iteration period and the
+                // desired period while the governor has stretched it.
+                uint64_t _effectivePeriodNanoseconds = 0;
 
-                double _iterationFrequency = 0.0;
-                double _averageIterationFrequency = 0.0;
+                PrecisionThreadGovernorConfiguration _governor;
+
+                // The governor's current window.
+                uint32_t _governorIterations = 0;
+                uint64_t _governorExecutionNanoseconds = 0;
+                bool _governorSkipped = false;
+
+                // Iteration-time measurements. Kept out of line so that a
+                // PrecisionThreadBase with NoMeasurements carries only a
+                // null pointer.
+                struct Measurements {
+                    uint32_t SampleCount = 10;
+                    std::deque<uint64_t> Samples;
+
+                    double Frequency = 0.0;
+                    double AverageFrequency = 0.0;
+
+                    // Cleared with the other measurements.
+                    PrecisionThreadTimingAccumulator Timing;
+                };
+
+                std::unique_ptr<
+                    Measurements
+                > _measurements;
 
                 bool _scheduleInitialized = false;
                 bool _hasPreviousIteration = false;
@@ -145,6 +319,21 @@ namespace ESPressio {
 
                 std::atomic<bool> _workWakeRequested{false};
 
+                // Set by a PrecisionThreadGroup. Slots then lie on the
+                // group's grid: epoch + offset + k * period.
+                PrecisionThreadGroup<TTime, TRepresentationTraits>*
+                    _phaseGroup = nullptr;
+
+                // Installed by the group, so that this header does not need
+                // its definition.
+                void (*_leavePhaseGroup)(
+                    PrecisionThreadGroup<TTime, TRepresentationTraits>*,
+                    PrecisionThread*
+                ) = nullptr;
+
+                uint64_t _phaseEpochNanoseconds = 0;
+                uint64_t _phaseOffsetNanoseconds = 0;
+
 
                 static uint64_t _addSaturated(
                     uint64_t left,
@@ -160,6 +349,200 @@ namespace ESPressio {
                 }
 
 
+                static uint64_t _addPeriods(
+                    uint64_t base,
+                    uint64_t count,
+                    uint64_t period
+                ) {
+                    return
+                        _addSaturated(
+                            base,
+                            count >
+                                std::numeric_limits<
+                                    uint64_t
+                                >::max() /
+                                period
+                                ? std::numeric_limits<
+                                    uint64_t
+                                  >::max()
+                                : count *
+                                  period
+                        );
+                }
+
+
+                // The first slot of the group grid at or after `now`.
+                uint64_t _getPhaseSlotLocked(
+                    uint64_t now,
+                    uint64_t period
+                ) const {
+                    const uint64_t anchor =
+                        _addSaturated(
+                            _phaseEpochNanoseconds,
+                            _phaseOffsetNanoseconds
+                        );
+
+                    if (now <= anchor) {
+                        return anchor;
+                    }
+
+                    const uint64_t behind =
+                        now -
+                        anchor;
+
+                    return
+                        _addPeriods(
+                            anchor,
+                            behind / period +
+                                (behind % period != 0 ? 1 : 0),
+                            period
+                        );
+                }
+
+
+                /*
+                 * Moves the schedule past the due slot at
+                 * _nextIterationNanoseconds as the catch-up policy says.
+                 * Returns `false` when this iteration is dropped rather than
+                 * run. `period` is non-zero.
+                 */
+                bool _catchUpLocked(
+                    uint64_t now,
+                    uint64_t period,
+                    SkippedIterationCount& skippedIterations,
+                    uint64_t& lateNanoseconds
+                ) {
+                    const uint64_t behind =
+                        now -
+                        _nextIterationNanoseconds;
+
+                    const uint64_t elapsedPeriods =
+                        behind /
+                        period;
+
+                    switch (_catchUpPolicy.Mode) {
+                        case IterationCatchUpMode::BurstUpTo: {
+                            const uint64_t dropped =
+                                elapsedPeriods >
+                                    _catchUpPolicy.BurstLimit
+                                    ? elapsedPeriods -
+                                      _catchUpPolicy.BurstLimit
+                                    : 0;
+
+                            // The oldest slot still to be run.
+                            const uint64_t slot =
+                                _addPeriods(
+                                    _nextIterationNanoseconds,
+                                    dropped,
+                                    period
+                                );
+
+                            skippedIterations =
+                                dropped;
+
+                            lateNanoseconds =
+                                now >= slot
+                                    ? now - slot
+                                    : 0;
+
+                            _nextIterationNanoseconds =
+                                _addSaturated(
+                                    slot,
+                                    period
+                                );
+
+                            return true;
+                        }
+
+                        case IterationCatchUpMode::Coalesce:
+                            skippedIterations = 0;
+
+                            lateNanoseconds =
+                                behind;
+
+                            // A group member stays on the group's grid.
+                            _nextIterationNanoseconds =
+                                _phaseGroup != nullptr
+                                    ? _getPhaseSlotLocked(
+                                        _addSaturated(
+                                            now,
+                                            1
+                                        ),
+                                        period
+                                      )
+                                    : _addSaturated(
+                                        now,
+                                        period
+                                      );
+
+                            return true;
+
+                        case IterationCatchUpMode::PreservePhase: {
+                            _nextIterationNanoseconds =
+                                _addSaturated(
+                                    _addPeriods(
+                                        _nextIterationNanoseconds,
+                                        elapsedPeriods,
+                                        period
+                                    ),
+                                    period
+                                );
+
+                            const uint64_t late =
+                                behind %
+                                period;
+
+                            if (late > period / 2) {
+                                _droppedIterations =
+                                    _addSaturated(
+                                        _droppedIterations,
+                                        _addSaturated(
+                                            elapsedPeriods,
+                                            1
+                                        )
+                                    );
+
+                                return false;
+                            }
+
+                            skippedIterations =
+                                _addSaturated(
+                                    _droppedIterations,
+                                    elapsedPeriods
+                                );
+
+                            _droppedIterations = 0;
+
+                            lateNanoseconds =
+                                late;
+
+                            return true;
+                        }
+
+                        case IterationCatchUpMode::SkipToNow:
+                        default:
+                            skippedIterations =
+                                elapsedPeriods;
+
+                            lateNanoseconds =
+                                behind %
+                                period;
+
+                            _nextIterationNanoseconds =
+                                _addSaturated(
+                                    _addPeriods(
+                                        _nextIterationNanoseconds,
+                                        elapsedPeriods,
+                                        period
+                                    ),
+                                    period
+                                );
+
+                            return true;
+                    }
+                }
+
+
                 static uint64_t _toNanoseconds(
                     const IterationTime& time
                 ) {
@@ -172,6 +555,204 @@ namespace ESPressio {
                 }
 
 
+                enum IterationEventKind : uint8_t {
+                    IterationEvent,
+                    PeriodAdaptedEvent
+                };
+
+
+                void _resetGovernorWindowLocked() {
+                    _governorIterations = 0;
+                    _governorExecutionNanoseconds = 0;
+                    _governorSkipped = false;
+                }
+
+
+                /*
+                 * Feeds one iteration to the governor. Returns `true`, with
+                 * the periods before and after, when it changed the period
+                 * in use.
+                 */
+                bool _governLocked(
+                    uint64_t executionNanoseconds,
+                    SkippedIterationCount skippedIterations,
+                    uint64_t& oldPeriod,
+                    uint64_t& newPeriod
+                ) {
+                    const uint64_t nominal =
+                        _iterationPeriodNanoseconds;
+
+                    const uint64_t ceiling =
+                        std::max(
+                            _desiredIterationPeriodNanoseconds,
+                            nominal
+                        );
+
+                    // A group member keeps the group's period.
+                    if (
+                        !_governor.Enabled ||
+                        _phaseGroup != nullptr ||
+                        nominal == 0 ||
+                        ceiling == nominal
+                    ) {
+                        return false;
+                    }
+
+                    ++_governorIterations;
+
+                    _governorExecutionNanoseconds =
+                        _addSaturated(
+                            _governorExecutionNanoseconds,
+                            executionNanoseconds
+                        );
+
+                    if (skippedIterations > 0) {
+                        _governorSkipped = true;
+                    }
+
+                    if (
+                        _governorIterations <
+                        std::max<uint32_t>(
+                            _governor.WindowIterations,
+                            1
+                        )
+                    ) {
+                        return false;
+                    }
+
+                    const uint64_t average =
+                        _governorExecutionNanoseconds /
+                        _governorIterations;
+
+                    const bool skipped =
+                        _governorSkipped;
+
+                    _resetGovernorWindowLocked();
+
+                    const uint64_t current =
+                        _effectivePeriodNanoseconds;
+
+                    const uint64_t loadPercent =
+                        average * 100 /
+                        current;
+
+                    const uint64_t targetPercent =
+                        std::max<uint64_t>(
+                            (
+                                static_cast<uint64_t>(
+                                    _governor.OverloadPercent
+                                ) +
+                                _governor.RelaxPercent
+                            ) / 2,
+                            1
+                        );
+
+                    // The period at which `average` is the target load.
+                    const uint64_t balanced =
+                        average > std::numeric_limits<uint64_t>::max() / 100
+                            ? ceiling
+                            : average * 100 / targetPercent;
+
+                    uint64_t next =
+                        current;
+
+                    if (
+                        skipped ||
+                        loadPercent >= _governor.OverloadPercent
+                    ) {
+                        next =
+                            std::max(
+                                balanced,
+                                current +
+                                    current *
+                                    _governor.RelaxStepPercent /
+                                    100
+                            );
+                    } else if (
+                        loadPercent < _governor.RelaxPercent &&
+                        current > nominal
+                    ) {
+                        next =
+                            std::max(
+                                balanced,
+                                current -
+                                    current *
+                                    _governor.RelaxStepPercent /
+                                    100
+                            );
+                    }
+
+                    next =
+                        std::min(
+                            std::max(
+                                next,
+                                nominal
+                            ),
+                            ceiling
+                        );
+
+                    if (next == current) {
+                        return false;
+                    }
+
+                    _effectivePeriodNanoseconds =
+                        next;
+
+                    oldPeriod = current;
+                    newPeriod = next;
+
+                    return true;
+                }
+
+
+                // Queued iterations carry nanoseconds; the time values are
+                // rebuilt on the dispatcher task.
+                static void _deliverIterationEvent(
+                    const ObserverEvent& event
+                ) {
+                    PrecisionThread* thread =
+                        static_cast<PrecisionThread*>(
+                            static_cast<Thread*>(
+                                event.Source
+                            )
+                        );
+
+                    IterationObservable* iterationObservable =
+                        thread->_iterationObservableInstance.load(
+                            std::memory_order_acquire
+                        );
+
+                    if (iterationObservable == nullptr) {
+                        return;
+                    }
+
+                    if (event.Kind == PeriodAdaptedEvent) {
+                        iterationObservable->NotifyPeriodAdapted(
+                            thread,
+                            thread->_fromNanoseconds(
+                                event.Values[0]
+                            ),
+                            thread->_fromNanoseconds(
+                                event.Values[1]
+                            )
+                        );
+
+                        return;
+                    }
+
+                    iterationObservable->Notify(
+                        thread,
+                        thread->_fromNanoseconds(
+                            event.Values[0]
+                        ),
+                        thread->_fromNanoseconds(
+                            event.Values[1]
+                        ),
+                        event.Values[2]
+                    );
+                }
+
+
                 IterationTime _fromNanoseconds(
                     uint64_t nanoseconds
                 ) const {
@@ -226,10 +807,14 @@ namespace ESPressio {
                     _previousEndNanoseconds = 0;
                     _activeIterationStartNanoseconds = 0;
 
-                    _iterationSamples.clear();
+                    if (_measurements != nullptr) {
+                        _measurements->Samples.clear();
+
+                        _measurements->Frequency = 0.0;
+                        _measurements->AverageFrequency = 0.0;
 
-                    _iterationFrequency = 0.0;
-                    _averageIterationFrequency = 0.0;
+                        _measurements->Timing.Reset();
+                    }
                 }
 
 
@@ -255,14 +840,17 @@ namespace ESPressio {
                 void _recordSampleLocked(
                     uint64_t startToStartDelta
                 ) {
+                    Measurements& measurements =
+                        *_measurements;
+
                     if (
-                        _iterationSampleCount == 0 ||
+                        measurements.SampleCount == 0 ||
                         startToStartDelta == 0
                     ) {
                         return;
                     }
 
-                    _iterationFrequency =
+                    measurements.Frequency =
                         static_cast<double>(
                             Timing::NanosecondsPerSecond
                         ) /
@@ -270,22 +858,22 @@ namespace ESPressio {
                             startToStartDelta
                         );
 
-                    _iterationSamples.push_back(
+                    measurements.Samples.push_back(
                         startToStartDelta
                     );
 
                     while (
-                        _iterationSamples.size() >
-                        _iterationSampleCount
+                        measurements.Samples.size() >
+                        measurements.SampleCount
                     ) {
-                        _iterationSamples.pop_front();
+                        measurements.Samples.pop_front();
                     }
 
                     long double total = 0.0L;
 
                     for (
                         uint64_t sample :
-                        _iterationSamples
+                        measurements.Samples
                     ) {
                         total +=
                             static_cast<long double>(
@@ -293,12 +881,12 @@ namespace ESPressio {
                             );
                     }
 
-                    _averageIterationFrequency =
+                    measurements.AverageFrequency =
                         total > 0.0L
                             ? static_cast<double>(
                                 (
                                     static_cast<long double>(
-                                        _iterationSamples.size()
+                                        measurements.Samples.size()
                                     ) *
                                     Timing::NanosecondsPerSecond
                                 ) /
@@ -308,36 +896,6 @@ namespace ESPressio {
                 }
 
 
-                TickType_t _getWaitTicks(
-                    uint64_t remainingNanoseconds
-                ) const {
-                    const uint64_t milliseconds =
-                        remainingNanoseconds /
-                        Timing::NanosecondsPerMillisecond;
-
-                    if (milliseconds == 0) {
-                        return 0;
-                    }
-
-                    const uint64_t bounded =
-                        std::min<uint64_t>(
-                            milliseconds,
-                            static_cast<uint64_t>(
-                                std::numeric_limits<
-                                    TickType_t
-                                >::max()
-                            )
-                        );
-
-                    return
-                        pdMS_TO_TICKS(
-                            static_cast<uint32_t>(
-                                bounded
-                            )
-                        );
-                }
-
-
             protected:
                 virtual void OnWorkWake() {
                 }
@@ -360,11 +918,51 @@ namespace ESPressio {
 
 
                 void OnLoop() final override {
+                    OnSchedule();
+                }
+
+
+                // Runs the scheduler. The default performs one step per
+                // OnLoop(); PrecisionThreadBase overrides it to keep control
+                // across steps with Iterate() inlined.
+                virtual void OnSchedule() {
+                    ScheduleStep<true, true>(
+                        [this](
+                            IterationTime delta,
+                            IterationTime startTime,
+                            SkippedIterationCount skippedIterations
+                        ) {
+                            Iterate(
+                                delta,
+                                startTime,
+                                skippedIterations
+                            );
+                        }
+                    );
+                }
+
+
+                // One scheduling step: either waits toward the next
+                // iteration or runs `iterate` once. Observer notification
+                // and iteration-time sampling can be compiled out.
+                template <
+                    bool TNotifyObservers,
+                    bool TRecordSamples,
+                    typename TIterate
+                >
+                void ScheduleStep(
+                    TIterate&& iterate
+                ) {
                     if (
                         _workWakeRequested.exchange(
                             false
                         )
                     ) {
+                        RecordThreadTrace(
+                            ThreadTraceEventType::WorkWake,
+                            Thread::GetThreadID()
+                        );
+
                         OnWorkWake();
                         return;
                     }
@@ -382,24 +980,50 @@ namespace ESPressio {
                     SkippedIterationCount
                         skippedIterations = 0;
 
+                    // How far past its scheduled slot this iteration starts.
+                    uint64_t lateNanoseconds = 0;
+
+                    // When the following iteration is due.
+                    uint64_t nextDueNanoseconds = 0;
+
+                    bool periodAdapted = false;
+                    uint64_t oldPeriodNanoseconds = 0;
+                    uint64_t newPeriodNanoseconds = 0;
+
                     {
                         std::lock_guard<std::mutex>
                             lock(_timingMutex);
 
                         period =
-                            _iterationPeriodNanoseconds;
+                            _effectivePeriodNanoseconds;
 
                         if (!_scheduleInitialized) {
                             _scheduleInitialized = true;
 
                             _nextIterationNanoseconds =
-                                now;
+                                _phaseGroup != nullptr &&
+                                    period > 0
+                                    ? _getPhaseSlotLocked(
+                                        now,
+                                        period
+                                      )
+                                    : now;
+
+                            _droppedIterations = 0;
                         }
 
                         if (
                             period > 0 &&
-                            now <
-                                _nextIterationNanoseconds
+                            (
+                                now <
+                                    _nextIterationNanoseconds ||
+                                !_catchUpLocked(
+                                    now,
+                                    period,
+                                    skippedIterations,
+                                    lateNanoseconds
+                                )
+                            )
                         ) {
                             remainingNanoseconds =
                                 _nextIterationNanoseconds -
@@ -421,6 +1045,7 @@ namespace ESPressio {
                                         : 0;
 
                                 if (
+                                    TRecordSamples &&
                                     now >=
                                     _previousStartNanoseconds
                                 ) {
@@ -432,42 +1057,8 @@ namespace ESPressio {
                             }
 
                             if (period > 0) {
-                                const uint64_t behind =
-                                    now -
+                                nextDueNanoseconds =
                                     _nextIterationNanoseconds;
-
-                                const uint64_t elapsedPeriods =
-                                    behind /
-                                    period;
-
-                                skippedIterations =
-                                    elapsedPeriods;
-
-                                const uint64_t periodsToAdvance =
-                                    elapsedPeriods ==
-                                        std::numeric_limits<
-                                            uint64_t
-                                        >::max()
-                                        ? elapsedPeriods
-                                        : elapsedPeriods + 1;
-
-                                const uint64_t advance =
-                                    periodsToAdvance >
-                                        std::numeric_limits<
-                                            uint64_t
-                                        >::max() /
-                                        period
-                                        ? std::numeric_limits<
-                                            uint64_t
-                                          >::max()
-                                        : periodsToAdvance *
-                                          period;
-
-                                _nextIterationNanoseconds =
-                                    _addSaturated(
-                                        _nextIterationNanoseconds,
-                                        advance
-                                    );
                             }
 
                             _activeIterationStartNanoseconds =
@@ -479,19 +1070,17 @@ namespace ESPressio {
                     }
 
                     if (shouldWait) {
-                        const TickType_t waitTicks =
-                            _getWaitTicks(
-                                remainingNanoseconds
-                            );
-
-                        if (waitTicks > 0) {
-                            xSemaphoreTake(
-                                _scheduleSignal,
-                                waitTicks
-                            );
-                        } else {
-                            taskYIELD();
-                        }
+                        // Wakes at the deadline, or early when signalled or
+                        // on a tick boundary; either way the next step
+                        // re-reads the schedule.
+                        WaitForDeadline(
+                            _scheduleSignal,
+                            now +
+                                remainingNanoseconds,
+                            [this]() {
+                                return _getNowNanoseconds();
+                            }
+                        );
 
                         return;
                     }
@@ -506,15 +1095,57 @@ namespace ESPressio {
                             now
                         );
 
-                    Iterate(
+                    if (skippedIterations > 0) {
+                        RecordThreadTrace(
+                            ThreadTraceEventType::IterationsSkipped,
+                            Thread::GetThreadID(),
+                            static_cast<uint32_t>(
+                                std::min<SkippedIterationCount>(
+                                    skippedIterations,
+                                    std::numeric_limits<uint32_t>::max()
+                                )
+                            )
+                        );
+                    }
+
+                    RecordThreadTrace(
+                        ThreadTraceEventType::IterationBegin,
+                        Thread::GetThreadID()
+                    );
+
+                    iterate(
                         delta,
                         startTime,
                         skippedIterations
                     );
 
+                    RecordThreadTrace(
+                        ThreadTraceEventType::IterationEnd,
+                        Thread::GetThreadID()
+                    );
+
                     const uint64_t end =
                         _getNowNanoseconds();
 
+                    #if ESPRESSIO_THREAD_METRICS
+                        if (TRecordSamples) {
+                            ThreadMetrics* metrics =
+                                ThreadMetrics::GetInstance();
+
+                            metrics->IterationDuration.Record(
+                                end >= now
+                                    ? end - now
+                                    : 0
+                            );
+
+                            if (period > 0) {
+                                metrics->IterationJitter.Record(
+                                    lateNanoseconds
+                                );
+                            }
+                        }
+                    #endif
+
                     {
                         std::lock_guard<std::mutex>
                             lock(_timingMutex);
@@ -531,15 +1162,83 @@ namespace ESPressio {
 
                             _hasPreviousIteration =
                                 true;
+
+                            if (TRecordSamples) {
+                                _measurements->Timing.Record(
+                                    period > 0,
+                                    lateNanoseconds,
+                                    end >= now
+                                        ? end - now
+                                        : 0,
+                                    skippedIterations,
+                                    // A burst's backlog was already due
+                                    // before this iteration started.
+                                    period > 0 &&
+                                        nextDueNanoseconds > now &&
+                                        end > nextDueNanoseconds
+                                );
+                            }
+
+                            // The governor runs under NoMeasurements too;
+                            // it only needs this iteration's execution time.
+                            periodAdapted =
+                                _governLocked(
+                                    end >= now
+                                        ? end - now
+                                        : 0,
+                                    skippedIterations,
+                                    oldPeriodNanoseconds,
+                                    newPeriodNanoseconds
+                                );
                         }
                     }
 
-                    _iterationObservable->Notify(
-                        this,
-                        delta,
-                        startTime,
-                        skippedIterations
-                    );
+                    if (TNotifyObservers) {
+                        IterationObservable* iterationObservable =
+                            _iterationObservableInstance.load(
+                                std::memory_order_acquire
+                            );
+
+                        if (iterationObservable != nullptr) {
+                            if (
+                                GetObserverDelivery() ==
+                                ObserverDelivery::Asynchronous
+                            ) {
+                                ObserverEvent event;
+
+                                event.Deliver =
+                                    _deliverIterationEvent;
+
+                                event.Values[0] =
+                                    deltaNanoseconds;
+
+                                event.Values[1] =
+                                    now;
+
+                                event.Values[2] =
+                                    skippedIterations;
+
+                                PublishObserverEvent(
+                                    event
+                                );
+                            } else {
+                                iterationObservable->Notify(
+                                    this,
+                                    delta,
+                                    startTime,
+                                    skippedIterations
+                                );
+                            }
+
+                            if (periodAdapted) {
+                                _notifyPeriodAdapted(
+                                    iterationObservable,
+                                    oldPeriodNanoseconds,
+                                    newPeriodNanoseconds
+                                );
+                            }
+                        }
+                    }
 
                     if (period == 0) {
                         taskYIELD();
@@ -547,6 +1246,48 @@ namespace ESPressio {
                 }
 
 
+                void _notifyPeriodAdapted(
+                    IterationObservable* iterationObservable,
+                    uint64_t oldPeriodNanoseconds,
+                    uint64_t newPeriodNanoseconds
+                ) {
+                    if (
+                        GetObserverDelivery() ==
+                        ObserverDelivery::Asynchronous
+                    ) {
+                        ObserverEvent event;
+
+                        event.Deliver =
+                            _deliverIterationEvent;
+
+                        event.Kind =
+                            PeriodAdaptedEvent;
+
+                        event.Values[0] =
+                            oldPeriodNanoseconds;
+
+                        event.Values[1] =
+                            newPeriodNanoseconds;
+
+                        PublishObserverEvent(
+                            event
+                        );
+
+                        return;
+                    }
+
+                    iterationObservable->NotifyPeriodAdapted(
+                        this,
+                        _fromNanoseconds(
+                            oldPeriodNanoseconds
+                        ),
+                        _fromNanoseconds(
+                            newPeriodNanoseconds
+                        )
+                    );
+                }
+
+
             public:
                 explicit PrecisionThread(
                     ClockType* clock = nullptr
@@ -557,6 +1298,11 @@ namespace ESPressio {
                                 IterationTime
                               >::GetInstance()
                             : clock
+                    ),
+                    _measurements(
+                        std::make_unique<
+                            Measurements
+                        >()
                     ) {
                 }
 
@@ -574,13 +1320,70 @@ namespace ESPressio {
                                 IterationTime
                               >::GetInstance()
                             : clock
+                    ),
+                    _measurements(
+                        std::make_unique<
+                            Measurements
+                        >()
                     ) {
                 }
 
 
+            protected:
+                // For PrecisionThreadBase: unless `measured`, the
+                // measurement block is never allocated.
+                PrecisionThread(
+                    bool freeOnTerminate,
+                    ClockType* clock,
+                    bool measured
+                ) :
+                    Thread(
+                        freeOnTerminate
+                    ),
+                    _clock(
+                        clock == nullptr
+                            ? &Timing::SystemClock<
+                                IterationTime
+                              >::GetInstance()
+                            : clock
+                    ),
+                    _measurements(
+                        measured
+                            ? std::make_unique<
+                                Measurements
+                              >()
+                            : nullptr
+                    ) {
+                }
+
+
+            public:
                 ~PrecisionThread() override {
                     Shutdown();
 
+                    PrecisionThreadGroup<TTime, TRepresentationTraits>*
+                        group = nullptr;
+
+                    void (*leave)(
+                        PrecisionThreadGroup<TTime, TRepresentationTraits>*,
+                        PrecisionThread*
+                    ) = nullptr;
+
+                    {
+                        std::lock_guard<std::mutex>
+                            lock(_timingMutex);
+
+                        group = _phaseGroup;
+                        leave = _leavePhaseGroup;
+                    }
+
+                    if (group != nullptr) {
+                        leave(
+                            group,
+                            this
+                        );
+                    }
+
                     if (_scheduleSignal != nullptr) {
                         vSemaphoreDelete(
                             _scheduleSignal
@@ -659,8 +1462,33 @@ namespace ESPressio {
                         TRepresentationTraits
                     >* observer
                 ) {
+                    IterationObservable* observable =
+                        _iterationObservableInstance.load(
+                            std::memory_order_acquire
+                        );
+
+                    if (observable == nullptr) {
+                        std::lock_guard<std::mutex>
+                            lock(_timingMutex);
+
+                        if (_iterationObservable == nullptr) {
+                            _iterationObservable =
+                                std::make_shared<
+                                    IterationObservable
+                                >();
+
+                            _iterationObservableInstance.store(
+                                _iterationObservable.get(),
+                                std::memory_order_release
+                            );
+                        }
+
+                        observable =
+                            _iterationObservable.get();
+                    }
+
                     return
-                        _iterationObservable->
+                        observable->
                             RegisterObserver(
                                 observer
                             );
@@ -673,10 +1501,17 @@ namespace ESPressio {
                         TRepresentationTraits
                     >* observer
                 ) {
-                    _iterationObservable->
-                        UnregisterObserver(
-                            observer
+                    IterationObservable* observable =
+                        _iterationObservableInstance.load(
+                            std::memory_order_acquire
                         );
+
+                    if (observable != nullptr) {
+                        observable->
+                            UnregisterObserver(
+                                observer
+                            );
+                    }
                 }
 
 
@@ -708,6 +1543,27 @@ namespace ESPressio {
                 }
 
 
+                IterationCatchUpPolicy
+                GetIterationCatchUpPolicy() const {
+                    std::lock_guard<std::mutex>
+                        lock(_timingMutex);
+
+                    return _catchUpPolicy;
+                }
+
+
+                /// Selects how missed slots are handled from the next late
+                /// iteration on. The schedule itself is kept.
+                void SetIterationCatchUpPolicy(
+                    IterationCatchUpPolicy policy
+                ) {
+                    std::lock_guard<std::mutex>
+                        lock(_timingMutex);
+
+                    _catchUpPolicy = policy;
+                }
+
+
                 IterationTime
                 GetIterationPeriod() const {
                     std::lock_guard<std::mutex>
@@ -720,7 +1576,9 @@ namespace ESPressio {
                 }
 
 
-                void SetIterationPeriod(
+                /// Returns `false`, changing nothing, while the thread belongs
+                /// to a PrecisionThreadGroup; the group sets its period.
+                bool SetIterationPeriod(
                     IterationTime period
                 ) {
                     const uint64_t nanoseconds =
@@ -732,9 +1590,18 @@ namespace ESPressio {
                         std::lock_guard<std::mutex>
                             lock(_timingMutex);
 
+                        if (_phaseGroup != nullptr) {
+                            return false;
+                        }
+
                         _iterationPeriodNanoseconds =
                             nanoseconds;
 
+                        _effectivePeriodNanoseconds =
+                            nanoseconds;
+
+                        _resetGovernorWindowLocked();
+
                         if (
                             nanoseconds > 0 &&
                             _desiredIterationPeriodNanoseconds >
@@ -750,6 +1617,8 @@ namespace ESPressio {
                     }
 
                     _signalScheduler();
+
+                    return true;
                 }
 
 
@@ -758,7 +1627,7 @@ namespace ESPressio {
                     Units::UnitOrderOfMagnitude
                         TMagnitude
                 >
-                void SetIterationPeriod(
+                bool SetIterationPeriod(
                     const Units::Time<
                         TValue,
                         TMagnitude
@@ -782,7 +1651,7 @@ namespace ESPressio {
                             Units::Nano
                         );
 
-                    SetIterationPeriod(
+                    return SetIterationPeriod(
                         Timing::TimeTraits<
                             IterationTime
                         >::template FromNanoseconds<
@@ -830,6 +1699,16 @@ namespace ESPressio {
 
                     _desiredIterationPeriodNanoseconds =
                         nanoseconds;
+
+                    // The governor may not stretch beyond the new ceiling.
+                    _effectivePeriodNanoseconds =
+                        std::max(
+                            std::min(
+                                _effectivePeriodNanoseconds,
+                                nanoseconds
+                            ),
+                            _iterationPeriodNanoseconds
+                        );
                 }
 
 
@@ -875,13 +1754,58 @@ namespace ESPressio {
                 }
 
 
+                /// The period being scheduled: the iteration period, or
+                /// longer while the governor has stretched it.
+                IterationTime
+                GetEffectiveIterationPeriod() const {
+                    std::lock_guard<std::mutex>
+                        lock(_timingMutex);
+
+                    return
+                        _fromNanoseconds(
+                            _effectivePeriodNanoseconds
+                        );
+                }
+
+
+                PrecisionThreadGovernorConfiguration
+                GetPeriodGovernor() const {
+                    std::lock_guard<std::mutex>
+                        lock(_timingMutex);
+
+                    return _governor;
+                }
+
+
+                /// Configures the period governor, which adapts the period
+                /// between the iteration period and the desired iteration
+                /// period. Disabling it restores the iteration period.
+                void SetPeriodGovernor(
+                    const PrecisionThreadGovernorConfiguration& governor
+                ) {
+                    std::lock_guard<std::mutex>
+                        lock(_timingMutex);
+
+                    _governor = governor;
+
+                    if (!_governor.Enabled) {
+                        _effectivePeriodNanoseconds =
+                            _iterationPeriodNanoseconds;
+                    }
+
+                    _resetGovernorWindowLocked();
+                }
+
+
                 uint32_t
                 GetIterationSampleCount() const {
                     std::lock_guard<std::mutex>
                         lock(_timingMutex);
 
                     return
-                        _iterationSampleCount;
+                        _measurements != nullptr
+                            ? _measurements->SampleCount
+                            : 0;
                 }
 
 
@@ -891,16 +1815,20 @@ namespace ESPressio {
                     std::lock_guard<std::mutex>
                         lock(_timingMutex);
 
-                    _iterationSampleCount =
+                    if (_measurements == nullptr) {
+                        return;
+                    }
+
+                    _measurements->SampleCount =
                         sampleCount;
 
                     std::deque<uint64_t>().swap(
-                        _iterationSamples
+                        _measurements->Samples
                     );
 
-                    _iterationFrequency = 0.0;
+                    _measurements->Frequency = 0.0;
 
-                    _averageIterationFrequency =
+                    _measurements->AverageFrequency =
                         0.0;
                 }
 
@@ -913,7 +1841,9 @@ namespace ESPressio {
                     return
                         RepresentationTraits::
                             CreateIterationFrequency(
-                                _iterationFrequency
+                                _measurements != nullptr
+                                    ? _measurements->Frequency
+                                    : 0.0
                             );
                 }
 
@@ -926,11 +1856,37 @@ namespace ESPressio {
                     return
                         RepresentationTraits::
                             CreateIterationFrequency(
-                                _averageIterationFrequency
+                                _measurements != nullptr
+                                    ? _measurements->AverageFrequency
+                                    : 0.0
                             );
                 }
 
 
+                /// Jitter, execution time, overruns and skipped iterations
+                /// since the measurements were last reset.
+                PrecisionThreadTimingStatistics
+                GetTimingStatistics() const {
+                    std::lock_guard<std::mutex>
+                        lock(_timingMutex);
+
+                    return
+                        _measurements != nullptr
+                            ? _measurements->Timing.Get()
+                            : PrecisionThreadTimingStatistics{};
+                }
+
+
+                /// Clears the iteration frequency and timing statistics. An
+                /// iteration in progress is left out of both.
+                void ResetMeasurements() {
+                    std::lock_guard<std::mutex>
+                        lock(_timingMutex);
+
+                    _resetMeasurementsLocked();
+                }
+
+
                 SignedIterationTime
                 GetAvailableIterationTime() const {
                     const uint64_t now =
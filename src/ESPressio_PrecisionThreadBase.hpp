@@ -0,0 +1,204 @@
+#pragma once
+
+#include <type_traits>
+
+#include "ESPressio_PrecisionThread.hpp"
+#include "ESPressio_ThreadBase.hpp"
+
+namespace ESPressio {
+
+    namespace Threads {
+
+        namespace ThreadPolicy {
+
+            // Selects the public time representation of a
+            // PrecisionThreadBase, as the template arguments of
+            // PrecisionThread do.
+            template <
+                typename TTime,
+                typename TRepresentationTraits =
+                    PrecisionThreadTraits<TTime>
+            >
+            struct IterationTime {};
+
+        }
+
+
+        template <typename... TPolicies>
+        struct PrecisionThreadBaseType {
+            using Type = PrecisionThread<>;
+        };
+
+        template <
+            typename TTime,
+            typename TRepresentationTraits,
+            typename... TPolicies
+        >
+        struct PrecisionThreadBaseType<
+            ThreadPolicy::IterationTime<
+                TTime,
+                TRepresentationTraits
+            >,
+            TPolicies...
+        > {
+            using Type =
+                PrecisionThread<
+                    TTime,
+                    TRepresentationTraits
+                >;
+        };
+
+        template <
+            typename TPolicy,
+            typename... TPolicies
+        >
+        struct PrecisionThreadBaseType<
+            TPolicy,
+            TPolicies...
+        > :
+            PrecisionThreadBaseType<TPolicies...> {};
+
+
+        /*
+         * Statically dispatched PrecisionThread.
+         *
+         * Scheduling is unchanged, but the scheduler keeps control across
+         * iterations while Running and calls `TDerived::Iterate()` without
+         * virtual dispatch. `ThreadPolicy::NoObservers` removes iteration
+         * observer notification and RegisterIterationObserver(), so the
+         * observable is never allocated. `ThreadPolicy::NoMeasurements`
+         * removes iteration-time sampling and timing statistics together
+         * with their storage; the frequency and statistics getters then
+         * report zero.
+         *
+         *   class Controller :
+         *       public PrecisionThreadBase<
+         *           Controller,
+         *           ThreadPolicy::NoObservers
+         *       > {
+         *       public:
+         *           void Iterate(
+         *               IterationTime delta,
+         *               IterationTime startTime,
+         *               SkippedIterationCount skippedIterations
+         *           ) override { ... }
+         *   };
+         *
+         * As with ThreadBase, `Iterate()` must be accessible to the base.
+         */
+        template <
+            typename TDerived,
+            typename... TPolicies
+        >
+        class PrecisionThreadBase :
+            public PrecisionThreadBaseType<
+                TPolicies...
+            >::Type {
+
+            public:
+                using BaseType =
+                    typename PrecisionThreadBaseType<
+                        TPolicies...
+                    >::Type;
+
+                using typename BaseType::ClockType;
+                using typename BaseType::IterationTime;
+                using typename BaseType::RepresentationTraits;
+
+                static constexpr bool ObserversEnabled =
+                    !HasThreadPolicy<
+                        ThreadPolicy::NoObservers,
+                        TPolicies...
+                    >::value;
+
+                static constexpr bool MeasurementsEnabled =
+                    !HasThreadPolicy<
+                        ThreadPolicy::NoMeasurements,
+                        TPolicies...
+                    >::value;
+
+
+            protected:
+                void OnSchedule() final override {
+                    TDerived& derived =
+                        static_cast<TDerived&>(
+                            *this
+                        );
+
+                    do {
+                        const typename BaseType::LoopSample sample =
+                            this->BeginLoopSample();
+
+                        this->template ScheduleStep<
+                            ObserversEnabled,
+                            MeasurementsEnabled
+                        >(
+                            [&derived](
+                                IterationTime delta,
+                                IterationTime startTime,
+                                SkippedIterationCount skippedIterations
+                            ) {
+                                derived.TDerived::Iterate(
+                                    delta,
+                                    startTime,
+                                    skippedIterations
+                                );
+                            }
+                        );
+
+                        this->EndLoopSample(
+                            sample
+                        );
+                    } while (
+                        this->ContinueLoop()
+                    );
+                }
+
+
+            public:
+                explicit PrecisionThreadBase(
+                    ClockType* clock = nullptr
+                ) :
+                    BaseType(
+                        false,
+                        clock,
+                        MeasurementsEnabled
+                    ) {
+                }
+
+
+                PrecisionThreadBase(
+                    bool freeOnTerminate,
+                    ClockType* clock = nullptr
+                ) :
+                    BaseType(
+                        freeOnTerminate,
+                        clock,
+                        MeasurementsEnabled
+                    ) {
+                }
+
+
+                template <
+                    bool TObserversEnabled = ObserversEnabled
+                >
+                std::enable_if_t<
+                    TObserversEnabled,
+                    Observable::ObserverHandlePtr
+                >
+                RegisterIterationObserver(
+                    IPrecisionThreadObserver<
+                        IterationTime,
+                        RepresentationTraits
+                    >* observer
+                ) {
+                    return
+                        BaseType::RegisterIterationObserver(
+                            observer
+                        );
+                }
+        };
+
+    }
+
+}
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "ESPressio_PrecisionThread.hpp"
+
+namespace ESPressio {
+
+    namespace Threads {
+
+        /*
+         * Runs PrecisionThreads in lockstep, or at fixed phase offsets from
+         * one another.
+         *
+         * Every member schedules its slots from the group's epoch and
+         * period: member slots lie at epoch + phaseOffset + k * period. As
+         * no member keeps a free-running deadline of its own, members cannot
+         * drift apart, and a pipeline such as "sample, then filter 200 us
+         * later, then publish" stays aligned without any synchronisation
+         * between the threads.
+         *
+         * The group sets each member's iteration period, and a member's own
+         * SetIterationPeriod() is refused while it belongs to the group.
+         * Members must share the group's clock, as their slots are computed
+         * from its epoch. The period governor is suspended for members, and
+         * Coalesce catch-up resumes on the grid instead of from the current
+         * time. A member destroyed while in a group leaves it; the group
+         * must outlive its members or remove them first.
+         */
+        template<
+            typename TTime = Timing::DefaultClockTime,
+            typename TRepresentationTraits =
+                PrecisionThreadTraits<TTime>
+        >
+        class PrecisionThreadGroup {
+            public:
+                using ThreadType =
+                    PrecisionThread<
+                        TTime,
+                        TRepresentationTraits
+                    >;
+
+                using IterationTime =
+                    typename ThreadType::IterationTime;
+
+                using ClockType =
+                    typename ThreadType::ClockType;
+
+            private:
+                struct Member {
+                    ThreadType* Thread;
+                    uint64_t PhaseOffsetNanoseconds;
+                };
+
+                ClockType* _clock;
+
+                mutable std::mutex _mutex;
+
+                std::vector<Member> _members;
+
+                IterationTime _period{};
+
+                uint64_t _periodNanoseconds = 0;
+                uint64_t _epochNanoseconds = 0;
+
+
+                static void _leave(
+                    PrecisionThreadGroup* group,
+                    ThreadType* thread
+                ) {
+                    group->Remove(
+                        thread
+                    );
+                }
+
+
+                // Hands the group's grid to `member`, which then restarts
+                // its schedule on it.
+                void _applyLocked(
+                    const Member& member
+                ) {
+                    {
+                        std::lock_guard<std::mutex>
+                            lock(member.Thread->_timingMutex);
+
+                        member.Thread->_phaseGroup =
+                            this;
+
+                        member.Thread->_leavePhaseGroup =
+                            _leave;
+
+                        member.Thread->_phaseEpochNanoseconds =
+                            _epochNanoseconds;
+
+                        member.Thread->_phaseOffsetNanoseconds =
+                            member.PhaseOffsetNanoseconds;
+
+                        member.Thread->_iterationPeriodNanoseconds =
+                            _periodNanoseconds;
+
+                        member.Thread->_effectivePeriodNanoseconds =
+                            _periodNanoseconds;
+
+                        member.Thread->_resetGovernorWindowLocked();
+
+                        member.Thread->_scheduleInitialized =
+                            false;
+                    }
+
+                    member.Thread->_signalScheduler();
+                }
+
+
+                static void _release(
+                    ThreadType* thread
+                ) {
+                    {
+                        std::lock_guard<std::mutex>
+                            lock(thread->_timingMutex);
+
+                        thread->_phaseGroup = nullptr;
+                        thread->_leavePhaseGroup = nullptr;
+
+                        thread->_scheduleInitialized =
+                            false;
+                    }
+
+                    thread->_signalScheduler();
+                }
+
+
+                template<
+                    typename TValue,
+                    Units::UnitOrderOfMagnitude
+                        TMagnitude
+                >
+                static IterationTime _toIterationTime(
+                    const Units::Time<
+                        TValue,
+                        TMagnitude
+                    >& time
+                ) {
+                    static_assert(
+                        std::is_integral<
+                            TValue
+                        >::value &&
+                        std::is_unsigned<
+                            TValue
+                        >::value,
+                        "Group periods and offsets require an unsigned "
+                        "integral ESPressio Time value"
+                    );
+
+                    return
+                        Timing::TimeTraits<
+                            IterationTime
+                        >::template FromNanoseconds<
+                            uint64_t
+                        >(
+                            time.template ToMagnitude<
+                                uint64_t
+                            >(
+                                Units::Nano
+                            ),
+                            1
+                        );
+                }
+
+
+                typename std::vector<Member>::iterator
+                _findLocked(
+                    ThreadType* thread
+                ) {
+                    return
+                        std::find_if(
+                            _members.begin(),
+                            _members.end(),
+                            [thread](
+                                const Member& member
+                            ) {
+                                return member.Thread == thread;
+                            }
+                        );
+                }
+
+
+            public:
+                explicit PrecisionThreadGroup(
+                    ClockType* clock = nullptr
+                ) :
+                    _clock(
+                        clock == nullptr
+                            ? &Timing::SystemClock<
+                                IterationTime
+                              >::GetInstance()
+                            : clock
+                    ) {
+                    _epochNanoseconds =
+                        ThreadType::_toNanoseconds(
+                            _clock->GetTime()
+                        );
+                }
+
+
+                PrecisionThreadGroup(
+                    const PrecisionThreadGroup&
+                ) = delete;
+
+
+                PrecisionThreadGroup&
+                operator=(
+                    const PrecisionThreadGroup&
+                ) = delete;
+
+
+                ~PrecisionThreadGroup() {
+                    std::lock_guard<std::mutex>
+                        lock(_mutex);
+
+                    for (
+                        const Member& member :
+                        _members
+                    ) {
+                        _release(
+                            member.Thread
+                        );
+                    }
+
+                    _members.clear();
+                }
+
+
+                /// Adds `thread`, or moves it to a new offset if it is
+                /// already a member. Returns `false` when it belongs to
+                /// another group or schedules against a different clock.
+                bool Add(
+                    ThreadType* thread,
+                    IterationTime phaseOffset
+                ) {
+                    if (
+                        thread == nullptr ||
+                        thread->GetClock() != _clock
+                    ) {
+                        return false;
+                    }
+
+                    std::lock_guard<std::mutex>
+                        lock(_mutex);
+
+                    {
+                        std::lock_guard<std::mutex>
+                            threadLock(thread->_timingMutex);
+
+                        if (
+                            thread->_phaseGroup != nullptr &&
+                            thread->_phaseGroup != this
+                        ) {
+                            return false;
+                        }
+                    }
+
+                    const uint64_t offset =
+                        ThreadType::_toNanoseconds(
+                            phaseOffset
+                        );
+
+                    auto existing =
+                        _findLocked(
+                            thread
+                        );
+
+                    if (existing != _members.end()) {
+                        existing->PhaseOffsetNanoseconds =
+                            offset;
+
+                        _applyLocked(
+                            *existing
+                        );
+
+                        return true;
+                    }
+
+                    _members.push_back({
+                        thread,
+                        offset
+                    });
+
+                    _applyLocked(
+                        _members.back()
+                    );
+
+                    return true;
+                }
+
+
+                template<
+                    typename TValue,
+                    Units::UnitOrderOfMagnitude
+                        TMagnitude
+                >
+                bool Add(
+                    ThreadType* thread,
+                    const Units::Time<
+                        TValue,
+                        TMagnitude
+                    >& phaseOffset
+                ) {
+                    return
+                        Add(
+                            thread,
+                            _toIterationTime(
+                                phaseOffset
+                            )
+                        );
+                }
+
+
+                /// Releases `thread`, which keeps the group's period but
+                /// restarts its own schedule.
+                bool Remove(
+                    ThreadType* thread
+                ) {
+                    std::lock_guard<std::mutex>
+                        lock(_mutex);
+
+                    auto existing =
+                        _findLocked(
+                            thread
+                        );
+
+                    if (existing == _members.end()) {
+                        return false;
+                    }
+
+                    _members.erase(
+                        existing
+                    );
+
+                    _release(
+                        thread
+                    );
+
+                    return true;
+                }
+
+
+                std::size_t GetMemberCount() const {
+                    std::lock_guard<std::mutex>
+                        lock(_mutex);
+
+                    return _members.size();
+                }
+
+
+                IterationTime GetPeriod() const {
+                    std::lock_guard<std::mutex>
+                        lock(_mutex);
+
+                    return _period;
+                }
+
+
+                /// Sets every member's period and restarts the grid from
+                /// now. Zero runs the members unlimited and unaligned.
+                void SetPeriod(
+                    IterationTime period
+                ) {
+                    std::lock_guard<std::mutex>
+                        lock(_mutex);
+
+                    _period = period;
+
+                    _periodNanoseconds =
+                        ThreadType::_toNanoseconds(
+                            period
+                        );
+
+                    _epochNanoseconds =
+                        ThreadType::_toNanoseconds(
+                            _clock->GetTime()
+                        );
+
+                    for (
+                        const Member& member :
+                        _members
+                    ) {
+                        _applyLocked(
+                            member
+                        );
+                    }
+                }
+
+
+                template<
+                    typename TValue,
+                    Units::UnitOrderOfMagnitude
+                        TMagnitude
+                >
+                void SetPeriod(
+                    const Units::Time<
+                        TValue,
+                        TMagnitude
+                    >& period
+                ) {
+                    SetPeriod(
+                        _toIterationTime(
+                            period
+                        )
+                    );
+                }
+
+
+                /// Restarts the grid from now, for instance after members
+                /// were paused.
+                void Realign() {
+                    std::lock_guard<std::mutex>
+                        lock(_mutex);
+
+                    _epochNanoseconds =
+                        ThreadType::_toNanoseconds(
+                            _clock->GetTime()
+                        );
+
+                    for (
+                        const Member& member :
+                        _members
+                    ) {
+                        _applyLocked(
+                            member
+                        );
+                    }
+                }
+        };
+
+    }
+
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "ESPressio_ThreadMetrics.hpp"
+
+// define as 0 to drop the percentile histograms from every PrecisionThread,
+// saving about 1.1 KB each with the default histogram layout. Percentiles
+// then read as 0.
+#ifndef ESPRESSIO_THREAD_PRECISION_PERCENTILES
+    #define ESPRESSIO_THREAD_PRECISION_PERCENTILES 1
+#endif
+
+namespace ESPressio {
+
+    namespace Threads {
+
+        /// Summary of one measured quantity, in nanoseconds.
+        struct PrecisionThreadDistribution {
+            uint64_t Count = 0;
+
+            // Meaningful only when Count > 0.
+            uint64_t Minimum = 0;
+            uint64_t Maximum = 0;
+
+            double Mean = 0.0;
+            double StandardDeviation = 0.0;
+
+            // To ESPRESSIO_THREAD_METRICS_HISTOGRAM_PRECISION_BITS; 0 without
+            // ESPRESSIO_THREAD_PRECISION_PERCENTILES.
+            uint64_t Percentile50 = 0;
+            uint64_t Percentile99 = 0;
+            uint64_t Percentile999 = 0;
+        };
+
+
+        /// Returned by PrecisionThread::GetTimingStatistics().
+        struct PrecisionThreadTimingStatistics {
+            uint64_t Iterations = 0;
+
+            // Iterations still running when the next one was due.
+            uint64_t Overruns = 0;
+
+            // Sum of every skippedIterations passed to Iterate().
+            uint64_t SkippedIterations = 0;
+
+            // How late each iteration started against its scheduled slot.
+            // Only iterations with a period set are counted.
+            PrecisionThreadDistribution Jitter;
+
+            // Time spent in Iterate().
+            PrecisionThreadDistribution ExecutionTime;
+        };
+
+
+        /*
+         * Incremental summary of a stream of values in fixed memory. Mean
+         * and variance use Welford's method, so no sample is kept; the
+         * percentiles come from a ThreadMetricHistogram-layout bucket
+         * array. Not thread-safe: PrecisionThread guards it with its
+         * timing mutex.
+         */
+        class PrecisionThreadDistributionAccumulator {
+            private:
+                uint64_t _count = 0;
+                uint64_t _minimum = 0;
+                uint64_t _maximum = 0;
+
+                double _mean = 0.0;
+                double _squaredDeviations = 0.0;
+
+                #if ESPRESSIO_THREAD_PRECISION_PERCENTILES
+                    ThreadMetricHistogramSnapshot _histogram;
+                #endif
+
+            public:
+                void Record(
+                    uint64_t value
+                ) {
+                    ++_count;
+
+                    if (
+                        _count == 1 ||
+                        value < _minimum
+                    ) {
+                        _minimum = value;
+                    }
+
+                    if (value > _maximum) {
+                        _maximum = value;
+                    }
+
+                    const double sample =
+                        static_cast<double>(value);
+
+                    const double deviation =
+                        sample - _mean;
+
+                    _mean +=
+                        deviation /
+                        static_cast<double>(_count);
+
+                    _squaredDeviations +=
+                        deviation *
+                        (sample - _mean);
+
+                    #if ESPRESSIO_THREAD_PRECISION_PERCENTILES
+                        ++_histogram.Buckets[
+                            ThreadMetricHistogramLayout::GetBucketIndex(
+                                value
+                            )
+                        ];
+
+                        _histogram.Count = _count;
+                        _histogram.Minimum = _minimum;
+                        _histogram.Maximum = _maximum;
+                    #endif
+                }
+
+
+                void Reset() {
+                    *this =
+                        PrecisionThreadDistributionAccumulator();
+                }
+
+
+                PrecisionThreadDistribution Get() const {
+                    PrecisionThreadDistribution distribution;
+
+                    distribution.Count = _count;
+
+                    if (_count == 0) {
+                        return distribution;
+                    }
+
+                    distribution.Minimum = _minimum;
+                    distribution.Maximum = _maximum;
+                    distribution.Mean = _mean;
+
+                    distribution.StandardDeviation =
+                        std::sqrt(
+                            _squaredDeviations /
+                            static_cast<double>(_count)
+                        );
+
+                    #if ESPRESSIO_THREAD_PRECISION_PERCENTILES
+                        distribution.Percentile50 =
+                            _histogram.GetPercentile(0.5);
+
+                        distribution.Percentile99 =
+                            _histogram.GetPercentile(0.99);
+
+                        distribution.Percentile999 =
+                            _histogram.GetPercentile(0.999);
+                    #endif
+
+                    return distribution;
+                }
+        };
+
+
+        /// Iteration timing of one PrecisionThread.
+        class PrecisionThreadTimingAccumulator {
+            private:
+                uint64_t _iterations = 0;
+                uint64_t _overruns = 0;
+                uint64_t _skippedIterations = 0;
+
+                PrecisionThreadDistributionAccumulator _jitter;
+                PrecisionThreadDistributionAccumulator _executionTime;
+
+            public:
+                /// Records one iteration. `scheduled` is false while no
+                /// period is set, when there is no slot to be late for.
+                void Record(
+                    bool scheduled,
+                    uint64_t lateNanoseconds,
+                    uint64_t executionNanoseconds,
+                    uint64_t skippedIterations,
+                    bool overran
+                ) {
+                    ++_iterations;
+
+                    if (overran) {
+                        ++_overruns;
+                    }
+
+                    _skippedIterations +=
+                        skippedIterations;
+
+                    if (scheduled) {
+                        _jitter.Record(
+                            lateNanoseconds
+                        );
+                    }
+
+                    _executionTime.Record(
+                        executionNanoseconds
+                    );
+                }
+
+
+                void Reset() {
+                    _iterations = 0;
+                    _overruns = 0;
+                    _skippedIterations = 0;
+
+                    _jitter.Reset();
+                    _executionTime.Reset();
+                }
+
+
+                PrecisionThreadTimingStatistics Get() const {
+                    PrecisionThreadTimingStatistics statistics;
+
+                    statistics.Iterations = _iterations;
+                    statistics.Overruns = _overruns;
+                    statistics.SkippedIterations = _skippedIterations;
+                    statistics.Jitter = _jitter.Get();
+                    statistics.ExecutionTime = _executionTime.Get();
+
+                    return statistics;
+                }
+        };
+
+    }
+
+}
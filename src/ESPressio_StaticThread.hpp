@@ -0,0 +1,109 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <cstdint>
+
+#include "ESPressio_StaticThreadTypes.hpp"
+#include "ESPressio_Thread.hpp"
+
+namespace ESPressio {
+namespace Threads {
+
+    /*
+     * Embedded storage for StaticThread.
+     *
+     * Kept as the first base so the buffers are constructed before Thread
+     * creates its exit semaphore in them, and destroyed after Thread has
+     * deleted the task that runs on them.
+     */
+    template <uint32_t TStackDepth>
+    class StaticThreadStorage :
+        public StaticThreadBuffers {
+
+        private:
+            StackType_t _stack[TStackDepth];
+
+        public:
+            StaticThreadStorage() {
+                Stack = _stack;
+                StackDepth = TStackDepth;
+            }
+
+            StaticThreadStorage(
+                const StaticThreadStorage&
+            ) = delete;
+
+            StaticThreadStorage& operator=(
+                const StaticThreadStorage&
+            ) = delete;
+    };
+
+
+    /*
+     * A Thread whose FreeRTOS stack, TCB and exit semaphore are embedded in
+     * the object, created with xTaskCreateStaticPinnedToCore().
+     *
+     * `TStackDepth` is in `StackType_t` units, the same unit `SetStackSize()`
+     * takes on the target (bytes on ESP-IDF). The stack size is fixed at
+     * compile time; `SetStackSize()` is ignored. Place instances in static
+     * storage to keep them out of the heap entirely.
+     *
+     * The task is created on the first Initialize() and, since its memory
+     * belongs to this object, is never deleted by its own exit: it parks and
+     * is reused by the next Initialize() on the same core. It is never
+     * offered to the shared task pool. FreeOnTerminate is not supported,
+     * since the collector would `delete` the object.
+     */
+    template <uint32_t TStackDepth>
+    class StaticThread :
+        private StaticThreadStorage<TStackDepth>,
+        public Thread {
+
+        #if defined(configMINIMAL_STACK_SIZE)
+            static_assert(
+                TStackDepth >= configMINIMAL_STACK_SIZE,
+                "StaticThread stack depth is below configMINIMAL_STACK_SIZE"
+            );
+        #endif
+
+        public:
+            StaticThread() :
+                StaticThreadStorage<TStackDepth>(),
+                Thread(
+                    static_cast<StaticThreadBuffers*>(
+                        this
+                    )
+                ) {
+
+                Thread::SetStackSize(
+                    TStackDepth
+                );
+            }
+
+
+            uint32_t GetStackSize() override {
+                return TStackDepth;
+            }
+
+
+            void SetStackSize(
+                uint32_t
+            ) override {
+            }
+
+
+            /// Always false: the collector would `delete` storage this
+            /// object does not own, such as a static or placement instance.
+            void SetFreeOnTerminate(
+                bool
+            ) override {
+                Thread::SetFreeOnTerminate(
+                    false
+                );
+            }
+    };
+
+}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace ESPressio {
+namespace Threads {
+
+    /*
+     * Caller-owned storage for a statically allocated Thread.
+     *
+     * The stack, TCB and exit semaphore live inside the owning object, so the
+     * FreeRTOS task must never outlive it. A static task therefore does not
+     * delete itself when its loop exits: it reports the exit, disarms its TLS
+     * slot and parks on its gate notification. The owning Thread reuses it
+     * on the next Initialize() and deletes it, while parked, on destruction.
+     */
+    struct StaticThreadBuffers {
+        StaticTask_t TaskBuffer;
+        StaticSemaphore_t ExitSignalBuffer;
+
+        StackType_t* Stack = nullptr;
+        uint32_t StackDepth = 0;
+
+        TaskHandle_t Task = nullptr;
+        int CoreID = 0;
+
+        std::atomic<bool> Parked{
+            false
+        };
+    };
+
+}
+}
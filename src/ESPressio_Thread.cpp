@@ -7,12 +7,31 @@ namespace ESPressio {
 
     namespace Threads {
         // Define the Constructor and Destructor of `Thread` here
-        Thread::Thread() : _threadID(0) {
+        Thread::Thread() :
+            Thread(
+                static_cast<StaticThreadBuffers*>(
+                    nullptr
+                )
+            ) {
+        }
+
+        Thread::Thread(
+            StaticThreadBuffers* staticBuffers
+        ) :
+            _threadID(0),
+            _taskExited(
+                staticBuffers != nullptr
+                    ? xSemaphoreCreateBinaryStatic(
+                        &staticBuffers->ExitSignalBuffer
+                    )
+                    : xSemaphoreCreateBinary()
+            ),
+            _staticBuffers(staticBuffers) {
             try {
-                _lifecycleObservable =
-                    std::make_shared<LifecycleObservable>();
-                SetCoreID(
-                    ThreadManager::GetInstance()->AddThread(this, &_threadID)
+                // The initial core is a default; SetCoreID() pins one.
+                _configuration.CoreID.store(
+                    ThreadManager::GetInstance()->AddThread(this, &_threadID),
+                    std::memory_order_release
                 );
             } catch (...) {
                 const std::exception_ptr constructionFailure =
@@ -33,7 +52,14 @@ namespace ESPressio {
         }
         Thread::~Thread() {
             SetFreeOnTerminate(false);
+            // First, so the manager's sampler and rebalancer are done with
+            // this Thread before any of it is torn down.
+            ThreadManager::GetInstance()->RemoveThread(this);
             _waitForTerminationDispatch();
+            FlushObserverEvents();
+            // Destroyed by an observer on the dispatcher task, the event in
+            // delivery must not complete against this object.
+            ObserverDispatcher::GetInstance()->SourceDestroyed(this);
             SetThreadState(ThreadState::Destroyed);
             TOnThreadEvent onDestroy = GetOnDestroy();
             if (onDestroy != nullptr) {
@@ -45,25 +71,61 @@ namespace ESPressio {
                 }
             }
             _deleteTask();
+            _releaseStaticTask();
             if (_taskExited != nullptr) {
                 vSemaphoreDelete(_taskExited);
                 _taskExited = nullptr;
             }
-            ThreadManager::GetInstance()->RemoveThread(this);
         }
         void Thread::_requestGarbageCollection() {
             ThreadGarbageCollector::GetInstance()->CleanUp();
         }
 
-        bool Thread::_isTerminationDispatcherAvailable() {
-            return ThreadTerminationDispatcher::GetInstance()->IsAvailable();
+        bool Thread::_isTerminationDispatcherAvailable(int coreID) {
+            return ThreadTerminationDispatcher::GetInstance(coreID)->EnsureStarted();
+        }
+
+        void Thread::_placeOnInitialize() {
+            const ThreadState state = GetThreadState();
+
+            if (
+                state != ThreadState::Uninitialized &&
+                state != ThreadState::Terminated
+            ) {
+                return;
+            }
+
+            // A migration requested during the previous run is stale.
+            _configuration.MigrationCoreID.store(
+                -1,
+                std::memory_order_release
+            );
+
+            const int coreID =
+                ThreadManager::GetInstance()->PlaceThread(this);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (
+                _taskHandle.load(std::memory_order_acquire) == nullptr &&
+                !_configuration.CoreIDPinned.load(std::memory_order_acquire)
+            ) {
+                _configuration.CoreID.store(
+                    coreID,
+                    std::memory_order_release
+                );
+            }
         }
 
         bool Thread::_isCurrentTerminationDispatcherTask() {
-            return ThreadTerminationDispatcher::GetInstance()->IsCurrentTask();
+            // Waiting on another core's dispatcher from a dispatcher task
+            // could deadlock two dispatchers against each other.
+            return ThreadTerminationDispatcher::IsAnyDispatcherTask();
         }
         bool Thread::_queueTerminationDispatch(Thread* thread) {
-            return ThreadTerminationDispatcher::GetInstance()->Dispatch(thread);
+            return ThreadTerminationDispatcher::GetInstance(
+                thread->GetCoreID()
+            )->Dispatch(thread);
         }
 
         void Thread::_dispatchTermination() {
@@ -80,7 +142,15 @@ namespace ESPressio {
             }
             if (terminated) {
                 try {
-                    _lifecycleObservable->NotifyTaskExited(this);
+                    LifecycleObservable* observable =
+                        _getLifecycleObservable();
+
+                    if (
+                        observable != nullptr &&
+                        !_queueLifecycleEvent(LifecycleEvent::TaskExited)
+                    ) {
+                        observable->NotifyTaskExited(this);
+                    }
                 } catch (...) {
                     // Observer failures must not terminate the dispatcher.
                 }
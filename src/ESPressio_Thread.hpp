@@ -4,21 +4,56 @@
 #include "freertos/semphr.h"
 #include "freertos/task.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <ctime>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 
+#if defined(__linux__)
+    #include <sys/resource.h>
+#endif
+
 #include "ESPressio_IThread.hpp"
 #include "ESPressio_IThreadObserver.hpp"
+#include "ESPressio_ObserverDispatcher.hpp"
 #include "ESPressio_ThreadSafe.hpp"
+#include "ESPressio_StaticThreadTypes.hpp"
 #include "ESPressio_ThreadSafeObservable.hpp"
+#include "ESPressio_ThreadTaskPool.hpp"
+#include "ESPressio_ThreadTerminationDispatcherTypes.hpp"
+#include "ESPressio_ThreadMetrics.hpp"
+#include "ESPressio_ThreadTrace.hpp"
 
 #ifndef ESPRESSIO_THREAD_DEFAULT_STACK_SIZE
     #define ESPRESSIO_THREAD_DEFAULT_STACK_SIZE 4000
 #endif
 
+// define as 1 to keep per-Thread CPU, state and context-switch accounting,
+// reported through GetRuntimeStatistics() and ThreadManager snapshots.
+#ifndef ESPRESSIO_THREAD_RUNTIME_STATISTICS
+    #define ESPRESSIO_THREAD_RUNTIME_STATISTICS 0
+#endif
+
+// Nanoseconds per FreeRTOS run-time stats counter tick (ESP-IDF counts
+// microseconds by default).
+#ifndef ESPRESSIO_THREAD_RUN_TIME_COUNTER_NANOSECONDS
+    #define ESPRESSIO_THREAD_RUN_TIME_COUNTER_NANOSECONDS 1000
+#endif
+
+// Stack suggestions add the larger of this margin (in SetStackSize() units)
+// and ESPRESSIO_THREAD_STACK_MARGIN_PERCENT of the peak usage.
+#ifndef ESPRESSIO_THREAD_STACK_MARGIN
+    #define ESPRESSIO_THREAD_STACK_MARGIN 512
+#endif
+
+#ifndef ESPRESSIO_THREAD_STACK_MARGIN_PERCENT
+    #define ESPRESSIO_THREAD_STACK_MARGIN_PERCENT 25
+#endif
+
 #ifndef ESPRESSIO_THREAD_TLS_INDEX
     #define ESPRESSIO_THREAD_TLS_INDEX 0
 #endif
@@ -46,10 +81,25 @@ namespace ESPressio {
                     public Observable::ThreadSafeObservable {
 
                     private:
+                        ObserverInterestTable<
+                            IThreadObserver
+                        > _interests;
+
+
                         template <typename TNotification>
                         void _notify(
+                            ThreadObserverEvents event,
                             TNotification notification
                         ) {
+                            if (!_interests.IsAnyInterested(event)) {
+                                return;
+                            }
+
+                            ObserverInterestTable<
+                                IThreadObserver
+                            >::Filter filter =
+                                _interests.GetFilter();
+
                             ExecuteNotification(
                                 [&](
                                     NotificationContext&
@@ -62,6 +112,15 @@ namespace ESPressio {
                                             IThreadObserver*
                                                 observer
                                         ) {
+                                            if (
+                                                !filter.Accepts(
+                                                    observer,
+                                                    event
+                                                )
+                                            ) {
+                                                return;
+                                            }
+
                                             try {
                                                 notification(
                                                     observer
@@ -75,11 +134,92 @@ namespace ESPressio {
                         }
 
                     public:
+                        static ThreadObserverEvents StateEvent(
+                            ThreadState state
+                        ) {
+                            switch (state) {
+                                case ThreadState::Uninitialized:
+                                    return ThreadObserverEvent::Uninitialized;
+
+                                case ThreadState::Initialized:
+                                    return ThreadObserverEvent::Initialized;
+
+                                case ThreadState::Running:
+                                    return ThreadObserverEvent::Started;
+
+                                case ThreadState::Paused:
+                                    return ThreadObserverEvent::Paused;
+
+                                case ThreadState::Terminating:
+                                    return ThreadObserverEvent::TerminationRequested;
+
+                                case ThreadState::Terminated:
+                                    return ThreadObserverEvent::Terminated;
+
+                                case ThreadState::Destroyed:
+                                    return ThreadObserverEvent::Destroyed;
+                            }
+
+                            return 0;
+                        }
+
+
+                        bool IsInterested(
+                            ThreadObserverEvents events
+                        ) const {
+                            return
+                                _interests.IsAnyInterested(
+                                    events
+                                );
+                        }
+
+
+                        void SetInterests(
+                            IThreadObserver* observer,
+                            ThreadObserverEvents events
+                        ) {
+                            _interests.Set(
+                                observer,
+                                events
+                            );
+                        }
+
+
+                        void RemoveInterests(
+                            IThreadObserver* observer
+                        ) {
+                            _interests.Remove(
+                                observer
+                            );
+                        }
+
+
+                        // `requireCurrentState` skips the per-state callback
+                        // once the Thread has moved on; queued deliveries
+                        // report the transition as it happened.
                         void NotifyStateChanged(
                             Thread* thread,
                             ThreadState oldState,
-                            ThreadState newState
+                            ThreadState newState,
+                            bool requireCurrentState = true
                         ) {
+                            const ThreadObserverEvents stateEvent =
+                                StateEvent(newState);
+
+                            if (
+                                !_interests.IsAnyInterested(
+                                    ThreadObserverEvent::StateChanged |
+                                    stateEvent
+                                )
+                            ) {
+                                return;
+                            }
+
+                            ObserverInterestTable<
+                                IThreadObserver
+                            >::Filter filter =
+                                _interests.GetFilter();
+
                             ExecuteNotification(
                                 [&](
                                     NotificationContext&
@@ -92,17 +232,34 @@ namespace ESPressio {
                                             IThreadObserver*
                                                 observer
                                         ) {
-                                            try {
-                                                observer->
-                                                    OnThreadStateChanged(
-                                                        thread,
-                                                        oldState,
-                                                        newState
-                                                    );
-                                            } catch (...) {
+                                            if (
+                                                filter.Accepts(
+                                                    observer,
+                                                    ThreadObserverEvent::StateChanged
+                                                )
+                                            ) {
+                                                try {
+                                                    observer->
+                                                        OnThreadStateChanged(
+                                                            thread,
+                                                            oldState,
+                                                            newState
+                                                        );
+                                                } catch (...) {
+                                                }
+                                            }
+
+                                            if (
+                                                !filter.Accepts(
+                                                    observer,
+                                                    stateEvent
+                                                )
+                                            ) {
+                                                return;
                                             }
 
                                             if (
+                                                requireCurrentState &&
                                                 thread->
                                                     GetThreadState() !=
                                                 newState
@@ -183,6 +340,7 @@ namespace ESPressio {
                             Thread* thread
                         ) {
                             _notify(
+                                ThreadObserverEvent::TaskExited,
                                 [&](IThreadObserver* observer) {
                                     observer->
                                         OnThreadTaskExited(
@@ -199,6 +357,7 @@ namespace ESPressio {
                                 status
                         ) {
                             _notify(
+                                ThreadObserverEvent::InitializationFailed,
                                 [&](IThreadObserver* observer) {
                                     observer->
                                         OnThreadInitializationFailed(
@@ -215,6 +374,7 @@ namespace ESPressio {
                             std::exception_ptr cause
                         ) {
                             _notify(
+                                ThreadObserverEvent::ExecutionFailed,
                                 [&](IThreadObserver* observer) {
                                     observer->
                                         OnThreadExecutionFailed(
@@ -265,26 +425,123 @@ namespace ESPressio {
                     >;
 
 
+                /*
+                 * Task configuration, packed into one block. Fields are read
+                 * lock-free; writes are serialized by `_mutex` so they cannot
+                 * race task creation.
+                 */
+                struct Configuration {
+                    std::atomic<uint32_t> StackSize{
+                        ESPRESSIO_THREAD_DEFAULT_STACK_SIZE
+                    };
+
+                    std::atomic<int> CoreID{
+                        0
+                    };
+
+                    // Set by SetCoreID(); placement leaves the core alone.
+                    std::atomic<bool> CoreIDPinned{
+                        false
+                    };
+
+                    // Core a running task should move to, or -1.
+                    std::atomic<int> MigrationCoreID{
+                        -1
+                    };
+
+                    std::atomic<unsigned int> Priority{
+                        2
+                    };
+
+                    std::atomic<bool> FreeOnTerminate{
+                        false
+                    };
+
+                    std::atomic<bool> StartOnInitialize{
+                        true
+                    };
+
+                    std::atomic<ObserverDelivery> Delivery{
+                        ObserverDelivery::Synchronous
+                    };
+                };
+
+
+                // Kinds of the lifecycle events a Thread queues.
+                enum class LifecycleEvent : uint8_t {
+                    StateChanged,
+                    TaskExited,
+                    InitializationFailed
+                };
+
+
+                struct Callbacks {
+                    TOnThreadEvent OnDestroy;
+                    TOnThreadEvent OnInitialize;
+                    TOnThreadEvent OnStart;
+                    TOnThreadEvent OnPause;
+                    TOnThreadEvent OnTerminate;
+                    TOnThreadEvent OnTerminated;
+                    TOnThreadInitializationFailedEvent OnInitializationFailed;
+                    TOnThreadExecutionFailedEvent OnExecutionFailed;
+                    TOnThreadStateChangeEvent OnStateChange;
+                };
+
+
                 uint8_t _threadID;
 
-                ReadWriteMutex<ThreadState>
-                    _threadState =
-                        ReadWriteMutex<ThreadState>(
-                            ThreadState::
-                                Uninitialized
-                        );
+                // Written only under `_stateTransitionMutex`; read
+                // lock-free, including by the worker loop.
+                std::atomic<ThreadState>
+                    _threadState{
+                        ThreadState::
+                            Uninitialized
+                    };
 
-                ReadWriteMutex<bool>
-                    _freeOnTerminate =
-                        ReadWriteMutex<bool>(
-                            false
-                        );
+                Configuration
+                    _configuration;
 
-                ReadWriteMutex<bool>
-                    _startOnInitialize =
-                        ReadWriteMutex<bool>(
-                            true
-                        );
+                // Peak stack usage across every task this Thread has run on.
+                std::atomic<uint32_t>
+                    _stackPeakUsed{
+                        0
+                    };
+
+                std::atomic<bool>
+                    _stackSampled{
+                        false
+                    };
+
+                // Set once this Thread runs on a recycled task, whose
+                // high-water mark includes the stack its earlier Threads used.
+                std::atomic<bool>
+                    _stackRecycled{
+                        false
+                    };
+
+                #if ESPRESSIO_THREAD_RUNTIME_STATISTICS
+                    struct RuntimeAccounting {
+                        std::atomic<uint64_t> LoopIterations{0};
+                        std::atomic<uint64_t> LoopCpuNanoseconds{0};
+                        std::atomic<uint64_t> VoluntaryContextSwitches{0};
+                        std::atomic<uint64_t> InvoluntaryContextSwitches{0};
+
+                        // Touched only by the worker task. A derived loop
+                        // that samples its own bodies (ThreadBase) nests
+                        // inside the sample taken around OnLoop(), which is
+                        // then discarded.
+                        uint32_t SampleDepth = 0;
+                        bool NestedSampleTaken = false;
+
+                        // Guarded by `_stateTransitionMutex`.
+                        uint64_t StateNanoseconds[ThreadStateCount] = {};
+                        uint64_t StateEnteredNanoseconds =
+                            _wallNanoseconds();
+                    };
+
+                    RuntimeAccounting
+                        _runtime;
+                #endif
 
                 std::atomic<TaskHandle_t>
                     _taskHandle{
@@ -312,76 +569,54 @@ namespace ESPressio {
                             Available
                     };
 
+                // Owned by the termination dispatcher while a dispatch is
+                // pending.
+                ThreadTerminationDispatchNode
+                    _terminationDispatchNode;
+
+                // Created by the constructor, statically when the Thread
+                // provides StaticThreadBuffers.
                 SemaphoreHandle_t _taskExited =
-                    xSemaphoreCreateBinary();
+                    nullptr;
 
+                // Non-null only for statically allocated Threads; owned by
+                // the derived object.
+                StaticThreadBuffers*
+                    _staticBuffers =
+                        nullptr;
+
+                // Serializes configuration writes against task creation
+                // and guards the callback table and observable creation.
                 mutable std::mutex
-                    _taskConfigurationMutex;
+                    _mutex;
 
                 mutable std::recursive_mutex
                     _stateTransitionMutex;
 
-                ReadWriteMutex<uint32_t>
-                    _stackSize =
-                        ReadWriteMutex<uint32_t>(
-                            ESPRESSIO_THREAD_DEFAULT_STACK_SIZE
-                        );
-
-                ReadWriteMutex<unsigned int>
-                    _priority =
-                        ReadWriteMutex<unsigned int>(
-                            2
-                        );
-
-                ReadWriteMutex<int>
-                    _coreID =
-                        ReadWriteMutex<int>(
-                            0
-                        );
-
-                std::shared_ptr<
+                // Allocated on the first RegisterThreadObserver() call so
+                // unobserved Threads carry no observable.
+                std::unique_ptr<
                     LifecycleObservable
                 > _lifecycleObservable;
 
+                std::atomic<LifecycleObservable*>
+                    _lifecycleObservableInstance{
+                        nullptr
+                    };
 
-                mutable std::mutex
-                    _callbackMutex;
-
-                TOnThreadEvent
-                    _onDestroy =
-                        nullptr;
-
-                TOnThreadEvent
-                    _onInitialize =
-                        nullptr;
-
-                TOnThreadEvent
-                    _onStart =
-                        nullptr;
-
-                TOnThreadEvent
-                    _onPause =
-                        nullptr;
-
-                TOnThreadEvent
-                    _onTerminate =
-                        nullptr;
-
-                TOnThreadEvent
-                    _onTerminated =
-                        nullptr;
-
-                TOnThreadInitializationFailedEvent
-                    _onInitializationFailed =
-                        nullptr;
+                // Events queued for the observer dispatcher and not yet
+                // delivered; the destructor waits for them.
+                std::atomic<uint32_t>
+                    _observerEventsPending{
+                        0
+                    };
 
-                TOnThreadExecutionFailedEvent
-                    _onExecutionFailed =
-                        nullptr;
 
-                TOnThreadStateChangeEvent
-                    _onStateChange =
-                        nullptr;
+                // Allocated on the first callback assignment, so Threads
+                // without callbacks carry a single null pointer.
+                std::unique_ptr<
+                    Callbacks
+                > _callbacks;
 
 
                 bool _isValidThreadStateTransition(
@@ -451,113 +686,1076 @@ namespace ESPressio {
                 }
 
 
-                void _deleteTask() {
-                    TaskHandle_t handle =
-                        _taskHandle.exchange(
-                            nullptr,
-                            std::memory_order_acq_rel
+                LifecycleObservable*
+                _getLifecycleObservable() const {
+                    return
+                        _lifecycleObservableInstance.load(
+                            std::memory_order_acquire
                         );
-
-                    if (handle != nullptr) {
-                        vTaskDelete(handle);
-                    }
                 }
 
 
-                static void
-                _requestGarbageCollection();
-
-                static bool
-                _isTerminationDispatcherAvailable();
-
-                static bool
-                _isCurrentTerminationDispatcherTask();
-
-                static bool
-                _queueTerminationDispatch(
-                    Thread* thread
-                );
+                static void _deliverLifecycleEvent(
+                    const ObserverEvent& event
+                ) {
+                    Thread* thread =
+                        static_cast<Thread*>(
+                            event.Source
+                        );
 
-                void _dispatchTermination();
+                    LifecycleObservable* observable =
+                        thread->_getLifecycleObservable();
 
+                    if (observable == nullptr) {
+                        return;
+                    }
 
-                void _dispatchExecutionFailed(
-                    std::exception_ptr cause
-                ) noexcept {
-                    const std::exception_ptr
-                        executionFailure =
-                            std::make_exception_ptr(
-                                ThreadExecutionException(
-                                    std::move(cause)
-                                )
-                            );
+                    switch (
+                        static_cast<LifecycleEvent>(
+                            event.Kind
+                        )
+                    ) {
+                        case LifecycleEvent::StateChanged:
+                            observable->
+                                NotifyStateChanged(
+                                    thread,
+                                    static_cast<ThreadState>(
+                                        event.Values[0]
+                                    ),
+                                    static_cast<ThreadState>(
+                                        event.Values[1]
+                                    ),
+                                    false
+                                );
+                            break;
 
-                    try {
-                        TOnThreadExecutionFailedEvent
-                            onExecutionFailed =
-                                GetOnExecutionFailed();
+                        case LifecycleEvent::TaskExited:
+                            observable->
+                                NotifyTaskExited(
+                                    thread
+                                );
+                            break;
 
-                        if (
-                            onExecutionFailed !=
-                            nullptr
-                        ) {
-                            onExecutionFailed(
-                                this,
-                                executionFailure
-                            );
-                        }
-                    } catch (...) {
+                        case LifecycleEvent::InitializationFailed:
+                            observable->
+                                NotifyInitializationFailed(
+                                    thread,
+                                    static_cast<
+                                        ThreadInitializationStatus
+                                    >(
+                                        event.Values[0]
+                                    )
+                                );
+                            break;
                     }
+                }
 
-                    try {
-                        _lifecycleObservable->
-                            NotifyExecutionFailed(
-                                this,
-                                executionFailure
-                            );
-                    } catch (...) {
-                    }
+
+                static void _completeObserverEvent(
+                    const ObserverEvent& event
+                ) {
+                    static_cast<Thread*>(
+                        event.Source
+                    )->_observerEventsPending.fetch_sub(
+                        1,
+                        std::memory_order_acq_rel
+                    );
                 }
 
 
-                void _waitForTerminationDispatch() {
+                // Queues a lifecycle notification when delivery is
+                // asynchronous. `false` means notify synchronously.
+                bool _queueLifecycleEvent(
+                    LifecycleEvent kind,
+                    uint64_t first = 0,
+                    uint64_t second = 0
+                ) {
                     if (
-                        !_terminationDispatchPending.
-                            load(
-                                std::memory_order_acquire
-                            )
+                        GetObserverDelivery() !=
+                        ObserverDelivery::Asynchronous
                     ) {
-                        return;
+                        return false;
+                    }
+
+                    LifecycleObservable* observable =
+                        _getLifecycleObservable();
+
+                    ThreadObserverEvents events =
+                        ThreadObserverEvent::TaskExited;
+
+                    if (kind == LifecycleEvent::StateChanged) {
+                        events =
+                            ThreadObserverEvent::StateChanged |
+                            LifecycleObservable::StateEvent(
+                                static_cast<ThreadState>(second)
+                            );
+                    } else if (kind == LifecycleEvent::InitializationFailed) {
+                        events =
+                            ThreadObserverEvent::InitializationFailed;
                     }
 
+                    // Nobody listens: nothing to queue.
                     if (
-                        _isCurrentTerminationDispatcherTask()
+                        observable == nullptr ||
+                        !observable->IsInterested(
+                            events
+                        )
                     ) {
-                        return;
+                        return true;
                     }
 
-                    while (
-                        _terminationDispatchPending.
-                            load(
-                                std::memory_order_acquire
-                            )
-                    ) {
-                        const auto delayTicks =
-                            pdMS_TO_TICKS(1);
+                    ObserverEvent event;
 
-                        vTaskDelay(
-                            delayTicks > 0
-                                ? delayTicks
-                                : 1
-                        );
-                    }
+                    event.Deliver =
+                        _deliverLifecycleEvent;
+
+                    event.Kind =
+                        static_cast<uint8_t>(kind);
+
+                    event.Values[0] = first;
+                    event.Values[1] = second;
+
+                    // Dropped events are counted by the dispatcher, not
+                    // delivered late on this task.
+                    PublishObserverEvent(
+                        event
+                    );
+
+                    return true;
                 }
 
 
-                void _loop() {
-                    for (;;) {
-                        switch (
-                            _threadState.Get()
+                static uint64_t _wallNanoseconds() {
+                    return
+                        static_cast<uint64_t>(
+                            std::chrono::duration_cast<
+                                std::chrono::nanoseconds
+                            >(
+                                std::chrono::steady_clock::now().
+                                    time_since_epoch()
+                            ).count()
+                        );
+                }
+
+
+                void _recordStateChange(
+                    ThreadState oldState,
+                    ThreadState newState
+                ) {
+                    RecordThreadTrace(
+                        ThreadTraceEventType::StateChanged,
+                        _threadID,
+                        static_cast<uint32_t>(oldState) << 8 |
+                            static_cast<uint32_t>(newState)
+                    );
+
+                    #if ESPRESSIO_THREAD_METRICS
+                        ThreadMetrics::GetInstance()->
+                            StateTransitions[
+                                static_cast<std::size_t>(newState)
+                            ].Add();
+                    #endif
+                }
+
+
+                void _accountStateChange(
+                    ThreadState oldState
+                ) {
+                    #if ESPRESSIO_THREAD_RUNTIME_STATISTICS
+                        const uint64_t now =
+                            _wallNanoseconds();
+
+                        _runtime.StateNanoseconds[
+                            static_cast<std::size_t>(oldState)
+                        ] +=
+                            now -
+                            _runtime.StateEnteredNanoseconds;
+
+                        _runtime.StateEnteredNanoseconds =
+                            now;
+                    #else
+                        static_cast<void>(oldState);
+                    #endif
+                }
+
+
+                template <typename TCallback>
+                TCallback _getCallback(
+                    TCallback Callbacks::* callback
+                ) const {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    if (_callbacks == nullptr) {
+                        return nullptr;
+                    }
+
+                    return
+                        (*_callbacks).*callback;
+                }
+
+
+                template <typename TCallback>
+                void _setCallback(
+                    TCallback Callbacks::* callback,
+                    TCallback value
+                ) {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    if (_callbacks == nullptr) {
+                        if (value == nullptr) {
+                            return;
+                        }
+
+                        _callbacks =
+                            std::make_unique<
+                                Callbacks
+                            >();
+                    }
+
+                    (*_callbacks).*callback =
+                        std::move(value);
+                }
+
+
+                // `task` must stay alive for the call: either the calling
+                // task itself, or a handle read under `_mutex`.
+                void _sampleStack(
+                    TaskHandle_t task
+                ) {
+                    const uint32_t stackSize =
+                        GetStackSize();
+
+                    const uint32_t minimumFree =
+                        static_cast<uint32_t>(
+                            uxTaskGetStackHighWaterMark(
+                                task
+                            )
+                        );
+
+                    const uint32_t used =
+                        minimumFree < stackSize
+                            ? stackSize - minimumFree
+                            : 0;
+
+                    uint32_t peak =
+                        _stackPeakUsed.load(
+                            std::memory_order_relaxed
+                        );
+
+                    while (
+                        used > peak &&
+                        !_stackPeakUsed.compare_exchange_weak(
+                            peak,
+                            used,
+                            std::memory_order_relaxed
+                        )
+                    ) {
+                    }
+
+                    _stackSampled.store(
+                        true,
+                        std::memory_order_release
+                    );
+                }
+
+
+                /*
+                 * Detaches and deletes this Thread's task. `released` is
+                 * false while the task still waits at its gate, as on the
+                 * Initialize() failure paths.
+                 *
+                 * A static task is never deleted here: its TCB and stack
+                 * live in this object, and deleting it while it runs on
+                 * another core would leave the TCB for the idle task to
+                 * reclaim after the object is gone. A gated one is parked
+                 * in place; a released one leaves its loop, the Thread
+                 * being terminal by now, and parks itself. Either way
+                 * _releaseStaticTask() deletes it once it has blocked.
+                 */
+                void _deleteTask(
+                    bool released = true
+                ) {
+                    TaskHandle_t handle = nullptr;
+
+                    {
+                        // Excludes a concurrent stack sample of the task.
+                        std::lock_guard<
+                            std::mutex
+                        > lock(_mutex);
+
+                        handle =
+                            _taskHandle.exchange(
+                                nullptr,
+                                std::memory_order_acq_rel
+                            );
+                    }
+
+                    if (handle == nullptr) {
+                        return;
+                    }
+
+                    if (_staticBuffers == nullptr) {
+                        vTaskDelete(handle);
+                        return;
+                    }
+
+                    if (!released) {
+                        vTaskSetThreadLocalStoragePointerAndDelCallback(
+                            handle,
+                            ESPRESSIO_THREAD_TLS_INDEX,
+                            nullptr,
+                            nullptr
+                        );
+
+                        _staticBuffers->Parked.store(
+                            true,
+                            std::memory_order_release
+                        );
+                    }
+                }
+
+
+                // Returns this Thread's static task, creating it in the
+                // embedded buffers on first use. A parked task is reused as
+                // long as it is pinned to the requested core.
+                TaskHandle_t _acquireStaticTask() {
+                    StaticThreadBuffers& buffers =
+                        *_staticBuffers;
+
+                    if (buffers.Task != nullptr) {
+                        while (
+                            !buffers.Parked.load(
+                                std::memory_order_acquire
+                            )
+                        ) {
+                            vTaskDelay(1);
+                        }
+
+                        if (
+                            buffers.CoreID ==
+                            GetCoreID()
+                        ) {
+                            buffers.Parked.store(
+                                false,
+                                std::memory_order_release
+                            );
+
+                            vTaskPrioritySet(
+                                buffers.Task,
+                                GetPriority()
+                            );
+
+                            return buffers.Task;
+                        }
+
+                        // A pinned task cannot move cores; rebuild it in
+                        // the same buffers.
+                        _releaseStaticTask();
+                    }
+
+                    std::string threadName =
+                        "thread" +
+                        std::to_string(
+                            GetThreadID()
+                        );
+
+                    buffers.Task =
+                        xTaskCreateStaticPinnedToCore(
+                            _taskEntry,
+                            threadName.c_str(),
+                            buffers.StackDepth,
+                            this,
+                            GetPriority(),
+                            buffers.Stack,
+                            &buffers.TaskBuffer,
+                            GetCoreID()
+                        );
+
+                    buffers.CoreID =
+                        GetCoreID();
+
+                    buffers.Parked.store(
+                        false,
+                        std::memory_order_release
+                    );
+
+                    return buffers.Task;
+                }
+
+
+                // Deletes a parked static task. Waits until the worker has
+                // actually blocked, so its TCB is reclaimed inside
+                // vTaskDelete() rather than later by the idle task, after
+                // the buffers may already be gone.
+                void _releaseStaticTask() {
+                    if (
+                        _staticBuffers == nullptr ||
+                        _staticBuffers->Task == nullptr
+                    ) {
+                        return;
+                    }
+
+                    StaticThreadBuffers& buffers =
+                        *_staticBuffers;
+
+                    for (;;) {
+                        if (
+                            buffers.Parked.load(
+                                std::memory_order_acquire
+                            )
+                        ) {
+                            const eTaskState state =
+                                eTaskGetState(
+                                    buffers.Task
+                                );
+
+                            if (
+                                state != eRunning &&
+                                state != eReady
+                            ) {
+                                break;
+                            }
+                        }
+
+                        vTaskDelay(1);
+                    }
+
+                    vTaskDelete(
+                        buffers.Task
+                    );
+
+                    buffers.Task = nullptr;
+
+                    buffers.Parked.store(
+                        false,
+                        std::memory_order_release
+                    );
+                }
+
+
+                static void
+                _requestGarbageCollection();
+
+                static bool
+                _isTerminationDispatcherAvailable(
+                    int coreID
+                );
+
+                static bool
+                _isCurrentTerminationDispatcherTask();
+
+                static constexpr int _getCoreCount() {
+                    #if defined(portNUM_PROCESSORS)
+                        return
+                            portNUM_PROCESSORS > 0
+                                ? portNUM_PROCESSORS
+                                : 1;
+                    #elif defined(configNUMBER_OF_CORES)
+                        return
+                            configNUMBER_OF_CORES > 0
+                                ? configNUMBER_OF_CORES
+                                : 1;
+                    #else
+                        return 1;
+                    #endif
+                }
+
+                // Asks the ThreadManager's placement policy for a core.
+                void _placeOnInitialize();
+
+                static bool
+                _queueTerminationDispatch(
+                    Thread* thread
+                );
+
+                void _dispatchTermination();
+
+
+                static void _taskEntry(
+                    void* parameter
+                ) {
+                    Thread* instance =
+                        static_cast<
+                            Thread*
+                        >(parameter);
+
+                    for (;;) {
+                        ulTaskNotifyTake(
+                            pdTRUE,
+                            portMAX_DELAY
+                        );
+
+                        #if ESPRESSIO_THREAD_TASK_RECYCLING
+                            if (instance == nullptr) {
+                                instance =
+                                    static_cast<
+                                        Thread*
+                                    >(
+                                        pvTaskGetThreadLocalStoragePointer(
+                                            nullptr,
+                                            ESPRESSIO_THREAD_TLS_INDEX
+                                        )
+                                    );
+
+                                // A parked task is only released by a
+                                // claiming Thread; stay parked otherwise.
+                                if (instance == nullptr) {
+                                    continue;
+                                }
+                            }
+                        #endif
+
+                        if (
+                            instance !=
+                            nullptr
+                        ) {
+                            bool migrated = false;
+
+                            #if ESPRESSIO_THREAD_TASK_RECYCLING
+                                // This task's pool key, should it migrate.
+                                const int taskCoreID =
+                                    instance->GetCoreID();
+
+                                const uint32_t taskStackSize =
+                                    instance->GetStackSize();
+
+                                const unsigned int taskPriority =
+                                    instance->GetPriority();
+                            #endif
+
+                            try {
+                                migrated =
+                                    instance->_loop();
+                            } catch (...) {
+                                instance->
+                                    _dispatchExecutionFailed(
+                                        std::current_exception()
+                                    );
+
+                                instance->
+                                    Terminate();
+                            }
+
+                            // Another task now runs `instance`; this one
+                            // was already detached from it.
+                            if (migrated) {
+                                instance = nullptr;
+
+                                #if ESPRESSIO_THREAD_TASK_RECYCLING
+                                    if (
+                                        _parkMigratedTask(
+                                            taskCoreID,
+                                            taskStackSize,
+                                            taskPriority
+                                        )
+                                    ) {
+                                        continue;
+                                    }
+                                #endif
+
+                                break;
+                            }
+
+                            instance->
+                                _terminationDispatchPending.
+                                    store(
+                                        true,
+                                        std::memory_order_release
+                                    );
+
+                            const TaskHandle_t
+                                currentTask =
+                                    xTaskGetCurrentTaskHandle();
+
+                            {
+                                // Samplers read the handle under this lock,
+                                // so none can outlive the task.
+                                std::lock_guard<
+                                    std::mutex
+                                > lock(
+                                    instance->_mutex
+                                );
+
+                                instance->_sampleStack(
+                                    nullptr
+                                );
+
+                                TaskHandle_t expected =
+                                    currentTask;
+
+                                instance->_taskHandle.
+                                    compare_exchange_strong(
+                                        expected,
+                                        nullptr,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire
+                                    );
+                            }
+
+                            instance->
+                                TrySetThreadState(
+                                    ThreadState::Terminating,
+                                    ThreadState::Terminated
+                                );
+
+                            // A static task's memory belongs to the Thread,
+                            // so it parks with it instead of being deleted.
+                            if (
+                                instance->_staticBuffers !=
+                                nullptr
+                            ) {
+                                _parkStaticTask(instance);
+                                continue;
+                            }
+                        }
+
+                        #if ESPRESSIO_THREAD_TASK_RECYCLING
+                            if (
+                                instance != nullptr &&
+                                _recycleTask(instance)
+                            ) {
+                                instance = nullptr;
+                                continue;
+                            }
+                        #endif
+
+                        break;
+                    }
+
+                    vTaskDelete(
+                        nullptr
+                    );
+                }
+
+
+                static void _taskLocalStorageDeleted(
+                    int,
+                    void* value
+                ) {
+                    _onTaskExited(
+                        static_cast<
+                            Thread*
+                        >(value)
+                    );
+                }
+
+
+                // Releases shutdown waiters and queues termination dispatch
+                // once the worker no longer executes on behalf of `instance`.
+                static void _onTaskExited(
+                    Thread* instance
+                ) {
+                    if (
+                        instance ==
+                        nullptr
+                    ) {
+                        return;
+                    }
+
+                    if (
+                        instance->
+                            GetThreadState() !=
+                        ThreadState::Terminated
+                    ) {
+                        instance->
+                            _terminationDispatchPending.
+                                store(
+                                    false,
+                                    std::memory_order_release
+                                );
+
+                        if (
+                            instance->
+                                _taskExited !=
+                            nullptr
+                        ) {
+                            xSemaphoreGive(
+                                instance->
+                                    _taskExited
+                            );
+                        }
+
+                        return;
+                    }
+
+                    instance->
+                        _terminationDispatchPending.
+                            store(
+                                true,
+                                std::memory_order_release
+                            );
+
+                    if (
+                        !Thread::
+                            _queueTerminationDispatch(
+                                instance
+                            )
+                    ) {
+                        if (
+                            instance->
+                                _taskExited !=
+                            nullptr
+                        ) {
+                            xSemaphoreGive(
+                                instance->
+                                    _taskExited
+                            );
+                        }
+
+                        instance->
+                            _terminationDispatchPending.
+                                store(
+                                    false,
+                                    std::memory_order_release
+                                );
+                    }
+                }
+
+
+                // Detaches the calling static worker from the exit callback
+                // and parks it on its gate for reuse by the same Thread.
+                static void _parkStaticTask(
+                    Thread* instance
+                ) {
+                    StaticThreadBuffers* buffers =
+                        instance->_staticBuffers;
+
+                    vTaskSetThreadLocalStoragePointerAndDelCallback(
+                        nullptr,
+                        ESPRESSIO_THREAD_TLS_INDEX,
+                        nullptr,
+                        nullptr
+                    );
+
+                    ulTaskNotifyTake(
+                        pdTRUE,
+                        0
+                    );
+
+                    _onTaskExited(instance);
+
+                    // From here on `instance` may be destroyed; its
+                    // destructor waits for this flag before deleting us.
+                    buffers->Parked.store(
+                        true,
+                        std::memory_order_release
+                    );
+                }
+
+
+                #if ESPRESSIO_THREAD_TASK_RECYCLING
+                    // Detaches the calling worker from `instance` and parks it
+                    // in the task pool. Returns `false` when the pool is full
+                    // and the worker must delete itself instead.
+                    static bool _recycleTask(
+                        Thread* instance
+                    ) {
+                        // Capture the pool key first: once dispatch is
+                        // queued, `instance` may be destroyed at any time.
+                        const int coreID =
+                            instance->GetCoreID();
+
+                        const uint32_t stackSize =
+                            instance->GetStackSize();
+
+                        const unsigned int priority =
+                            instance->GetPriority();
+
+                        // Clearing the slot disarms the deletion callback, so
+                        // exit is reported exactly once, here.
+                        vTaskSetThreadLocalStoragePointerAndDelCallback(
+                            nullptr,
+                            ESPRESSIO_THREAD_TLS_INDEX,
+                            nullptr,
+                            nullptr
+                        );
+
+                        _onTaskExited(instance);
+
+                        // Discard notifications left over from OnLoop() so
+                        // only a claiming Thread's gate can release the task.
+                        ulTaskNotifyTake(
+                            pdTRUE,
+                            0
+                        );
+
+                        return
+                            ThreadTaskPool::GetInstance()->
+                                Park(
+                                    xTaskGetCurrentTaskHandle(),
+                                    coreID,
+                                    stackSize,
+                                    priority
+                                );
+                    }
+                #endif
+
+
+                void _dispatchExecutionFailed(
+                    std::exception_ptr cause
+                ) noexcept {
+                    const std::exception_ptr
+                        executionFailure =
+                            std::make_exception_ptr(
+                                ThreadExecutionException(
+                                    std::move(cause)
+                                )
+                            );
+
+                    try {
+                        TOnThreadExecutionFailedEvent
+                            onExecutionFailed =
+                                GetOnExecutionFailed();
+
+                        if (
+                            onExecutionFailed !=
+                            nullptr
+                        ) {
+                            onExecutionFailed(
+                                this,
+                                executionFailure
+                            );
+                        }
+                    } catch (...) {
+                    }
+
+                    try {
+                        LifecycleObservable* observable =
+                            _getLifecycleObservable();
+
+                        if (observable != nullptr) {
+                            observable->
+                                NotifyExecutionFailed(
+                                    this,
+                                    executionFailure
+                                );
+                        }
+                    } catch (...) {
+                    }
+                }
+
+
+                void _waitForTerminationDispatch() {
+                    if (
+                        !_terminationDispatchPending.
+                            load(
+                                std::memory_order_acquire
+                            )
+                    ) {
+                        return;
+                    }
+
+                    if (
+                        _isCurrentTerminationDispatcherTask()
+                    ) {
+                        return;
+                    }
+
+                    while (
+                        _terminationDispatchPending.
+                            load(
+                                std::memory_order_acquire
+                            )
+                    ) {
+                        const auto delayTicks =
+                            pdMS_TO_TICKS(1);
+
+                        vTaskDelay(
+                            delayTicks > 0
+                                ? delayTicks
+                                : 1
+                        );
+                    }
+                }
+
+
+                #if ESPRESSIO_THREAD_TASK_RECYCLING
+                    // Parks a worker that handed its Thread to another core.
+                    static bool _parkMigratedTask(
+                        int coreID,
+                        uint32_t stackSize,
+                        unsigned int priority
+                    ) {
+                        ulTaskNotifyTake(
+                            pdTRUE,
+                            0
+                        );
+
+                        return
+                            ThreadTaskPool::GetInstance()->
+                                Park(
+                                    xTaskGetCurrentTaskHandle(),
+                                    coreID,
+                                    stackSize,
+                                    priority
+                                );
+                    }
+                #endif
+
+
+                /*
+                 * Moves the Thread from the calling worker task to a new task
+                 * on the requested core. Runs on the worker between loop
+                 * bodies, so no OnLoop() is in flight. Returns `true` once the
+                 * new task owns the Thread; the caller must then leave it.
+                 */
+                bool _migrate() {
+                    const int coreID =
+                        _configuration.MigrationCoreID.exchange(
+                            -1,
+                            std::memory_order_acq_rel
+                        );
+
+                    if (
+                        coreID < 0 ||
+                        coreID == GetCoreID() ||
+                        GetLoopState() >=
+                            ThreadState::Terminating
+                    ) {
+                        return false;
+                    }
+
+                    TaskHandle_t createdTask =
+                        nullptr;
+
+                    bool claimed = false;
+
+                    #if ESPRESSIO_THREAD_TASK_RECYCLING
+                        createdTask =
+                            ThreadTaskPool::GetInstance()->
+                                Claim(
+                                    coreID,
+                                    GetStackSize(),
+                                    GetPriority()
+                                );
+
+                        claimed =
+                            createdTask != nullptr;
+                    #endif
+
+                    if (createdTask == nullptr) {
+                        std::string threadName =
+                            "thread" +
+                            std::to_string(
+                                GetThreadID()
+                            );
+
+                        if (
+                            xTaskCreatePinnedToCore(
+                                _taskEntry,
+                                threadName.c_str(),
+                                GetStackSize(),
+                                this,
+                                GetPriority(),
+                                &createdTask,
+                                coreID
+                            ) != pdPASS
+                        ) {
+                            return false;
+                        }
+                    }
+
+                    const TaskHandle_t currentTask =
+                        xTaskGetCurrentTaskHandle();
+
+                    {
+                        std::lock_guard<
+                            std::mutex
+                        > lock(_mutex);
+
+                        TaskHandle_t expected =
+                            currentTask;
+
+                        if (
+                            !_taskHandle.compare_exchange_strong(
+                                expected,
+                                createdTask,
+                                std::memory_order_acq_rel,
+                                std::memory_order_acquire
+                            )
+                        ) {
+                            // Still gated: a claimed task is parked again,
+                            // and a fresh one has never run.
+                            #if ESPRESSIO_THREAD_TASK_RECYCLING
+                                if (
+                                    claimed &&
+                                    ThreadTaskPool::GetInstance()->
+                                        Park(
+                                            createdTask,
+                                            coreID,
+                                            GetStackSize(),
+                                            GetPriority()
+                                        )
+                                ) {
+                                    return false;
+                                }
+                            #endif
+
+                            vTaskDelete(
+                                createdTask
+                            );
+
+                            return false;
+                        }
+
+                        _sampleStack(
+                            nullptr
+                        );
+
+                        if (claimed) {
+                            _stackRecycled.store(
+                                true,
+                                std::memory_order_relaxed
+                            );
+                        }
+
+                        _configuration.CoreID.store(
+                            coreID,
+                            std::memory_order_release
+                        );
+
+                        vTaskSetThreadLocalStoragePointerAndDelCallback(
+                            createdTask,
+                            ESPRESSIO_THREAD_TLS_INDEX,
+                            this,
+                            _taskLocalStorageDeleted
+                        );
+
+                        // The exit of this task is not the Thread's exit.
+                        vTaskSetThreadLocalStoragePointerAndDelCallback(
+                            nullptr,
+                            ESPRESSIO_THREAD_TLS_INDEX,
+                            nullptr,
+                            nullptr
+                        );
+                    }
+
+                    xTaskNotifyGive(
+                        createdTask
+                    );
+
+                    return true;
+                }
+
+
+                // Returns `true` when the Thread migrated to another task.
+                bool _loop() {
+                    for (;;) {
+                        if (
+                            _configuration.MigrationCoreID.load(
+                                std::memory_order_relaxed
+                            ) >= 0 &&
+                            _migrate()
+                        ) {
+                            return true;
+                        }
+
+                        switch (
+                            GetLoopState()
                         ) {
                             case ThreadState::Paused:
                             case ThreadState::Initialized:
@@ -575,13 +1773,22 @@ namespace ESPressio {
                                 break;
 
                             case ThreadState::Running:
-                                OnLoop();
+                                {
+                                    const LoopSample sample =
+                                        BeginLoopSample();
+
+                                    OnLoop();
+
+                                    EndLoopSample(
+                                        sample
+                                    );
+                                }
                                 break;
 
                             case ThreadState::Terminating:
                             case ThreadState::Terminated:
                             case ThreadState::Destroyed:
-                                return;
+                                return false;
                         }
                     }
                 }
@@ -603,36 +1810,38 @@ namespace ESPressio {
                     {
                         std::lock_guard<
                             std::mutex
-                        > lock(_callbackMutex);
-
-                        onStateChange =
-                            _onStateChange;
-
-                        switch (newState) {
-                            case ThreadState::Terminated:
-                                onThreadEvent =
-                                    _onTerminate;
-                                break;
-
-                            case ThreadState::Paused:
-                                onThreadEvent =
-                                    _onPause;
-                                break;
-
-                            case ThreadState::Running:
-                                onThreadEvent =
-                                    _onStart;
-                                break;
-
-                            case ThreadState::Initialized:
-                                onThreadEvent =
-                                    _onInitialize;
-                                break;
-
-                            case ThreadState::Uninitialized:
-                            case ThreadState::Terminating:
-                            case ThreadState::Destroyed:
-                                break;
+                        > lock(_mutex);
+
+                        if (_callbacks != nullptr) {
+                            onStateChange =
+                                _callbacks->OnStateChange;
+
+                            switch (newState) {
+                                case ThreadState::Terminated:
+                                    onThreadEvent =
+                                        _callbacks->OnTerminate;
+                                    break;
+
+                                case ThreadState::Paused:
+                                    onThreadEvent =
+                                        _callbacks->OnPause;
+                                    break;
+
+                                case ThreadState::Running:
+                                    onThreadEvent =
+                                        _callbacks->OnStart;
+                                    break;
+
+                                case ThreadState::Initialized:
+                                    onThreadEvent =
+                                        _callbacks->OnInitialize;
+                                    break;
+
+                                case ThreadState::Uninitialized:
+                                case ThreadState::Terminating:
+                                case ThreadState::Destroyed:
+                                    break;
+                            }
                         }
                     }
 
@@ -669,12 +1878,30 @@ namespace ESPressio {
                     }
 
                     try {
-                        _lifecycleObservable->
-                            NotifyStateChanged(
-                                this,
-                                oldState,
-                                newState
-                            );
+                        LifecycleObservable* observable =
+                            _getLifecycleObservable();
+
+                        // Destroyed is always synchronous: the Thread is
+                        // gone before a queued event could be delivered.
+                        if (
+                            observable != nullptr &&
+                            (
+                                newState ==
+                                    ThreadState::Destroyed ||
+                                !_queueLifecycleEvent(
+                                    LifecycleEvent::StateChanged,
+                                    static_cast<uint64_t>(oldState),
+                                    static_cast<uint64_t>(newState)
+                                )
+                            )
+                        ) {
+                            observable->
+                                NotifyStateChanged(
+                                    this,
+                                    oldState,
+                                    newState
+                                );
+                        }
                     } catch (...) {
                         callbackFailed =
                             true;
@@ -692,38 +1919,301 @@ namespace ESPressio {
                             ) ==
                             xTaskGetCurrentTaskHandle()
                     ) {
-                        throw std::runtime_error(
-                            "Thread initialization lifecycle callback failed"
-                        );
+                        throw std::runtime_error(
+                            "Thread initialization lifecycle callback failed"
+                        );
+                    }
+                }
+
+
+            protected:
+                virtual void OnLoop() {
+                    const auto delayTicks =
+                        pdMS_TO_TICKS(1);
+
+                    vTaskDelay(
+                        delayTicks > 0
+                            ? delayTicks
+                            : 1
+                    );
+                }
+
+
+                virtual void
+                OnInitialization() {
+                }
+
+
+                // Same as GetThreadState() without the virtual call, for
+                // loops that keep control across iterations (see
+                // ThreadBase).
+                ThreadState GetLoopState() const {
+                    return
+                        _threadState.load(
+                            std::memory_order_acquire
+                        );
+                }
+
+
+                // `true` while such a loop should keep control: Running, with
+                // no migration waiting for it to return.
+                bool ContinueLoop() const {
+                    return
+                        GetLoopState() ==
+                            ThreadState::Running &&
+                        _configuration.MigrationCoreID.load(
+                            std::memory_order_relaxed
+                        ) < 0;
+                }
+
+
+                // Queues `event` for the observer dispatcher on behalf of this
+                // Thread; the destructor waits until it has been delivered.
+                bool PublishObserverEvent(
+                    ObserverEvent event
+                ) {
+                    event.Source = this;
+
+                    event.Complete =
+                        _completeObserverEvent;
+
+                    _observerEventsPending.fetch_add(
+                        1,
+                        std::memory_order_acq_rel
+                    );
+
+                    if (
+                        !ObserverDispatcher::GetInstance()->
+                            Publish(
+                                event
+                            )
+                    ) {
+                        _observerEventsPending.fetch_sub(
+                            1,
+                            std::memory_order_acq_rel
+                        );
+
+                        return false;
+                    }
+
+                    return true;
+                }
+
+
+                // Waits until every queued observer event of this Thread is
+                // delivered. Derived destructors call it before tearing
+                // down state their own events read. On the dispatcher task,
+                // which cannot wait for itself, the queue is delivered
+                // inline instead.
+                void FlushObserverEvents() {
+                    if (
+                        ObserverDispatcher::GetInstance()->
+                            IsDispatcherTask()
+                    ) {
+                        ObserverDispatcher::GetInstance()->
+                            DeliverQueued();
+
+                        return;
+                    }
+
+                    while (
+                        _observerEventsPending.load(
+                            std::memory_order_acquire
+                        ) > 0
+                    ) {
+                        vTaskDelay(1);
                     }
                 }
 
 
-            protected:
-                virtual void OnLoop() {
-                    const auto delayTicks =
-                        pdMS_TO_TICKS(1);
+                // CPU time of the calling task, taken before and after loop
+                // bodies. Empty unless ESPRESSIO_THREAD_RUNTIME_STATISTICS.
+                struct LoopSample {
+                    #if ESPRESSIO_THREAD_RUNTIME_STATISTICS
+                        uint64_t CpuNanoseconds = 0;
+                        uint64_t VoluntaryContextSwitches = 0;
+                        uint64_t InvoluntaryContextSwitches = 0;
+                    #endif
+                };
 
-                    vTaskDelay(
-                        delayTicks > 0
-                            ? delayTicks
-                            : 1
+
+                LoopSample BeginLoopSample() {
+                    RecordThreadTrace(
+                        ThreadTraceEventType::LoopBegin,
+                        _threadID
                     );
+
+                    #if ESPRESSIO_THREAD_RUNTIME_STATISTICS
+                        ++_runtime.SampleDepth;
+                    #endif
+
+                    return _readLoopSample();
                 }
 
 
-                virtual void
-                OnInitialization() {
+                void EndLoopSample(
+                    const LoopSample& start,
+                    uint64_t iterations = 1
+                ) {
+                    RecordThreadTrace(
+                        ThreadTraceEventType::LoopEnd,
+                        _threadID
+                    );
+
+                    #if ESPRESSIO_THREAD_RUNTIME_STATISTICS
+                        const LoopSample end =
+                            _readLoopSample();
+
+                        const bool nested =
+                            _runtime.SampleDepth > 1;
+
+                        if (_runtime.SampleDepth > 0) {
+                            --_runtime.SampleDepth;
+                        }
+
+                        if (nested) {
+                            _runtime.NestedSampleTaken = true;
+                        } else if (_runtime.NestedSampleTaken) {
+                            _runtime.NestedSampleTaken = false;
+                            return;
+                        }
+
+                        _accountLoopSample(
+                            start,
+                            end,
+                            iterations
+                        );
+                    #else
+                        static_cast<void>(start);
+                        static_cast<void>(iterations);
+                    #endif
+                }
+
+
+            private:
+                static LoopSample _readLoopSample() {
+                    LoopSample sample;
+
+                    #if ESPRESSIO_THREAD_RUNTIME_STATISTICS
+                        #if defined(configGENERATE_RUN_TIME_STATS) && configGENERATE_RUN_TIME_STATS
+                            sample.CpuNanoseconds =
+                                static_cast<uint64_t>(
+                                    ulTaskGetRunTimeCounter(
+                                        xTaskGetCurrentTaskHandle()
+                                    )
+                                ) *
+                                ESPRESSIO_THREAD_RUN_TIME_COUNTER_NANOSECONDS;
+                        #elif defined(CLOCK_THREAD_CPUTIME_ID)
+                            timespec cpuTime{};
+
+                            if (
+                                clock_gettime(
+                                    CLOCK_THREAD_CPUTIME_ID,
+                                    &cpuTime
+                                ) == 0
+                            ) {
+                                sample.CpuNanoseconds =
+                                    static_cast<uint64_t>(
+                                        cpuTime.tv_sec
+                                    ) * 1000000000ULL +
+                                    static_cast<uint64_t>(
+                                        cpuTime.tv_nsec
+                                    );
+                            }
+                        #endif
+
+                        #if defined(RUSAGE_THREAD)
+                            rusage usage{};
+
+                            if (
+                                getrusage(
+                                    RUSAGE_THREAD,
+                                    &usage
+                                ) == 0
+                            ) {
+                                sample.VoluntaryContextSwitches =
+                                    static_cast<uint64_t>(
+                                        usage.ru_nvcsw
+                                    );
+
+                                sample.InvoluntaryContextSwitches =
+                                    static_cast<uint64_t>(
+                                        usage.ru_nivcsw
+                                    );
+                            }
+                        #endif
+                    #endif
+
+                    return sample;
                 }
 
 
+                #if ESPRESSIO_THREAD_RUNTIME_STATISTICS
+                    void _accountLoopSample(
+                        const LoopSample& start,
+                        const LoopSample& end,
+                        uint64_t iterations
+                    ) {
+                        _runtime.LoopIterations.fetch_add(
+                            iterations,
+                            std::memory_order_relaxed
+                        );
+
+                        if (end.CpuNanoseconds >= start.CpuNanoseconds) {
+                            _runtime.LoopCpuNanoseconds.fetch_add(
+                                end.CpuNanoseconds -
+                                    start.CpuNanoseconds,
+                                std::memory_order_relaxed
+                            );
+                        }
+
+                        if (
+                            end.VoluntaryContextSwitches >=
+                            start.VoluntaryContextSwitches
+                        ) {
+                            _runtime.VoluntaryContextSwitches.fetch_add(
+                                end.VoluntaryContextSwitches -
+                                    start.VoluntaryContextSwitches,
+                                std::memory_order_relaxed
+                            );
+                        }
+
+                        if (
+                            end.InvoluntaryContextSwitches >=
+                            start.InvoluntaryContextSwitches
+                        ) {
+                            _runtime.InvoluntaryContextSwitches.fetch_add(
+                                end.InvoluntaryContextSwitches -
+                                    start.InvoluntaryContextSwitches,
+                                std::memory_order_relaxed
+                            );
+                        }
+                    }
+                #endif
+
+
+            protected:
+                // Binds caller-owned task, stack and exit semaphore storage.
+                // `staticBuffers` must outlive the Thread; see StaticThread.
+                explicit Thread(
+                    StaticThreadBuffers* staticBuffers
+                );
+
+
                 void SetThreadState(
                     ThreadState state
                 ) {
+                    LockWithThreadTrace(
+                        _stateTransitionMutex,
+                        _threadID,
+                        ThreadTraceLock::StateTransition
+                    );
+
                     std::lock_guard<
                         std::recursive_mutex
                     > transitionLock(
-                        _stateTransitionMutex
+                        _stateTransitionMutex,
+                        std::adopt_lock
                     );
 
                     ThreadState oldState =
@@ -732,27 +2222,37 @@ namespace ESPressio {
                     bool changed =
                         false;
 
-                    _threadState.WithWriteLock(
-                        [&](ThreadState& currentState) {
-                            if (
-                                !_isValidThreadStateTransition(
-                                    currentState,
-                                    state
-                                )
-                            ) {
-                                return;
-                            }
+                    const ThreadState currentState =
+                        _threadState.load(
+                            std::memory_order_acquire
+                        );
+
+                    if (
+                        _isValidThreadStateTransition(
+                            currentState,
+                            state
+                        )
+                    ) {
+                        oldState =
+                            currentState;
 
-                            oldState =
-                                currentState;
+                        _threadState.store(
+                            state,
+                            std::memory_order_release
+                        );
 
-                            currentState =
-                                state;
+                        _accountStateChange(
+                            currentState
+                        );
 
-                            changed =
-                                true;
-                        }
-                    );
+                        _recordStateChange(
+                            currentState,
+                            state
+                        );
+
+                        changed =
+                            true;
+                    }
 
                     if (changed) {
                         _dispatchThreadStateChange(
@@ -767,35 +2267,52 @@ namespace ESPressio {
                     ThreadState expectedState,
                     ThreadState newState
                 ) {
+                    LockWithThreadTrace(
+                        _stateTransitionMutex,
+                        _threadID,
+                        ThreadTraceLock::StateTransition
+                    );
+
                     std::lock_guard<
                         std::recursive_mutex
                     > transitionLock(
-                        _stateTransitionMutex
+                        _stateTransitionMutex,
+                        std::adopt_lock
                     );
 
                     bool changed =
                         false;
 
-                    _threadState.WithWriteLock(
-                        [&](ThreadState& currentState) {
-                            if (
-                                currentState !=
-                                    expectedState ||
-                                !_isValidThreadStateTransition(
-                                    currentState,
-                                    newState
-                                )
-                            ) {
-                                return;
-                            }
+                    const ThreadState currentState =
+                        _threadState.load(
+                            std::memory_order_acquire
+                        );
+
+                    if (
+                        currentState ==
+                            expectedState &&
+                        _isValidThreadStateTransition(
+                            currentState,
+                            newState
+                        )
+                    ) {
+                        _threadState.store(
+                            newState,
+                            std::memory_order_release
+                        );
 
-                            currentState =
-                                newState;
+                        _accountStateChange(
+                            currentState
+                        );
 
-                            changed =
-                                true;
-                        }
-                    );
+                        _recordStateChange(
+                            currentState,
+                            newState
+                        );
+
+                        changed =
+                            true;
+                    }
 
                     if (changed) {
                         _dispatchThreadStateChange(
@@ -833,12 +2350,47 @@ namespace ESPressio {
                 void GarbageCollect();
 
 
+                /// `events` selects the callbacks `observer` receives; the
+                /// others are skipped with a bit test instead of a virtual
+                /// call. Registering again replaces the mask.
                 Observable::ObserverHandlePtr
                 RegisterThreadObserver(
-                    IThreadObserver* observer
+                    IThreadObserver* observer,
+                    ThreadObserverEvents events =
+                        ThreadObserverEvent::All
                 ) {
+                    LifecycleObservable* observable =
+                        _getLifecycleObservable();
+
+                    if (observable == nullptr) {
+                        std::lock_guard<
+                            std::mutex
+                        > lock(_mutex);
+
+                        if (_lifecycleObservable == nullptr) {
+                            _lifecycleObservable =
+                                std::make_unique<
+                                    LifecycleObservable
+                                >();
+
+                            _lifecycleObservableInstance.store(
+                                _lifecycleObservable.get(),
+                                std::memory_order_release
+                            );
+                        }
+
+                        observable =
+                            _lifecycleObservable.get();
+                    }
+
+                    observable->
+                        SetInterests(
+                            observer,
+                            events
+                        );
+
                     return
-                        _lifecycleObservable->
+                        observable->
                             RegisterObserver(
                                 observer
                             );
@@ -848,10 +2400,20 @@ namespace ESPressio {
                 void UnregisterThreadObserver(
                     IThreadObserver* observer
                 ) {
-                    _lifecycleObservable->
-                        UnregisterObserver(
-                            observer
-                        );
+                    LifecycleObservable* observable =
+                        _getLifecycleObservable();
+
+                    if (observable != nullptr) {
+                        observable->
+                            UnregisterObserver(
+                                observer
+                            );
+
+                        observable->
+                            RemoveInterests(
+                                observer
+                            );
+                    }
                 }
 
 
@@ -909,6 +2471,7 @@ namespace ESPressio {
                         }
 
                         _waitForTerminationDispatch();
+                        FlushObserverEvents();
                         return;
                     }
 
@@ -928,6 +2491,9 @@ namespace ESPressio {
                     );
 
                     _waitForTerminationDispatch();
+
+                    // Queued events may still read the derived object.
+                    FlushObserverEvents();
                 }
 
 
@@ -964,8 +2530,12 @@ namespace ESPressio {
                                 TerminationDispatchPending;
                     }
 
+                    _placeOnInitialize();
+
                     if (
-                        !_isTerminationDispatcherAvailable()
+                        !_isTerminationDispatcherAvailable(
+                            GetCoreID()
+                        )
                     ) {
                         return
                             ThreadInitializationStatus::
@@ -1001,7 +2571,7 @@ namespace ESPressio {
                     std::unique_lock<
                         std::mutex
                     > configurationLock(
-                        _taskConfigurationMutex
+                        _mutex
                     );
 
                     if (
@@ -1014,12 +2584,6 @@ namespace ESPressio {
                                 AlreadyInitialized;
                     }
 
-                    std::string threadName =
-                        "thread" +
-                        std::to_string(
-                            GetThreadID()
-                        );
-
                     TaskHandle_t createdTask =
                         nullptr;
 
@@ -1028,181 +2592,98 @@ namespace ESPressio {
                         0
                     );
 
-                    const BaseType_t result =
-                        xTaskCreatePinnedToCore(
-                            [](void* parameter) {
-                                Thread* instance =
-                                    static_cast<
-                                        Thread*
-                                    >(parameter);
-
-                                ulTaskNotifyTake(
-                                    pdTRUE,
-                                    portMAX_DELAY
-                                );
-
-                                if (
-                                    instance !=
-                                    nullptr
-                                ) {
-                                    try {
-                                        instance->_loop();
-                                    } catch (...) {
-                                        instance->
-                                            _dispatchExecutionFailed(
-                                                std::current_exception()
-                                            );
-
-                                        instance->
-                                            Terminate();
-                                    }
-
-                                    instance->
-                                        _terminationDispatchPending.
-                                            store(
-                                                true,
-                                                std::memory_order_release
-                                            );
-
-                                    const TaskHandle_t
-                                        currentTask =
-                                            xTaskGetCurrentTaskHandle();
-
-                                    TaskHandle_t expected =
-                                        currentTask;
-
-                                    instance->_taskHandle.
-                                        compare_exchange_strong(
-                                            expected,
-                                            nullptr,
-                                            std::memory_order_acq_rel,
-                                            std::memory_order_acquire
-                                        );
-
-                                    instance->
-                                        TrySetThreadState(
-                                            ThreadState::Terminating,
-                                            ThreadState::Terminated
-                                        );
-                                }
+                    #if ESPRESSIO_THREAD_TASK_RECYCLING
+                        if (_staticBuffers == nullptr) {
+                            createdTask =
+                                ThreadTaskPool::GetInstance()->
+                                    Claim(
+                                        GetCoreID(),
+                                        GetStackSize(),
+                                        GetPriority()
+                                    );
 
-                                vTaskDelete(
-                                    nullptr
+                            if (createdTask != nullptr) {
+                                _stackRecycled.store(
+                                    true,
+                                    std::memory_order_relaxed
                                 );
-                            },
-                            threadName.c_str(),
-                            GetStackSize(),
-                            this,
-                            GetPriority(),
-                            &createdTask,
-                            GetCoreID()
-                        );
-
-                    if (
-                        result !=
-                        pdPASS
-                    ) {
-                        return
-                            ThreadInitializationStatus::
-                                TaskCreationFailed;
-                    }
-
-                    TaskHandle_t expected =
-                        nullptr;
-
-                    if (
-                        !_taskHandle.
-                            compare_exchange_strong(
-                                expected,
-                                createdTask,
-                                std::memory_order_release,
-                                std::memory_order_acquire
-                            )
-                    ) {
-                        vTaskDelete(
-                            createdTask
-                        );
-
-                        return
-                            ThreadInitializationStatus::
-                                ConcurrentInitializationLost;
-                    }
-
-                    vTaskSetThreadLocalStoragePointerAndDelCallback(
-                        createdTask,
-                        ESPRESSIO_THREAD_TLS_INDEX,
-                        this,
-                        [](int, void* value) {
-                            Thread* instance =
-                                static_cast<
-                                    Thread*
-                                >(value);
-
-                            if (
-                                instance ==
-                                nullptr
-                            ) {
-                                return;
                             }
+                        }
+                    #endif
 
-                            if (
-                                instance->
-                                    GetThreadState() !=
-                                ThreadState::Terminated
-                            ) {
-                                instance->
-                                    _terminationDispatchPending.
-                                        store(
-                                            false,
-                                            std::memory_order_release
-                                        );
-
-                                if (
-                                    instance->
-                                        _taskExited !=
-                                    nullptr
-                                ) {
-                                    xSemaphoreGive(
-                                        instance->
-                                            _taskExited
-                                    );
-                                }
+                    if (_staticBuffers != nullptr) {
+                        createdTask =
+                            _acquireStaticTask();
 
-                                return;
-                            }
+                        if (createdTask == nullptr) {
+                            return
+                                ThreadInitializationStatus::
+                                    TaskCreationFailed;
+                        }
+                    } else if (createdTask == nullptr) {
+                        std::string threadName =
+                            "thread" +
+                            std::to_string(
+                                GetThreadID()
+                            );
 
-                            instance->
-                                _terminationDispatchPending.
-                                    store(
-                                        true,
-                                        std::memory_order_release
-                                    );
+                        const BaseType_t result =
+                            xTaskCreatePinnedToCore(
+                                _taskEntry,
+                                threadName.c_str(),
+                                GetStackSize(),
+                                this,
+                                GetPriority(),
+                                &createdTask,
+                                GetCoreID()
+                            );
 
-                            if (
-                                !Thread::
-                                    _queueTerminationDispatch(
-                                        instance
-                                    )
-                            ) {
-                                if (
-                                    instance->
-                                        _taskExited !=
-                                    nullptr
-                                ) {
-                                    xSemaphoreGive(
-                                        instance->
-                                            _taskExited
-                                    );
-                                }
+                        if (
+                            result !=
+                            pdPASS
+                        ) {
+                            return
+                                ThreadInitializationStatus::
+                                    TaskCreationFailed;
+                        }
+                    }
 
-                                instance->
-                                    _terminationDispatchPending.
-                                        store(
-                                            false,
-                                            std::memory_order_release
-                                        );
-                            }
+                    TaskHandle_t expected =
+                        nullptr;
+
+                    if (
+                        !_taskHandle.
+                            compare_exchange_strong(
+                                expected,
+                                createdTask,
+                                std::memory_order_release,
+                                std::memory_order_acquire
+                            )
+                    ) {
+                        if (_staticBuffers != nullptr) {
+                            // Still gated, so it can simply be parked again.
+                            _staticBuffers->Parked.store(
+                                true,
+                                std::memory_order_release
+                            );
+                        } else {
+                            vTaskDelete(
+                                createdTask
+                            );
                         }
+
+                        return
+                            ThreadInitializationStatus::
+                                ConcurrentInitializationLost;
+                    }
+
+                    // A recycled task binds to this Thread through the TLS
+                    // slot when the gate notification releases it.
+                    vTaskSetThreadLocalStoragePointerAndDelCallback(
+                        createdTask,
+                        ESPRESSIO_THREAD_TLS_INDEX,
+                        this,
+                        _taskLocalStorageDeleted
                     );
 
                     configurationLock.unlock();
@@ -1268,7 +2749,7 @@ namespace ESPressio {
                                 );
                             }
 
-                            _deleteTask();
+                            _deleteTask(false);
 
                             return
                                 ThreadInitializationStatus::
@@ -1298,7 +2779,7 @@ namespace ESPressio {
                                 );
                             }
 
-                            _deleteTask();
+                            _deleteTask(false);
 
                             return
                                 ThreadInitializationStatus::
@@ -1327,7 +2808,7 @@ namespace ESPressio {
                         } catch (...) {
                         }
 
-                        _deleteTask();
+                        _deleteTask(false);
 
                         return
                             ThreadInitializationStatus::
@@ -1375,11 +2856,22 @@ namespace ESPressio {
                         }
 
                         try {
-                            _lifecycleObservable->
-                                NotifyInitializationFailed(
-                                    this,
-                                    status
-                                );
+                            LifecycleObservable* observable =
+                                _getLifecycleObservable();
+
+                            if (
+                                observable != nullptr &&
+                                !_queueLifecycleEvent(
+                                    LifecycleEvent::InitializationFailed,
+                                    static_cast<uint64_t>(status)
+                                )
+                            ) {
+                                observable->
+                                    NotifyInitializationFailed(
+                                        this,
+                                        status
+                                    );
+                            }
                         } catch (...) {
                         }
                     }
@@ -1497,10 +2989,16 @@ namespace ESPressio {
 
                 bool
                 TryClaimAutomaticCleanup() override {
+                    // A pending dispatch still owns the embedded dispatch
+                    // node; collection is requested again once it completes.
                     if (
                         !GetFreeOnTerminate() ||
                         GetThreadState() !=
-                            ThreadState::Terminated
+                            ThreadState::Terminated ||
+                        _terminationDispatchPending.
+                            load(
+                                std::memory_order_acquire
+                            )
                     ) {
                         return false;
                     }
@@ -1520,18 +3018,27 @@ namespace ESPressio {
 
 
                 int GetCoreID() override {
-                    return _coreID.Get();
+                    return
+                        _configuration.CoreID.load(
+                            std::memory_order_acquire
+                        );
                 }
 
 
                 uint32_t GetStackSize() override {
-                    return _stackSize.Get();
+                    return
+                        _configuration.StackSize.load(
+                            std::memory_order_acquire
+                        );
                 }
 
 
                 unsigned int
                 GetPriority() override {
-                    return _priority.Get();
+                    return
+                        _configuration.Priority.load(
+                            std::memory_order_acquire
+                        );
                 }
 
 
@@ -1542,123 +3049,306 @@ namespace ESPressio {
 
                 ThreadState
                 GetThreadState() override {
-                    return _threadState.Get();
+                    return GetLoopState();
                 }
 
 
                 bool
                 GetFreeOnTerminate() override {
                     return
-                        _freeOnTerminate.Get();
+                        _configuration.FreeOnTerminate.load(
+                            std::memory_order_acquire
+                        );
                 }
 
 
                 bool
                 GetStartOnInitialize() override {
                     return
-                        _startOnInitialize.Get();
+                        _configuration.StartOnInitialize.load(
+                            std::memory_order_acquire
+                        );
+                }
+
+
+                bool GetStackStatistics(
+                    ThreadStackStatistics& statistics
+                ) override {
+                    {
+                        std::lock_guard<
+                            std::mutex
+                        > lock(_mutex);
+
+                        const TaskHandle_t task =
+                            _taskHandle.load(
+                                std::memory_order_acquire
+                            );
+
+                        if (task != nullptr) {
+                            _sampleStack(task);
+                        }
+                    }
+
+                    statistics = ThreadStackStatistics();
+
+                    statistics.StackSize =
+                        GetStackSize();
+
+                    statistics.Sampled =
+                        _stackSampled.load(
+                            std::memory_order_acquire
+                        );
+
+                    statistics.Recycled =
+                        _stackRecycled.load(
+                            std::memory_order_relaxed
+                        );
+
+                    if (!statistics.Sampled) {
+                        return true;
+                    }
+
+                    statistics.PeakUsed =
+                        _stackPeakUsed.load(
+                            std::memory_order_relaxed
+                        );
+
+                    statistics.MinimumFree =
+                        statistics.PeakUsed < statistics.StackSize
+                            ? statistics.StackSize - statistics.PeakUsed
+                            : 0;
+
+                    const uint64_t proportionalMargin =
+                        static_cast<uint64_t>(statistics.PeakUsed) *
+                        ESPRESSIO_THREAD_STACK_MARGIN_PERCENT /
+                        100;
+
+                    const uint64_t suggested =
+                        statistics.PeakUsed +
+                        std::max<uint64_t>(
+                            ESPRESSIO_THREAD_STACK_MARGIN,
+                            proportionalMargin
+                        );
+
+                    // Rounded up to a 16-unit boundary.
+                    statistics.SuggestedStackSize =
+                        static_cast<uint32_t>(
+                            (suggested + 15) / 16 * 16
+                        );
+
+                    return true;
+                }
+
+
+                bool GetRuntimeStatistics(
+                    ThreadRuntimeStatistics& statistics
+                ) override {
+                    #if ESPRESSIO_THREAD_RUNTIME_STATISTICS
+                        statistics = ThreadRuntimeStatistics();
+
+                        #if defined(configGENERATE_RUN_TIME_STATS) && configGENERATE_RUN_TIME_STATS
+                            statistics.CpuTimeAvailable = true;
+                        #elif defined(CLOCK_THREAD_CPUTIME_ID)
+                            statistics.CpuTimeAvailable = true;
+                        #endif
+
+                        #if defined(RUSAGE_THREAD)
+                            statistics.ContextSwitchesAvailable = true;
+                        #endif
+
+                        statistics.LoopIterations =
+                            _runtime.LoopIterations.load(
+                                std::memory_order_relaxed
+                            );
+
+                        statistics.LoopCpuNanoseconds =
+                            _runtime.LoopCpuNanoseconds.load(
+                                std::memory_order_relaxed
+                            );
+
+                        statistics.VoluntaryContextSwitches =
+                            _runtime.VoluntaryContextSwitches.load(
+                                std::memory_order_relaxed
+                            );
+
+                        statistics.InvoluntaryContextSwitches =
+                            _runtime.InvoluntaryContextSwitches.load(
+                                std::memory_order_relaxed
+                            );
+
+                        std::lock_guard<
+                            std::recursive_mutex
+                        > transitionLock(
+                            _stateTransitionMutex
+                        );
+
+                        for (
+                            std::size_t state = 0;
+                            state < ThreadStateCount;
+                            ++state
+                        ) {
+                            statistics.StateNanoseconds[state] =
+                                _runtime.StateNanoseconds[state];
+                        }
+
+                        // Include the time spent so far in the current state.
+                        statistics.StateNanoseconds[
+                            static_cast<std::size_t>(
+                                GetLoopState()
+                            )
+                        ] +=
+                            _wallNanoseconds() -
+                            _runtime.StateEnteredNanoseconds;
+
+                        return true;
+                    #else
+                        static_cast<void>(statistics);
+                        return false;
+                    #endif
                 }
 
 
                 TOnThreadEvent
                 GetOnDestroy() override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    return _onDestroy;
+                    return
+                        _getCallback(
+                            &Callbacks::OnDestroy
+                        );
                 }
 
 
                 TOnThreadEvent
                 GetOnInitialize() override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    return _onInitialize;
+                    return
+                        _getCallback(
+                            &Callbacks::OnInitialize
+                        );
                 }
 
 
                 TOnThreadEvent
                 GetOnStart() override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    return _onStart;
+                    return
+                        _getCallback(
+                            &Callbacks::OnStart
+                        );
                 }
 
 
                 TOnThreadEvent
                 GetOnPause() override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    return _onPause;
+                    return
+                        _getCallback(
+                            &Callbacks::OnPause
+                        );
                 }
 
 
                 TOnThreadEvent
                 GetOnTerminate() override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    return _onTerminate;
+                    return
+                        _getCallback(
+                            &Callbacks::OnTerminate
+                        );
                 }
 
 
                 TOnThreadEvent
                 GetOnTerminated() override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    return _onTerminated;
+                    return
+                        _getCallback(
+                            &Callbacks::OnTerminated
+                        );
                 }
 
 
                 TOnThreadInitializationFailedEvent
                 GetOnInitializationFailed() override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
                     return
-                        _onInitializationFailed;
+                        _getCallback(
+                            &Callbacks::OnInitializationFailed
+                        );
                 }
 
 
                 TOnThreadExecutionFailedEvent
                 GetOnExecutionFailed() override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
                     return
-                        _onExecutionFailed;
+                        _getCallback(
+                            &Callbacks::OnExecutionFailed
+                        );
                 }
 
 
                 TOnThreadStateChangeEvent
                 GetOnStateChange() override {
+                    return
+                        _getCallback(
+                            &Callbacks::OnStateChange
+                        );
+                }
+
+
+                void SetCoreID(
+                    int value
+                ) override {
                     std::lock_guard<
                         std::mutex
-                    > lock(_callbackMutex);
+                    > lock(
+                        _mutex
+                    );
+
+                    if (
+                        _taskHandle.load(
+                            std::memory_order_acquire
+                        ) == nullptr
+                    ) {
+                        _configuration.CoreID.store(
+                            value,
+                            std::memory_order_release
+                        );
+
+                        _configuration.CoreIDPinned.store(
+                            true,
+                            std::memory_order_release
+                        );
+                    }
+                }
 
-                    return _onStateChange;
+
+                bool IsCoreIDPinned() override {
+                    return
+                        _configuration.CoreIDPinned.load(
+                            std::memory_order_acquire
+                        );
                 }
 
 
-                void SetCoreID(
-                    int value
+                /// Asks the running Thread to move to `coreID`, which must be
+                /// below the core count; `tskNO_AFFINITY` is not a target.
+                /// Returns `false` when that core's termination dispatcher
+                /// cannot be started, as the Thread's exit would then go
+                /// unreported.
+                bool MigrateToCore(
+                    int coreID
                 ) override {
+                    // A static task runs on this object's own stack, so a
+                    // second task cannot take over from it.
+                    if (
+                        _staticBuffers != nullptr ||
+                        coreID < 0 ||
+                        coreID >= _getCoreCount() ||
+                        !_isTerminationDispatcherAvailable(
+                            coreID
+                        )
+                    ) {
+                        return false;
+                    }
+
                     std::lock_guard<
                         std::mutex
                     > lock(
-                        _taskConfigurationMutex
+                        _mutex
                     );
 
                     if (
@@ -1666,8 +3356,30 @@ namespace ESPressio {
                             std::memory_order_acquire
                         ) == nullptr
                     ) {
-                        _coreID.Set(value);
+                        return false;
+                    }
+
+                    switch (GetLoopState()) {
+                        case ThreadState::Initialized:
+                        case ThreadState::Running:
+                        case ThreadState::Paused:
+                            break;
+
+                        case ThreadState::Uninitialized:
+                        case ThreadState::Terminating:
+                        case ThreadState::Terminated:
+                        case ThreadState::Destroyed:
+                            return false;
                     }
+
+                    _configuration.MigrationCoreID.store(
+                        coreID == GetCoreID()
+                            ? -1
+                            : coreID,
+                        std::memory_order_release
+                    );
+
+                    return true;
                 }
 
 
@@ -1677,7 +3389,7 @@ namespace ESPressio {
                     std::lock_guard<
                         std::mutex
                     > lock(
-                        _taskConfigurationMutex
+                        _mutex
                     );
 
                     if (
@@ -1686,7 +3398,10 @@ namespace ESPressio {
                         ) == nullptr &&
                         value > 0
                     ) {
-                        _stackSize.Set(value);
+                        _configuration.StackSize.store(
+                            value,
+                            std::memory_order_release
+                        );
                     }
                 }
 
@@ -1697,7 +3412,7 @@ namespace ESPressio {
                     std::lock_guard<
                         std::mutex
                     > lock(
-                        _taskConfigurationMutex
+                        _mutex
                     );
 
                     if (
@@ -1705,7 +3420,10 @@ namespace ESPressio {
                             std::memory_order_acquire
                         ) == nullptr
                     ) {
-                        _priority.Set(value);
+                        _configuration.Priority.store(
+                            value,
+                            std::memory_order_release
+                        );
                     }
                 }
 
@@ -1713,8 +3431,9 @@ namespace ESPressio {
                 void SetFreeOnTerminate(
                     bool value
                 ) override {
-                    _freeOnTerminate.Set(
-                        value
+                    _configuration.FreeOnTerminate.store(
+                        value,
+                        std::memory_order_release
                     );
 
                     if (value) {
@@ -1746,75 +3465,105 @@ namespace ESPressio {
                 void SetStartOnInitialize(
                     bool value
                 ) override {
-                    _startOnInitialize.Set(
-                        value
+                    _configuration.StartOnInitialize.store(
+                        value,
+                        std::memory_order_release
+                    );
+                }
+
+
+                /// Asynchronous delivery queues observer notifications for
+                /// the ObserverDispatcher task instead of running observers
+                /// on this Thread's transitions and iterations. Execution
+                /// failures and OnThreadDestroyed() stay synchronous.
+                /// Selecting it starts the dispatcher task, so publishing
+                /// never does; returns `false`, leaving delivery unchanged,
+                /// if the task cannot be created.
+                bool SetObserverDelivery(
+                    ObserverDelivery value
+                ) {
+                    if (
+                        value == ObserverDelivery::Asynchronous &&
+                        !ObserverDispatcher::GetInstance()->
+                            EnsureStarted()
+                    ) {
+                        return false;
+                    }
+
+                    _configuration.Delivery.store(
+                        value,
+                        std::memory_order_release
                     );
+
+                    return true;
+                }
+
+
+                ObserverDelivery GetObserverDelivery() const {
+                    return
+                        _configuration.Delivery.load(
+                            std::memory_order_acquire
+                        );
                 }
 
 
                 void SetOnDestroy(
                     TOnThreadEvent value
                 ) override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    _onDestroy = value;
+                    _setCallback(
+                        &Callbacks::OnDestroy,
+                        std::move(value)
+                    );
                 }
 
 
                 void SetOnInitialize(
                     TOnThreadEvent value
                 ) override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    _onInitialize = value;
+                    _setCallback(
+                        &Callbacks::OnInitialize,
+                        std::move(value)
+                    );
                 }
 
 
                 void SetOnStart(
                     TOnThreadEvent value
                 ) override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    _onStart = value;
+                    _setCallback(
+                        &Callbacks::OnStart,
+                        std::move(value)
+                    );
                 }
 
 
                 void SetOnPause(
                     TOnThreadEvent value
                 ) override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    _onPause = value;
+                    _setCallback(
+                        &Callbacks::OnPause,
+                        std::move(value)
+                    );
                 }
 
 
                 void SetOnTerminate(
                     TOnThreadEvent value
                 ) override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    _onTerminate = value;
+                    _setCallback(
+                        &Callbacks::OnTerminate,
+                        std::move(value)
+                    );
                 }
 
 
                 void SetOnTerminated(
                     TOnThreadEvent value
                 ) override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    _onTerminated = value;
+                    _setCallback(
+                        &Callbacks::OnTerminated,
+                        std::move(value)
+                    );
                 }
 
 
@@ -1822,12 +3571,10 @@ namespace ESPressio {
                     TOnThreadInitializationFailedEvent
                         value
                 ) override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    _onInitializationFailed =
-                        value;
+                    _setCallback(
+                        &Callbacks::OnInitializationFailed,
+                        std::move(value)
+                    );
                 }
 
 
@@ -1835,12 +3582,10 @@ namespace ESPressio {
                     TOnThreadExecutionFailedEvent
                         value
                 ) override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    _onExecutionFailed =
-                        value;
+                    _setCallback(
+                        &Callbacks::OnExecutionFailed,
+                        std::move(value)
+                    );
                 }
 
 
@@ -1848,12 +3593,10 @@ namespace ESPressio {
                     TOnThreadStateChangeEvent
                         value
                 ) override {
-                    std::lock_guard<
-                        std::mutex
-                    > lock(_callbackMutex);
-
-                    _onStateChange =
-                        value;
+                    _setCallback(
+                        &Callbacks::OnStateChange,
+                        std::move(value)
+                    );
                 }
         };
 
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "ESPressio_Thread.hpp"
+
+namespace ESPressio {
+
+    namespace Threads {
+
+        /*
+         * Compile-time policies for ThreadBase and PrecisionThreadBase.
+         *
+         * Policies are empty tag types passed as trailing template
+         * arguments, in any order.
+         */
+        namespace ThreadPolicy {
+
+            // PrecisionThreadBase only. Iteration observers are neither
+            // registrable nor notified.
+            struct NoObservers {};
+
+            // PrecisionThreadBase only. Iteration times and timing
+            // statistics are neither recorded nor stored.
+            struct NoMeasurements {};
+
+            // The loop state is re-read only every `TIterations` loop
+            // bodies. State changes then take effect up to
+            // `TIterations - 1` iterations late.
+            template <uint32_t TIterations>
+            struct StateCheckInterval {};
+
+        }
+
+
+        template <
+            typename TPolicy,
+            typename... TPolicies
+        >
+        struct HasThreadPolicy :
+            std::disjunction<
+                std::is_same<
+                    TPolicy,
+                    TPolicies
+                >...
+            > {};
+
+
+        template <typename... TPolicies>
+        struct ThreadStateCheckInterval {
+            static constexpr uint32_t Value = 1;
+        };
+
+        template <
+            uint32_t TIterations,
+            typename... TPolicies
+        >
+        struct ThreadStateCheckInterval<
+            ThreadPolicy::StateCheckInterval<TIterations>,
+            TPolicies...
+        > {
+            static constexpr uint32_t Value = TIterations;
+        };
+
+        template <
+            typename TPolicy,
+            typename... TPolicies
+        >
+        struct ThreadStateCheckInterval<
+            TPolicy,
+            TPolicies...
+        > :
+            ThreadStateCheckInterval<TPolicies...> {};
+
+
+        /*
+         * Statically dispatched Thread.
+         *
+         * `Thread` calls the virtual `OnLoop()` once per iteration and
+         * re-reads the state in between. ThreadBase enters `OnLoop()` once
+         * per Running period and calls `TDerived::Loop()` directly in a
+         * tight loop, so the loop body can be inlined. The lifecycle,
+         * manager, observers and cleanup behave exactly as for `Thread`.
+         *
+         *   class Blinker : public ThreadBase<Blinker> {
+         *       public:
+         *           void Loop() { ... }
+         *   };
+         *
+         * `Loop()` must be accessible to ThreadBase: public, or declared
+         * with `friend class ThreadBase<Blinker>`. A plain Thread has no
+         * per-iteration observers or measurements, so `NoObservers` and
+         * `NoMeasurements` are rejected here.
+         */
+        template <
+            typename TDerived,
+            typename... TPolicies
+        >
+        class ThreadBase : public Thread {
+            public:
+                static constexpr uint32_t StateCheckInterval =
+                    ThreadStateCheckInterval<
+                        TPolicies...
+                    >::Value;
+
+                static_assert(
+                    StateCheckInterval > 0,
+                    "StateCheckInterval must be at least 1"
+                );
+
+                static_assert(
+                    !HasThreadPolicy<
+                        ThreadPolicy::NoObservers,
+                        TPolicies...
+                    >::value &&
+                    !HasThreadPolicy<
+                        ThreadPolicy::NoMeasurements,
+                        TPolicies...
+                    >::value,
+                    "NoObservers and NoMeasurements apply only to "
+                    "PrecisionThreadBase"
+                );
+
+
+            protected:
+                void OnLoop() final override {
+                    TDerived& derived =
+                        static_cast<TDerived&>(
+                            *this
+                        );
+
+                    do {
+                        const LoopSample sample =
+                            BeginLoopSample();
+
+                        for (
+                            uint32_t iteration = 0;
+                            iteration < StateCheckInterval;
+                            ++iteration
+                        ) {
+                            derived.TDerived::Loop();
+                        }
+
+                        EndLoopSample(
+                            sample,
+                            StateCheckInterval
+                        );
+                    } while (
+                        ContinueLoop()
+                    );
+                }
+
+
+            public:
+                ThreadBase() = default;
+
+
+                explicit ThreadBase(
+                    bool freeOnTerminate
+                ) :
+                    Thread(
+                        freeOnTerminate
+                    ) {
+                }
+        };
+
+    }
+
+}
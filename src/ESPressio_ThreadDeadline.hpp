@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "ESPressio_ClockTypes.hpp"
+
+// 1 where the sub-tick remainder of a deadline can be slept with
+// clock_nanosleep(TIMER_ABSTIME) rather than spun.
+#ifndef ESPRESSIO_THREAD_DEADLINE_NANOSLEEP
+    #if !defined(ESP_PLATFORM) && defined(__linux__)
+        #define ESPRESSIO_THREAD_DEADLINE_NANOSLEEP 1
+    #else
+        #define ESPRESSIO_THREAD_DEADLINE_NANOSLEEP 0
+    #endif
+#endif
+
+// 1 to land on a deadline itself instead of the first tick boundary past it.
+// Without nanosleep the sub-tick remainder is spun with taskYIELD(), which
+// only hands the core to tasks of equal priority: lower priorities, IDLE and
+// the task watchdog starve for up to a tick per wait. It is therefore off by
+// default on targets, where waits may end up to one tick late instead.
+#ifndef ESPRESSIO_THREAD_DEADLINE_SPIN
+    #define ESPRESSIO_THREAD_DEADLINE_SPIN ESPRESSIO_THREAD_DEADLINE_NANOSLEEP
+#endif
+
+#if ESPRESSIO_THREAD_DEADLINE_NANOSLEEP
+    #include <cerrno>
+    #include <time.h>
+#endif
+
+namespace ESPressio {
+namespace Threads {
+
+    enum class DeadlineWaitResult : uint8_t {
+        // The deadline passed.
+        Reached,
+
+        // `signal` was given first.
+        Signalled,
+
+        // The tick-rounded block ended before `now()` reached the deadline;
+        // only without ESPRESSIO_THREAD_DEADLINE_SPIN. Waiting again ends on
+        // the next tick boundary.
+        TickBoundary
+    };
+
+
+    /*
+     * Blocks the calling task until an absolute deadline, in nanoseconds on
+     * the timeline of `now()`, or until `signal` is given.
+     *
+     * The wait is worked out once from the deadline. By default on targets
+     * the task blocks on `signal` for the ticks the deadline rounds up to.
+     * Ticks start on a boundary, not at `now()`, so that block can end up to
+     * a tick early; TickBoundary reports it rather than claiming Reached. With
+     * ESPRESSIO_THREAD_DEADLINE_SPIN it blocks for the whole ticks before it
+     * and then covers the sub-tick remainder itself, with
+     * clock_nanosleep(TIMER_ABSTIME) where available and otherwise by
+     * yielding until `now()` reaches it. A caller therefore wakes once per
+     * deadline instead of polling its own state toward it. `signal` is still
+     * noticed during the remainder, though a nanosleep is only checked once
+     * it ends.
+     *
+     * vTaskDelayUntil() is not used because nothing could cut it short;
+     * callers rely on `signal` to be woken for pauses, reconfiguration and
+     * termination.
+     */
+    template <typename TNow>
+    DeadlineWaitResult WaitForDeadline(
+        SemaphoreHandle_t signal,
+        uint64_t deadlineNanoseconds,
+        TNow&& now
+    ) {
+        static_assert(
+            configTICK_RATE_HZ > 0 &&
+                configTICK_RATE_HZ <= Timing::NanosecondsPerSecond,
+            "configTICK_RATE_HZ must be between 1 Hz and 1 GHz"
+        );
+
+        // portTICK_PERIOD_MS truncates, and is 0 above 1000 Hz.
+        constexpr uint64_t tickNanoseconds =
+            Timing::NanosecondsPerSecond /
+            static_cast<uint64_t>(configTICK_RATE_HZ);
+
+        uint64_t current =
+            now();
+
+        if (current >= deadlineNanoseconds) {
+            return DeadlineWaitResult::Reached;
+        }
+
+        const uint64_t remaining =
+            deadlineNanoseconds -
+            current;
+
+        #if ESPRESSIO_THREAD_DEADLINE_SPIN
+            const uint64_t blockTicks =
+                remaining /
+                tickNanoseconds;
+        #else
+            const uint64_t blockTicks =
+                (remaining + tickNanoseconds - 1) /
+                tickNanoseconds;
+        #endif
+
+        if (blockTicks > 0) {
+            const TickType_t ticks =
+                blockTicks >= portMAX_DELAY
+                    ? static_cast<TickType_t>(
+                        portMAX_DELAY - 1
+                      )
+                    : static_cast<TickType_t>(
+                        blockTicks
+                      );
+
+            if (
+                xSemaphoreTake(
+                    signal,
+                    ticks
+                ) == pdTRUE
+            ) {
+                return DeadlineWaitResult::Signalled;
+            }
+
+            current = now();
+
+            if (current >= deadlineNanoseconds) {
+                return DeadlineWaitResult::Reached;
+            }
+        }
+
+        #if !ESPRESSIO_THREAD_DEADLINE_SPIN
+            return DeadlineWaitResult::TickBoundary;
+        #elif ESPRESSIO_THREAD_DEADLINE_NANOSLEEP
+            // Maps the deadline onto CLOCK_MONOTONIC once, then sleeps to it.
+            timespec target;
+
+            clock_gettime(
+                CLOCK_MONOTONIC,
+                &target
+            );
+
+            const uint64_t monotonicDeadline =
+                static_cast<uint64_t>(target.tv_sec) *
+                    Timing::NanosecondsPerSecond +
+                static_cast<uint64_t>(target.tv_nsec) +
+                (deadlineNanoseconds - current);
+
+            target.tv_sec =
+                static_cast<time_t>(
+                    monotonicDeadline /
+                    Timing::NanosecondsPerSecond
+                );
+
+            target.tv_nsec =
+                static_cast<long>(
+                    monotonicDeadline %
+                    Timing::NanosecondsPerSecond
+                );
+
+            while (
+                clock_nanosleep(
+                    CLOCK_MONOTONIC,
+                    TIMER_ABSTIME,
+                    &target,
+                    nullptr
+                ) == EINTR
+            ) {
+            }
+
+            return
+                xSemaphoreTake(
+                    signal,
+                    0
+                ) == pdTRUE
+                    ? DeadlineWaitResult::Signalled
+                    : DeadlineWaitResult::Reached;
+        #else
+            while (now() < deadlineNanoseconds) {
+                if (
+                    xSemaphoreTake(
+                        signal,
+                        0
+                    ) == pdTRUE
+                ) {
+                    return DeadlineWaitResult::Signalled;
+                }
+
+                taskYIELD();
+            }
+
+            return DeadlineWaitResult::Reached;
+        #endif
+    }
+
+}
+}
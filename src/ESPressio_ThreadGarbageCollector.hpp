@@ -11,6 +11,9 @@
 #include "ESPressio_ThreadManager.hpp"
 #include "ESPressio_IThreadGarbageCollector.hpp"
 #include "ESPressio_ThreadSafeObservable.hpp"
+#include "ESPressio_ThreadTerminationDispatcher.hpp"
+#include "ESPressio_ThreadMetrics.hpp"
+#include "ESPressio_ThreadTrace.hpp"
 
 #ifndef ESPRESSIO_THREAD_GARBAGE_COLLECTOR_STACK_SIZE
     #define ESPRESSIO_THREAD_GARBAGE_COLLECTOR_STACK_SIZE 2000
@@ -184,55 +187,75 @@ namespace Threads {
             >();
 
 
-        ThreadGarbageCollector() {
-            const bool available =
-                _initialize();
+        bool _initializationAttempted = false;
 
-            if (available) {
-                _observable->Initialized(true);
-            } else {
-                _observable->InitializationFailed();
-            }
-        }
+
+        // The worker task is created on the first cleanup request rather
+        // than at construction.
+        ThreadGarbageCollector() = default;
 
 
         bool _initialize() {
-            if (
-                _semaphore != nullptr &&
-                _taskHandle != nullptr
-            ) {
-                return true;
-            }
+            _initializationAttempted = true;
 
-            _semaphore =
-                xSemaphoreCreateBinary();
+            #if ESPRESSIO_THREAD_UNIFIED_INFRASTRUCTURE
+                // The termination dispatcher task also runs collection.
+                return
+                    ThreadTerminationDispatcher::
+                        GetInstance()->
+                        EnsureStarted();
+            #else
+                if (
+                    _semaphore != nullptr &&
+                    _taskHandle != nullptr
+                ) {
+                    return true;
+                }
 
-            if (_semaphore == nullptr) {
-                return false;
-            }
+                _semaphore =
+                    xSemaphoreCreateBinary();
 
-            const BaseType_t result =
-                xTaskCreate(
-                    _taskEntry,
-                    "threadGarbageCollector",
-                    ESPRESSIO_THREAD_GARBAGE_COLLECTOR_STACK_SIZE,
-                    this,
-                    ESPRESSIO_THREAD_GARBAGE_COLLECTOR_PRIORITY,
-                    &_taskHandle
-                );
+                if (_semaphore == nullptr) {
+                    return false;
+                }
 
-            if (result != pdPASS) {
-                vSemaphoreDelete(
-                    _semaphore
-                );
+                const BaseType_t result =
+                    xTaskCreate(
+                        _taskEntry,
+                        "threadGarbageCollector",
+                        ESPRESSIO_THREAD_GARBAGE_COLLECTOR_STACK_SIZE,
+                        this,
+                        ESPRESSIO_THREAD_GARBAGE_COLLECTOR_PRIORITY,
+                        &_taskHandle
+                    );
 
-                _semaphore = nullptr;
-                _taskHandle = nullptr;
+                if (result != pdPASS) {
+                    vSemaphoreDelete(
+                        _semaphore
+                    );
 
-                return false;
-            }
+                    _semaphore = nullptr;
+                    _taskHandle = nullptr;
 
-            return true;
+                    return false;
+                }
+
+                return true;
+            #endif
+        }
+
+
+        bool _isAvailableLocked() const {
+            #if ESPRESSIO_THREAD_UNIFIED_INFRASTRUCTURE
+                return
+                    ThreadTerminationDispatcher::
+                        GetInstance()->
+                        IsAvailable();
+            #else
+                return
+                    _semaphore != nullptr &&
+                    _taskHandle != nullptr;
+            #endif
         }
 
 
@@ -263,52 +286,104 @@ namespace Threads {
                     continue;
                 }
 
-                ThreadGarbageCollectionResult result;
-
-                result.ExecutionMode =
+                _collect(
                     ThreadGarbageCollectionExecutionMode::
-                        AsynchronousWorker;
+                        AsynchronousWorker
+                );
+            }
+        }
 
-                result.InfrastructureAvailable =
-                    true;
 
-                result.RequestQueued =
-                    true;
+        void _collect(
+            ThreadGarbageCollectionExecutionMode mode
+        ) {
+            ThreadGarbageCollectionResult result;
+
+            result.ExecutionMode = mode;
+
+            result.InfrastructureAvailable =
+                mode ==
+                ThreadGarbageCollectionExecutionMode::
+                    AsynchronousWorker;
+
+            result.RequestQueued =
+                result.InfrastructureAvailable;
 
+            if (result.InfrastructureAvailable) {
                 _observable->Started(
                     result
                 );
+            } else {
+                _observable->FallbackStarted(
+                    result
+                );
+            }
 
-                try {
-                    result.ManagerResult =
-                        ThreadManager::
-                            GetInstance()->
-                            CleanUpWithResult();
+            RecordThreadTrace(
+                ThreadTraceEventType::CollectBegin,
+                0
+            );
 
-                    result.Completed =
-                        !result.ManagerResult.WasDeferred;
+            #if ESPRESSIO_THREAD_METRICS
+                const uint64_t collectStartNanoseconds =
+                    ThreadMetrics::GetNowNanoseconds();
+            #endif
 
-                    _observable->Completed(
-                        result
-                    );
-                } catch (...) {
-                    result.Failed = true;
+            try {
+                result.ManagerResult =
+                    ThreadManager::
+                        GetInstance()->
+                        CleanUpWithResult();
 
-                    _observable->Failed(
-                        result,
-                        std::current_exception()
-                    );
+                result.Completed =
+                    !result.ManagerResult.WasDeferred;
 
-                    /*
-                     * A custom IThread failure must not terminate the
-                     * infrastructure worker. A later request may succeed.
-                     */
-                }
+                _observable->Completed(
+                    result
+                );
+            } catch (...) {
+                result.Failed = true;
+
+                _observable->Failed(
+                    result,
+                    std::current_exception()
+                );
+
+                /*
+                 * A custom IThread failure must not terminate the
+                 * infrastructure worker, and infrastructure failures do
+                 * not propagate from a cleanup request. A later request
+                 * may succeed.
+                 */
             }
+
+            RecordThreadTrace(
+                ThreadTraceEventType::CollectEnd,
+                0,
+                static_cast<uint32_t>(
+                    result.ManagerResult.ThreadsDeleted
+                )
+            );
+
+            #if ESPRESSIO_THREAD_METRICS
+                const uint64_t collectEndNanoseconds =
+                    ThreadMetrics::GetNowNanoseconds();
+
+                ThreadMetrics::GetInstance()->
+                    GarbageCollectionDuration.Record(
+                        collectEndNanoseconds >= collectStartNanoseconds
+                            ? collectEndNanoseconds - collectStartNanoseconds
+                            : 0
+                    );
+            #endif
         }
 
 
     public:
+        friend class
+            ThreadTerminationDispatcher;
+
+
         static ThreadGarbageCollector*
         GetInstance() {
             static ThreadGarbageCollector
@@ -336,16 +411,42 @@ namespace Threads {
                 _initializationMutex
             );
 
-            return
-                _semaphore != nullptr &&
-                _taskHandle != nullptr;
+            return _isAvailableLocked();
         }
 
 
-        void CleanUp() override {
-            SemaphoreHandle_t semaphore =
-                nullptr;
+        /// Returns the least free stack the collector task has had, in
+        /// ESPRESSIO_THREAD_GARBAGE_COLLECTOR_STACK_SIZE units, or 0 before
+        /// the task exists. With unified infrastructure this reports the
+        /// termination dispatcher task, which runs collection.
+        uint32_t GetStackHighWaterMark() const {
+            #if ESPRESSIO_THREAD_UNIFIED_INFRASTRUCTURE
+                return
+                    ThreadTerminationDispatcher::
+                        GetInstance()->
+                        GetStackHighWaterMark();
+            #else
+                std::lock_guard<
+                    std::mutex
+                > lock(
+                    _initializationMutex
+                );
 
+                if (_taskHandle == nullptr) {
+                    return 0;
+                }
+
+                return
+                    static_cast<uint32_t>(
+                        uxTaskGetStackHighWaterMark(
+                            _taskHandle
+                        )
+                    );
+            #endif
+        }
+
+
+        void CleanUp() override {
             bool infrastructureAvailable =
                 false;
 
@@ -356,9 +457,11 @@ namespace Threads {
                     _initializationMutex
                 );
 
+                const bool firstAttempt =
+                    !_initializationAttempted;
+
                 const bool wasAvailable =
-                    _semaphore != nullptr &&
-                    _taskHandle != nullptr;
+                    _isAvailableLocked();
 
                 infrastructureAvailable =
                     _initialize();
@@ -370,15 +473,15 @@ namespace Threads {
                     _observable->Initialized(
                         true
                     );
-                }
-
-                if (infrastructureAvailable) {
-                    semaphore =
-                        _semaphore;
+                } else if (
+                    firstAttempt &&
+                    !infrastructureAvailable
+                ) {
+                    _observable->InitializationFailed();
                 }
             }
 
-            if (semaphore != nullptr) {
+            if (infrastructureAvailable) {
                 _observable->Requested(
                     ThreadGarbageCollectionExecutionMode::
                         AsynchronousWorker
@@ -393,10 +496,25 @@ namespace Threads {
                 result.InfrastructureAvailable =
                     true;
 
-                result.RequestQueued =
-                    xSemaphoreGive(
-                        semaphore
-                    ) == pdTRUE;
+                #if ESPRESSIO_THREAD_UNIFIED_INFRASTRUCTURE
+                    bool coalesced = false;
+
+                    const bool requested =
+                        ThreadTerminationDispatcher::
+                            GetInstance()->
+                            RequestGarbageCollection(
+                                &coalesced
+                            );
+
+                    result.RequestQueued =
+                        requested &&
+                        !coalesced;
+                #else
+                    result.RequestQueued =
+                        xSemaphoreGive(
+                            _semaphore
+                        ) == pdTRUE;
+                #endif
 
                 if (result.RequestQueued) {
                     _observable->Queued(
@@ -404,7 +522,7 @@ namespace Threads {
                     );
                 } else {
                     /*
-                     * The binary semaphore is already pending. This request
+                     * A collection request is already pending. This request
                      * has been coalesced into the existing cleanup request.
                      */
                     _observable->Coalesced(
@@ -420,44 +538,10 @@ namespace Threads {
                     SynchronousFallback
             );
 
-            ThreadGarbageCollectionResult result;
-
-            result.ExecutionMode =
+            _collect(
                 ThreadGarbageCollectionExecutionMode::
-                    SynchronousFallback;
-
-            result.InfrastructureAvailable =
-                false;
-
-            _observable->FallbackStarted(
-                result
+                    SynchronousFallback
             );
-
-            try {
-                result.ManagerResult =
-                    ThreadManager::
-                        GetInstance()->
-                        CleanUpWithResult();
-
-                result.Completed =
-                    !result.ManagerResult.WasDeferred;
-
-                _observable->Completed(
-                    result
-                );
-            } catch (...) {
-                result.Failed = true;
-
-                _observable->Failed(
-                    result,
-                    std::current_exception()
-                );
-
-                /*
-                 * Preserve the existing cleanup contract: infrastructure
-                 * failures do not propagate from a cleanup request.
-                 */
-            }
         }
 
 
@@ -470,9 +554,31 @@ namespace Threads {
                     observer
                 );
 
-            if (observer != nullptr) {
+            bool attempted = false;
+            bool available = false;
+
+            {
+                std::lock_guard<
+                    std::mutex
+                > lock(
+                    _initializationMutex
+                );
+
+                attempted =
+                    _initializationAttempted;
+
+                available =
+                    _isAvailableLocked();
+            }
+
+            // Before the first cleanup request there is nothing to report
+            // yet; the observer is notified when the worker is created.
+            if (
+                observer != nullptr &&
+                attempted
+            ) {
                 try {
-                    if (IsAvailable()) {
+                    if (available) {
                         observer->
                             OnThreadGarbageCollectorInitialized(
                                 true
@@ -2,7 +2,11 @@
 
 // define CORE_THREADING_DEBUG in your project to enable debugging!
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <exception>
 #include <functional>
@@ -10,11 +14,29 @@
 #include <mutex>
 #include <vector>
 #include <memory>
+#include <utility>
 
 #include "ESPressio_ThreadSafe.hpp"
 #include "ESPressio_ThreadSafeObservable.hpp"
 #include "ESPressio_IThreadManagerObserver.hpp"
+#include "ESPressio_IThreadPlacementPolicy.hpp"
 #include "ESPressio_IThread.hpp"
+#include "ESPressio_ThreadMetrics.hpp"
+
+// The periodic sampler task is created on the first StartSampling() call.
+#ifndef ESPRESSIO_THREAD_MANAGER_SAMPLER_STACK_SIZE
+    #define ESPRESSIO_THREAD_MANAGER_SAMPLER_STACK_SIZE 3000
+#endif
+
+#ifndef ESPRESSIO_THREAD_MANAGER_SAMPLER_PRIORITY
+    #define ESPRESSIO_THREAD_MANAGER_SAMPLER_PRIORITY 1
+#endif
+
+// Rebalance() only migrates when the busiest and idlest cores differ by more
+// than this load, in thousandths of a core.
+#ifndef ESPRESSIO_THREAD_REBALANCE_THRESHOLD_PERMILLE
+    #define ESPRESSIO_THREAD_REBALANCE_THRESHOLD_PERMILLE 200
+#endif
 
 namespace ESPressio {
 
@@ -31,16 +53,40 @@ namespace ESPressio {
                 class ManagerObservable final :
                     public Observable::ThreadSafeObservable {
                 private:
+                    ObserverInterestTable<
+                        IThreadManagerObserver
+                    > _interests;
+
+
                     template <typename TCallback>
                     void NotifyObservers(
+                        ThreadManagerObserverEvents event,
                         TCallback callback
                     ) {
+                        if (!_interests.IsAnyInterested(event)) {
+                            return;
+                        }
+
+                        ObserverInterestTable<
+                            IThreadManagerObserver
+                        >::Filter filter =
+                            _interests.GetFilter();
+
                         ExecuteNotification(
                             [&](NotificationContext& notification) {
                                 notification.WithObservers<
                                     IThreadManagerObserver
                                 >(
                                     [&](IThreadManagerObserver* observer) {
+                                        if (
+                                            !filter.Accepts(
+                                                observer,
+                                                event
+                                            )
+                                        ) {
+                                            return;
+                                        }
+
                                         try {
                                             callback(observer);
                                         } catch (...) {
@@ -54,11 +100,42 @@ namespace ESPressio {
                     }
 
                 public:
+                    bool IsInterested(
+                        ThreadManagerObserverEvents events
+                    ) const {
+                        return
+                            _interests.IsAnyInterested(
+                                events
+                            );
+                    }
+
+
+                    void SetInterests(
+                        IThreadManagerObserver* observer,
+                        ThreadManagerObserverEvents events
+                    ) {
+                        _interests.Set(
+                            observer,
+                            events
+                        );
+                    }
+
+
+                    void RemoveInterests(
+                        IThreadManagerObserver* observer
+                    ) {
+                        _interests.Remove(
+                            observer
+                        );
+                    }
+
+
                     void ThreadRegistered(
                         IThread* thread,
                         const ThreadManagerThreadSnapshot& snapshot
                     ) {
                         NotifyObservers(
+                            ThreadManagerObserverEvent::Registered,
                             [&](IThreadManagerObserver* observer) {
                                 observer->OnThreadRegistered(
                                     thread,
@@ -73,6 +150,7 @@ namespace ESPressio {
                         std::exception_ptr cause
                     ) {
                         NotifyObservers(
+                            ThreadManagerObserverEvent::RegistrationFailed,
                             [&](IThreadManagerObserver* observer) {
                                 observer->OnThreadRegistrationFailed(
                                     thread,
@@ -86,6 +164,7 @@ namespace ESPressio {
                         const ThreadManagerThreadSnapshot& snapshot
                     ) {
                         NotifyObservers(
+                            ThreadManagerObserverEvent::Removed,
                             [&](IThreadManagerObserver* observer) {
                                 observer->OnThreadRemoved(snapshot);
                             }
@@ -97,6 +176,7 @@ namespace ESPressio {
                         const ThreadManagerThreadSnapshot& snapshot
                     ) {
                         NotifyObservers(
+                            ThreadManagerObserverEvent::CleanupClaimed,
                             [&](IThreadManagerObserver* observer) {
                                 observer->OnThreadCleanupClaimed(
                                     thread,
@@ -110,6 +190,7 @@ namespace ESPressio {
                         const ThreadManagerCleanupResult& result
                     ) {
                         NotifyObservers(
+                            ThreadManagerObserverEvent::CleanupDeferred,
                             [&](IThreadManagerObserver* observer) {
                                 observer->OnThreadCleanupDeferred(result);
                             }
@@ -120,6 +201,7 @@ namespace ESPressio {
                         const ThreadManagerCleanupResult& result
                     ) {
                         NotifyObservers(
+                            ThreadManagerObserverEvent::CleanupStarted,
                             [&](IThreadManagerObserver* observer) {
                                 observer->OnThreadCleanupStarted(result);
                             }
@@ -130,6 +212,7 @@ namespace ESPressio {
                         const ThreadManagerCleanupResult& result
                     ) {
                         NotifyObservers(
+                            ThreadManagerObserverEvent::CleanupCompleted,
                             [&](IThreadManagerObserver* observer) {
                                 observer->OnThreadCleanupCompleted(result);
                             }
@@ -141,6 +224,7 @@ namespace ESPressio {
                         std::exception_ptr cause
                     ) {
                         NotifyObservers(
+                            ThreadManagerObserverEvent::CleanupFailed,
                             [&](IThreadManagerObserver* observer) {
                                 observer->OnThreadCleanupFailed(
                                     result,
@@ -154,6 +238,7 @@ namespace ESPressio {
                         const ThreadManagerInitializationResult& result
                     ) {
                         NotifyObservers(
+                            ThreadManagerObserverEvent::InitializationCompleted,
                             [&](IThreadManagerObserver* observer) {
                                 observer->OnThreadManagerInitializationCompleted(
                                     result
@@ -161,6 +246,38 @@ namespace ESPressio {
                             }
                         );
                     }
+
+                    void MigrationRequested(
+                        IThread* thread,
+                        const ThreadManagerThreadSnapshot& snapshot,
+                        int targetCoreID
+                    ) {
+                        NotifyObservers(
+                            ThreadManagerObserverEvent::MigrationRequested,
+                            [&](IThreadManagerObserver* observer) {
+                                observer->OnThreadMigrationRequested(
+                                    thread,
+                                    snapshot,
+                                    targetCoreID
+                                );
+                            }
+                        );
+                    }
+
+                    void RuntimeSampled(
+                        IThread* thread,
+                        const ThreadRuntimeSnapshot& snapshot
+                    ) {
+                        NotifyObservers(
+                            ThreadManagerObserverEvent::RuntimeSampled,
+                            [&](IThreadManagerObserver* observer) {
+                                observer->OnThreadRuntimeSampled(
+                                    thread,
+                                    snapshot
+                                );
+                            }
+                        );
+                    }
                 };
 
 
@@ -168,6 +285,7 @@ namespace ESPressio {
                     uint8_t id;
                     IThread* thread;
                     int coreID;
+                    uint8_t affinityGroup = 0;
 
                     bool operator==(
                         const ThreadRecord& other
@@ -175,7 +293,8 @@ namespace ESPressio {
                         return
                             id == other.id &&
                             thread == other.thread &&
-                            coreID == other.coreID;
+                            coreID == other.coreID &&
+                            affinityGroup == other.affinityGroup;
                     }
                 };
 
@@ -191,10 +310,149 @@ namespace ESPressio {
                 std::size_t _activeIterations = 0;
                 bool _cleanupPending = false;
 
+                /*
+                 * A pin keeps a Thread from being destroyed while the manager
+                 * calls into it from a copy of the registry. Pins are taken
+                 * under the registry read lock, so none can be taken once
+                 * RemoveThread() has erased the record, and RemoveThread()
+                 * waits for the existing ones before it returns. Thread
+                 * removes itself first thing in its destructor.
+                 */
+                struct ThreadPin {
+                    IThread* thread;
+                    TaskHandle_t owner;
+                    bool removed;
+                };
+
+                std::mutex _pinMutex;
+                std::vector<ThreadPin> _pins;
+
                 std::shared_ptr<ManagerObservable>
                     _observable =
                         std::make_shared<ManagerObservable>();
 
+                // 0 while sampling is stopped. The sampler task, once
+                // created, lives as long as the manager.
+                std::atomic<uint32_t>
+                    _samplingIntervalMilliseconds{
+                        0
+                    };
+
+                std::mutex _samplerMutex;
+                TaskHandle_t _samplerTask = nullptr;
+
+                // Serializes placement, so policies need no locking.
+                std::mutex _placementMutex;
+                IThreadPlacementPolicy* _placementPolicy = nullptr;
+
+                // Counters from the previous Rebalance(), so it measures the
+                // load of the last interval rather than since start. Guarded
+                // by `_placementMutex`. Entries match on ID and address, and
+                // RemoveThread() drops the removed Thread's, so a later
+                // Thread reusing either starts afresh.
+                struct RebalanceSample {
+                    uint8_t id;
+                    IThread* thread;
+                    int coreID;
+                    bool pinned;
+                    uint64_t cpuNanoseconds;
+                    uint64_t runningNanoseconds;
+                };
+
+                std::vector<
+                    RebalanceSample
+                > _rebalanceSamples;
+
+                std::atomic<bool>
+                    _rebalancingEnabled{
+                        false
+                    };
+
+
+                // Registry access. With ESPRESSIO_THREAD_METRICS the wait
+                // for the lock is recorded in ThreadMetrics::ManagerLockWait.
+                template <
+                    typename TCallback
+                >
+                void _withThreadsWriteLock(
+                    TCallback&& callback
+                ) {
+                    #if ESPRESSIO_THREAD_METRICS
+                        const uint64_t requestedNanoseconds =
+                            ThreadMetrics::GetNowNanoseconds();
+
+                        _threads.WithWriteLock(
+                            [&](
+                                std::vector<
+                                    ThreadRecord
+                                >& threads
+                            ) {
+                                _recordLockWait(
+                                    requestedNanoseconds
+                                );
+
+                                callback(
+                                    threads
+                                );
+                            }
+                        );
+                    #else
+                        _threads.WithWriteLock(
+                            std::forward<TCallback>(callback)
+                        );
+                    #endif
+                }
+
+
+                template <
+                    typename TCallback
+                >
+                void _withThreadsSharedReadLock(
+                    TCallback&& callback
+                ) {
+                    #if ESPRESSIO_THREAD_METRICS
+                        const uint64_t requestedNanoseconds =
+                            ThreadMetrics::GetNowNanoseconds();
+
+                        _threads.WithSharedReadLock(
+                            [&](
+                                const std::vector<
+                                    ThreadRecord
+                                >& threads
+                            ) {
+                                _recordLockWait(
+                                    requestedNanoseconds
+                                );
+
+                                callback(
+                                    threads
+                                );
+                            }
+                        );
+                    #else
+                        _threads.WithSharedReadLock(
+                            std::forward<TCallback>(callback)
+                        );
+                    #endif
+                }
+
+
+                #if ESPRESSIO_THREAD_METRICS
+                    static void _recordLockWait(
+                        uint64_t requestedNanoseconds
+                    ) {
+                        const uint64_t acquiredNanoseconds =
+                            ThreadMetrics::GetNowNanoseconds();
+
+                        ThreadMetrics::GetInstance()->
+                            ManagerLockWait.Record(
+                                acquiredNanoseconds >= requestedNanoseconds
+                                    ? acquiredNanoseconds - requestedNanoseconds
+                                    : 0
+                            );
+                    }
+                #endif
+
 
                 static ThreadManagerThreadSnapshot
                 _snapshot(
@@ -204,6 +462,7 @@ namespace ESPressio {
 
                     snapshot.ThreadID = record.id;
                     snapshot.CoreID = record.coreID;
+                    snapshot.AffinityGroup = record.affinityGroup;
 
                     if (record.thread != nullptr) {
                         try {
@@ -292,129 +551,576 @@ namespace ESPressio {
                 };
 
 
-                static int _getCoreCount() {
-                    #if defined(portNUM_PROCESSORS)
-                        return
-                            portNUM_PROCESSORS > 0
-                                ? portNUM_PROCESSORS
-                                : 1;
-                    #elif defined(configNUMBER_OF_CORES)
-                        return
-                            configNUMBER_OF_CORES > 0
-                                ? configNUMBER_OF_CORES
-                                : 1;
-                    #else
-                        return 1;
-                    #endif
+                // Copies the registry and pins every Thread in it for the
+                // calling task.
+                std::vector<
+                    ThreadRecord
+                > _pinThreads() {
+                    const TaskHandle_t owner =
+                        xTaskGetCurrentTaskHandle();
+
+                    std::vector<
+                        ThreadRecord
+                    > records;
+
+                    _withThreadsSharedReadLock(
+                        [this, owner, &records](
+                            const std::vector<
+                                ThreadRecord
+                            >& threads
+                        ) {
+                            records = threads;
+
+                            std::lock_guard<
+                                std::mutex
+                            > lock(_pinMutex);
+
+                            for (
+                                const ThreadRecord& record :
+                                threads
+                            ) {
+                                _pins.push_back({
+                                    record.thread,
+                                    owner,
+                                    false
+                                });
+                            }
+                        }
+                    );
+
+                    return records;
                 }
 
 
-            protected:
-                ThreadManager() :
-                    _threads(
-                        std::vector<
-                            ThreadRecord
-                        >()
+                void _unpinThreads(
+                    const std::vector<
+                        ThreadRecord
+                    >& records
+                ) {
+                    const TaskHandle_t owner =
+                        xTaskGetCurrentTaskHandle();
+
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_pinMutex);
+
+                    for (
+                        const ThreadRecord& record :
+                        records
                     ) {
+                        const auto pin =
+                            std::find_if(
+                                _pins.begin(),
+                                _pins.end(),
+                                [&record, owner](const ThreadPin& candidate) {
+                                    return
+                                        candidate.thread == record.thread &&
+                                        candidate.owner == owner;
+                                }
+                            );
+
+                        if (pin != _pins.end()) {
+                            _pins.erase(pin);
+                        }
+                    }
                 }
 
 
-            public:
-                static ThreadManager*
-                GetInstance() {
-                    // Process-lifetime by design: destroying the manager
-                    // during static teardown could race static Thread objects
-                    // and already-stopped FreeRTOS infrastructure.
-                    static ThreadManager* instance =
-                        new ThreadManager();
+                // Whether `thread` was removed while the calling task held
+                // a pin on it. A pin cannot hold back a destructor running
+                // on its own task, such as one started from an observer.
+                bool _isPinRemoved(
+                    IThread* thread
+                ) {
+                    const TaskHandle_t owner =
+                        xTaskGetCurrentTaskHandle();
 
-                    return instance;
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_pinMutex);
+
+                    return
+                        std::any_of(
+                            _pins.begin(),
+                            _pins.end(),
+                            [thread, owner](const ThreadPin& pin) {
+                                return
+                                    pin.thread == thread &&
+                                    pin.owner == owner &&
+                                    pin.removed;
+                            }
+                        );
                 }
 
 
-                int AddThread(
-                    IThread* thread,
-                    uint8_t* assignedThreadID = nullptr
+                // Marks the pins on a removed Thread and waits until no
+                // other task holds one.
+                void _waitForPins(
+                    IThread* thread
                 ) {
-                    try {
-                        if (thread == nullptr) {
-                            throw ThreadInvalidRegistrationException();
-                        }
+                    const TaskHandle_t owner =
+                        xTaskGetCurrentTaskHandle();
 
-                        ThreadRecord resolved{
-                            0,
-                            nullptr,
-                            0
-                        };
+                    for (;;) {
+                        bool pinnedElsewhere = false;
 
-                        /*
-                         * Preserve idempotent AddThread() behaviour without
-                         * invoking custom virtual ID logic again.
-                         */
-                        _threads.WithSharedReadLock(
-                            [&](const std::vector<ThreadRecord>& threads) {
-                                const auto existing =
-                                    std::find_if(
-                                        threads.begin(),
-                                        threads.end(),
-                                        [thread](const ThreadRecord& record) {
-                                            return record.thread == thread;
-                                        }
-                                    );
+                        {
+                            std::lock_guard<
+                                std::mutex
+                            > lock(_pinMutex);
 
-                                if (existing != threads.end()) {
-                                    resolved = *existing;
+                            for (
+                                ThreadPin& pin :
+                                _pins
+                            ) {
+                                if (pin.thread != thread) {
+                                    continue;
                                 }
-                            }
-                        );
 
-                        if (resolved.thread != nullptr) {
-                            if (assignedThreadID != nullptr) {
-                                *assignedThreadID =
-                                    resolved.id;
+                                pin.removed = true;
+
+                                if (pin.owner != owner) {
+                                    pinnedElsewhere = true;
+                                }
                             }
+                        }
 
-                            return resolved.coreID;
+                        if (!pinnedElsewhere) {
+                            return;
                         }
 
-                        bool inserted = false;
+                        vTaskDelay(1);
+                    }
+                }
 
-                        /*
-                         * Evaluate a custom ID before taking the registry lock:
-                         * custom IThread implementations may re-enter the
-                         * manager from GetThreadID().
-                         */
-                        const uint8_t requestedThreadID =
-                            assignedThreadID == nullptr
-                                ? thread->GetThreadID()
-                                : 0;
 
-                        _threads.WithWriteLock(
-                            [&](std::vector<ThreadRecord>& threads) {
-                                const auto existing =
-                                    std::find_if(
-                                        threads.begin(),
-                                        threads.end(),
-                                        [thread](const ThreadRecord& record) {
-                                            return record.thread == thread;
-                                        }
-                                    );
+                class PinnedThreads {
+                    private:
+                        ThreadManager& _manager;
 
-                                if (existing != threads.end()) {
-                                    resolved = *existing;
-                                    return;
-                                }
+                        std::vector<
+                            ThreadRecord
+                        > _records;
 
-                                uint8_t recordID =
-                                    requestedThreadID;
+                    public:
+                        explicit PinnedThreads(
+                            ThreadManager& manager
+                        ) :
+                            _manager(manager),
+                            _records(
+                                manager._pinThreads()
+                            ) {
+                        }
 
-                                if (assignedThreadID != nullptr) {
-                                    bool assigned = false;
+                        ~PinnedThreads() {
+                            _manager._unpinThreads(
+                                _records
+                            );
+                        }
 
-                                    for (
-                                        unsigned int candidate = 1;
-                                        candidate <=
-                                            std::numeric_limits<uint8_t>::max();
+                        PinnedThreads(
+                            const PinnedThreads&
+                        ) = delete;
+
+                        PinnedThreads& operator=(
+                            const PinnedThreads&
+                        ) = delete;
+
+
+                        const std::vector<
+                            ThreadRecord
+                        >& GetRecords() const {
+                            return _records;
+                        }
+
+
+                        // False once the record's Thread was removed from
+                        // the pinning task itself; it must not be used.
+                        bool IsAlive(
+                            const ThreadRecord& record
+                        ) const {
+                            return
+                                !_manager._isPinRemoved(
+                                    record.thread
+                                );
+                        }
+                };
+
+
+                std::vector<
+                    ThreadRuntimeSnapshot
+                > _sampleRuntime(
+                    bool notifyObservers
+                ) {
+                    IterationGuard iteration(
+                        *this
+                    );
+
+                    // Called from the sampler task, which no user code can
+                    // coordinate a delete with; the pins do that instead.
+                    PinnedThreads pinned(
+                        *this
+                    );
+
+                    const std::vector<
+                        ThreadRecord
+                    >& records =
+                        pinned.GetRecords();
+
+                    std::vector<
+                        ThreadRuntimeSnapshot
+                    > snapshots;
+
+                    snapshots.reserve(
+                        records.size()
+                    );
+
+                    for (
+                        const ThreadRecord& record :
+                        records
+                    ) {
+                        if (!pinned.IsAlive(record)) {
+                            continue;
+                        }
+
+                        ThreadRuntimeSnapshot snapshot;
+
+                        snapshot.Thread =
+                            _snapshot(record);
+
+                        if (record.thread != nullptr) {
+                            try {
+                                snapshot.Available =
+                                    record.thread->
+                                        GetRuntimeStatistics(
+                                            snapshot.Runtime
+                                        );
+                            } catch (...) {
+                                // Custom IThread implementations may throw;
+                                // the snapshot is then reported unavailable.
+                            }
+
+                            try {
+                                snapshot.StackAvailable =
+                                    record.thread->
+                                        GetStackStatistics(
+                                            snapshot.Stack
+                                        );
+                            } catch (...) {
+                            }
+                        }
+
+                        if (notifyObservers) {
+                            _observable->RuntimeSampled(
+                                record.thread,
+                                snapshot
+                            );
+                        }
+
+                        snapshots.push_back(
+                            snapshot
+                        );
+                    }
+
+                    return snapshots;
+                }
+
+
+                void _forgetRebalanceSample(
+                    uint8_t threadID,
+                    IThread* thread
+                ) {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_placementMutex);
+
+                    _rebalanceSamples.erase(
+                        std::remove_if(
+                            _rebalanceSamples.begin(),
+                            _rebalanceSamples.end(),
+                            [threadID, thread](const RebalanceSample& sample) {
+                                return
+                                    sample.id == threadID &&
+                                    sample.thread == thread;
+                            }
+                        ),
+                        _rebalanceSamples.end()
+                    );
+                }
+
+
+                static ThreadPlacementLoad
+                _placementLoad(
+                    const ThreadRecord& record
+                ) {
+                    ThreadPlacementLoad load;
+
+                    load.Thread =
+                        _snapshot(record);
+
+                    try {
+                        // The record holds the core assigned at
+                        // registration; the Thread knows where it is now.
+                        load.Thread.CoreID =
+                            record.thread->GetCoreID();
+
+                        load.Priority =
+                            record.thread->GetPriority();
+
+                        ThreadRuntimeStatistics statistics;
+
+                        const uint64_t running =
+                            record.thread->GetRuntimeStatistics(
+                                statistics
+                            )
+                                ? statistics.StateNanoseconds[
+                                    static_cast<std::size_t>(
+                                        ThreadState::Running
+                                    )
+                                ]
+                                : 0;
+
+                        if (
+                            statistics.CpuTimeAvailable &&
+                            running > 0
+                        ) {
+                            load.LoadMeasured = true;
+
+                            load.LoadPermille =
+                                static_cast<uint32_t>(
+                                    std::min<uint64_t>(
+                                        1000,
+                                        statistics.LoopCpuNanoseconds *
+                                            1000 /
+                                            running
+                                    )
+                                );
+                        }
+                    } catch (...) {
+                    }
+
+                    return load;
+                }
+
+
+                bool _migrate(
+                    const ThreadRecord& record,
+                    int coreID
+                ) {
+                    ThreadManagerThreadSnapshot snapshot =
+                        _snapshot(record);
+
+                    try {
+                        snapshot.CoreID =
+                            record.thread->GetCoreID();
+
+                        if (
+                            !record.thread->MigrateToCore(
+                                coreID
+                            )
+                        ) {
+                            return false;
+                        }
+                    } catch (...) {
+                        return false;
+                    }
+
+                    /*
+                     * The record keeps its core: the move happens later on
+                     * the Thread's own task and can still fail there, so
+                     * placement reads GetCoreID() instead.
+                     */
+                    _observable->MigrationRequested(
+                        record.thread,
+                        snapshot,
+                        coreID
+                    );
+
+                    return true;
+                }
+
+
+                static void _samplerEntry(
+                    void* parameter
+                ) {
+                    ThreadManager* manager =
+                        static_cast<
+                            ThreadManager*
+                        >(parameter);
+
+                    for (;;) {
+                        const uint32_t interval =
+                            manager->_samplingIntervalMilliseconds.load(
+                                std::memory_order_acquire
+                            );
+
+                        if (interval == 0) {
+                            ulTaskNotifyTake(
+                                pdTRUE,
+                                portMAX_DELAY
+                            );
+
+                            continue;
+                        }
+
+                        const TickType_t delayTicks =
+                            pdMS_TO_TICKS(interval);
+
+                        // A notification means the interval changed.
+                        if (
+                            ulTaskNotifyTake(
+                                pdTRUE,
+                                delayTicks > 0
+                                    ? delayTicks
+                                    : 1
+                            ) != 0
+                        ) {
+                            continue;
+                        }
+
+                        try {
+                            static_cast<void>(
+                                manager->SampleRuntime()
+                            );
+
+                            if (
+                                manager->_rebalancingEnabled.load(
+                                    std::memory_order_acquire
+                                )
+                            ) {
+                                static_cast<void>(
+                                    manager->Rebalance()
+                                );
+                            }
+                        } catch (...) {
+                        }
+                    }
+                }
+
+
+                static int _getCoreCount() {
+                    #if defined(portNUM_PROCESSORS)
+                        return
+                            portNUM_PROCESSORS > 0
+                                ? portNUM_PROCESSORS
+                                : 1;
+                    #elif defined(configNUMBER_OF_CORES)
+                        return
+                            configNUMBER_OF_CORES > 0
+                                ? configNUMBER_OF_CORES
+                                : 1;
+                    #else
+                        return 1;
+                    #endif
+                }
+
+
+            protected:
+                ThreadManager() :
+                    _threads(
+                        std::vector<
+                            ThreadRecord
+                        >()
+                    ) {
+                }
+
+
+            public:
+                static ThreadManager*
+                GetInstance() {
+                    // Process-lifetime by design: destroying the manager
+                    // during static teardown could race static Thread objects
+                    // and already-stopped FreeRTOS infrastructure.
+                    static ThreadManager* instance =
+                        new ThreadManager();
+
+                    return instance;
+                }
+
+
+                int AddThread(
+                    IThread* thread,
+                    uint8_t* assignedThreadID = nullptr
+                ) {
+                    try {
+                        if (thread == nullptr) {
+                            throw ThreadInvalidRegistrationException();
+                        }
+
+                        ThreadRecord resolved{
+                            0,
+                            nullptr,
+                            0
+                        };
+
+                        /*
+                         * Preserve idempotent AddThread() behaviour without
+                         * invoking custom virtual ID logic again.
+                         */
+                        _withThreadsSharedReadLock(
+                            [&](const std::vector<ThreadRecord>& threads) {
+                                const auto existing =
+                                    std::find_if(
+                                        threads.begin(),
+                                        threads.end(),
+                                        [thread](const ThreadRecord& record) {
+                                            return record.thread == thread;
+                                        }
+                                    );
+
+                                if (existing != threads.end()) {
+                                    resolved = *existing;
+                                }
+                            }
+                        );
+
+                        if (resolved.thread != nullptr) {
+                            if (assignedThreadID != nullptr) {
+                                *assignedThreadID =
+                                    resolved.id;
+                            }
+
+                            return resolved.coreID;
+                        }
+
+                        bool inserted = false;
+
+                        /*
+                         * Evaluate a custom ID before taking the registry lock:
+                         * custom IThread implementations may re-enter the
+                         * manager from GetThreadID().
+                         */
+                        const uint8_t requestedThreadID =
+                            assignedThreadID == nullptr
+                                ? thread->GetThreadID()
+                                : 0;
+
+                        _withThreadsWriteLock(
+                            [&](std::vector<ThreadRecord>& threads) {
+                                const auto existing =
+                                    std::find_if(
+                                        threads.begin(),
+                                        threads.end(),
+                                        [thread](const ThreadRecord& record) {
+                                            return record.thread == thread;
+                                        }
+                                    );
+
+                                if (existing != threads.end()) {
+                                    resolved = *existing;
+                                    return;
+                                }
+
+                                uint8_t recordID =
+                                    requestedThreadID;
+
+                                if (assignedThreadID != nullptr) {
+                                    bool assigned = false;
+
+                                    for (
+                                        unsigned int candidate = 1;
+                                        candidate <=
+                                            std::numeric_limits<uint8_t>::max();
                                         ++candidate
                                     ) {
                                         const uint8_t candidateID =
@@ -542,13 +1248,17 @@ namespace ESPressio {
                 }
 
 
+                /// Unregisters `thread`, waiting while the manager's own
+                /// tasks are still calling into it. A custom IThread calls
+                /// this at the start of its destructor, before releasing
+                /// anything its statistics getters use.
                 void RemoveThread(
                     IThread* thread
                 ) {
                     bool removed = false;
                     ThreadManagerThreadSnapshot snapshot;
 
-                    _threads.WithWriteLock(
+                    _withThreadsWriteLock(
                         [&](std::vector<ThreadRecord>& threads) {
                             const auto matching =
                                 std::find_if(
@@ -573,7 +1283,16 @@ namespace ESPressio {
                         }
                     );
 
+                    _waitForPins(
+                        thread
+                    );
+
                     if (removed) {
+                        _forgetRebalanceSample(
+                            snapshot.ThreadID,
+                            thread
+                        );
+
                         _observable->ThreadRemoved(snapshot);
                     }
                 }
@@ -583,9 +1302,10 @@ namespace ESPressio {
                     uint8_t threadID
                 ) {
                     bool removed = false;
+                    IThread* thread = nullptr;
                     ThreadManagerThreadSnapshot snapshot;
 
-                    _threads.WithWriteLock(
+                    _withThreadsWriteLock(
                         [&](std::vector<ThreadRecord>& threads) {
                             const auto matching =
                                 std::find_if(
@@ -605,12 +1325,23 @@ namespace ESPressio {
                             snapshot =
                                 _snapshot(*matching);
 
+                            thread = matching->thread;
+
                             threads.erase(matching);
                             removed = true;
                         }
                     );
 
                     if (removed) {
+                        _waitForPins(
+                            thread
+                        );
+
+                        _forgetRebalanceSample(
+                            snapshot.ThreadID,
+                            thread
+                        );
+
                         _observable->ThreadRemoved(snapshot);
                     }
                 }
@@ -629,7 +1360,7 @@ namespace ESPressio {
                         ThreadRecord
                     > snapshot;
 
-                    _threads.WithSharedReadLock(
+                    _withThreadsSharedReadLock(
                         [&snapshot](
                             const std::vector<
                                 ThreadRecord
@@ -667,7 +1398,7 @@ namespace ESPressio {
                         0
                     };
 
-                    _threads.WithSharedReadLock(
+                    _withThreadsSharedReadLock(
                         [
                             threadID,
                             &result
@@ -715,7 +1446,7 @@ namespace ESPressio {
                     IThread* result =
                         nullptr;
 
-                    _threads.WithSharedReadLock(
+                    _withThreadsSharedReadLock(
                         [
                             threadID,
                             &result
@@ -779,7 +1510,7 @@ namespace ESPressio {
                     }
 
                     try {
-                        _threads.WithSharedReadLock(
+                        _withThreadsSharedReadLock(
                             [&](const std::vector<ThreadRecord>& threads) {
                                 snapshot = threads;
                             }
@@ -815,7 +1546,7 @@ namespace ESPressio {
                             }
                         }
 
-                        _threads.WithWriteLock(
+                        _withThreadsWriteLock(
                             [&](std::vector<ThreadRecord>& threads) {
                                 for (
                                     const ThreadRecord& claimed :
@@ -916,7 +1647,7 @@ namespace ESPressio {
                         ThreadInitializationResult
                     > results;
 
-                    _threads.WithSharedReadLock(
+                    _withThreadsSharedReadLock(
                         [&snapshot](
                             const std::vector<
                                 ThreadRecord
@@ -989,10 +1720,686 @@ namespace ESPressio {
                 }
 
 
-                Observable::ObserverHandlePtr
-                RegisterObserver(
-                    IThreadManagerObserver* observer
-                ) {
+                /// Returns runtime accounting for every registered Thread.
+                std::vector<
+                    ThreadRuntimeSnapshot
+                > GetRuntimeSnapshots() {
+                    return
+                        _sampleRuntime(
+                            false
+                        );
+                }
+
+
+                /// Takes runtime snapshots and reports each one to
+                /// `OnThreadRuntimeSampled()`. Call it at the interval you
+                /// want to observe.
+                std::vector<
+                    ThreadRuntimeSnapshot
+                > SampleRuntime() {
+                    return
+                        _sampleRuntime(
+                            true
+                        );
+                }
+
+
+                /// Sets the policy that chooses each Thread's core when it
+                /// initializes. The policy is not owned and must outlive its
+                /// use. `nullptr` (the default) keeps the round-robin core
+                /// assigned at construction.
+                void SetPlacementPolicy(
+                    IThreadPlacementPolicy* policy
+                ) {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_placementMutex);
+
+                    _placementPolicy = policy;
+                }
+
+
+                /// Assigns `thread` to an affinity group for placement
+                /// policies. 0 removes it from any group.
+                void SetAffinityGroup(
+                    IThread* thread,
+                    uint8_t group
+                ) {
+                    _withThreadsWriteLock(
+                        [thread, group](
+                            std::vector<ThreadRecord>& threads
+                        ) {
+                            for (
+                                ThreadRecord& record :
+                                threads
+                            ) {
+                                if (record.thread == thread) {
+                                    record.affinityGroup = group;
+                                }
+                            }
+                        }
+                    );
+                }
+
+
+                uint8_t GetAffinityGroup(
+                    IThread* thread
+                ) {
+                    uint8_t group = 0;
+
+                    _withThreadsSharedReadLock(
+                        [thread, &group](
+                            const std::vector<ThreadRecord>& threads
+                        ) {
+                            for (
+                                const ThreadRecord& record :
+                                threads
+                            ) {
+                                if (record.thread == thread) {
+                                    group = record.affinityGroup;
+                                }
+                            }
+                        }
+                    );
+
+                    return group;
+                }
+
+
+                /// Returns the core the placement policy chooses for
+                /// `thread`, or its current core when no policy is set, the
+                /// Thread is pinned with SetCoreID(), or it is not
+                /// registered. `Thread` calls this from Initialize(); custom
+                /// IThread implementations may call it before creating
+                /// their task.
+                int PlaceThread(
+                    IThread* thread
+                ) {
+                    if (thread == nullptr) {
+                        return 0;
+                    }
+
+                    const int currentCoreID =
+                        thread->GetCoreID();
+
+                    if (thread->IsCoreIDPinned()) {
+                        return currentCoreID;
+                    }
+
+                    {
+                        std::lock_guard<
+                            std::mutex
+                        > lock(_placementMutex);
+
+                        if (_placementPolicy == nullptr) {
+                            return currentCoreID;
+                        }
+                    }
+
+                    /*
+                     * The loads are read before `_placementMutex` is taken:
+                     * GetRuntimeStatistics() locks each Thread, and a Thread
+                     * holding its own lock may be waiting in PlaceThread().
+                     */
+                    IterationGuard iteration(
+                        *this
+                    );
+
+                    PinnedThreads pinned(
+                        *this
+                    );
+
+                    const std::vector<
+                        ThreadRecord
+                    >& records =
+                        pinned.GetRecords();
+
+                    bool registered = false;
+                    ThreadPlacementLoad placing;
+
+                    std::vector<
+                        ThreadPlacementLoad
+                    > activeThreads;
+
+                    activeThreads.reserve(
+                        records.size()
+                    );
+
+                    for (
+                        const ThreadRecord& record :
+                        records
+                    ) {
+                        if (record.thread == thread) {
+                            placing =
+                                _placementLoad(record);
+
+                            registered = true;
+                            continue;
+                        }
+
+                        if (!pinned.IsAlive(record)) {
+                            continue;
+                        }
+
+                        const ThreadPlacementLoad load =
+                            _placementLoad(record);
+
+                        switch (load.Thread.State) {
+                            case ThreadState::Initialized:
+                            case ThreadState::Running:
+                            case ThreadState::Paused:
+                            case ThreadState::Terminating:
+                                activeThreads.push_back(
+                                    load
+                                );
+                                break;
+
+                            case ThreadState::Uninitialized:
+                            case ThreadState::Terminated:
+                            case ThreadState::Destroyed:
+                                break;
+                        }
+                    }
+
+                    if (!registered) {
+                        return currentCoreID;
+                    }
+
+                    const int coreCount =
+                        _getCoreCount();
+
+                    int coreID = currentCoreID;
+
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_placementMutex);
+
+                    if (_placementPolicy == nullptr) {
+                        return currentCoreID;
+                    }
+
+                    try {
+                        coreID =
+                            _placementPolicy->PlaceThread(
+                                thread,
+                                placing,
+                                activeThreads,
+                                coreCount
+                            );
+                    } catch (...) {
+                        return currentCoreID;
+                    }
+
+                    if (
+                        coreID < 0 ||
+                        coreID >= coreCount
+                    ) {
+                        return currentCoreID;
+                    }
+
+                    _withThreadsWriteLock(
+                        [thread, coreID](
+                            std::vector<ThreadRecord>& threads
+                        ) {
+                            for (
+                                ThreadRecord& record :
+                                threads
+                            ) {
+                                if (record.thread == thread) {
+                                    record.coreID = coreID;
+                                }
+                            }
+                        }
+                    );
+
+                    return coreID;
+                }
+
+
+                /// Asks `thread` to move to `coreID` at its next safe point,
+                /// between two loop iterations. Returns `false` if the core is
+                /// out of range, the Thread is not registered or not running,
+                /// or it cannot migrate (such as a StaticThread).
+                bool MigrateThread(
+                    IThread* thread,
+                    int coreID
+                ) {
+                    if (
+                        thread == nullptr ||
+                        coreID < 0 ||
+                        coreID >= _getCoreCount()
+                    ) {
+                        return false;
+                    }
+
+                    IterationGuard iteration(
+                        *this
+                    );
+
+                    ThreadRecord found{
+                        0,
+                        nullptr,
+                        0
+                    };
+
+                    _withThreadsSharedReadLock(
+                        [thread, &found](
+                            const std::vector<ThreadRecord>& threads
+                        ) {
+                            for (
+                                const ThreadRecord& record :
+                                threads
+                            ) {
+                                if (record.thread == thread) {
+                                    found = record;
+                                }
+                            }
+                        }
+                    );
+
+                    if (found.thread == nullptr) {
+                        return false;
+                    }
+
+                    return
+                        _migrate(
+                            found,
+                            coreID
+                        );
+                }
+
+
+                /// Moves at most one Running Thread from the busiest core to
+                /// the idlest, when their loop CPU load since the previous
+                /// call differs by more than
+                /// ESPRESSIO_THREAD_REBALANCE_THRESHOLD_PERMILLE. Threads
+                /// pinned with SetCoreID() are never moved. Needs
+                /// ESPRESSIO_THREAD_RUNTIME_STATISTICS; the first call only
+                /// records a baseline. Returns whether a migration was
+                /// requested.
+                bool Rebalance() {
+                    const int coreCount =
+                        _getCoreCount();
+
+                    IterationGuard iteration(
+                        *this
+                    );
+
+                    // Held until the migration is requested, as the
+                    // rebalancer may run on the sampler task.
+                    PinnedThreads pinned(
+                        *this
+                    );
+
+                    const std::vector<
+                        ThreadRecord
+                    >& records =
+                        pinned.GetRecords();
+
+                    // Read without `_placementMutex`, as in PlaceThread().
+                    std::vector<
+                        RebalanceSample
+                    > samples;
+
+                    for (
+                        const ThreadRecord& record :
+                        records
+                    ) {
+                        ThreadRuntimeStatistics statistics;
+
+                        RebalanceSample sample{
+                            record.id,
+                            record.thread,
+                            0,
+                            true,
+                            0,
+                            0
+                        };
+
+                        if (!pinned.IsAlive(record)) {
+                            continue;
+                        }
+
+                        try {
+                            if (
+                                record.thread->GetThreadState() !=
+                                    ThreadState::Running ||
+                                !record.thread->GetRuntimeStatistics(
+                                    statistics
+                                ) ||
+                                !statistics.CpuTimeAvailable
+                            ) {
+                                continue;
+                            }
+
+                            sample.coreID =
+                                record.thread->GetCoreID();
+
+                            sample.pinned =
+                                record.thread->IsCoreIDPinned();
+                        } catch (...) {
+                            continue;
+                        }
+
+                        sample.cpuNanoseconds =
+                            statistics.LoopCpuNanoseconds;
+
+                        sample.runningNanoseconds =
+                            statistics.StateNanoseconds[
+                                static_cast<std::size_t>(
+                                    ThreadState::Running
+                                )
+                            ];
+
+                        samples.push_back(
+                            sample
+                        );
+                    }
+
+                    std::unique_lock<
+                        std::mutex
+                    > lock(_placementMutex);
+
+                    struct Candidate {
+                        ThreadRecord record;
+                        int coreID;
+                        bool pinned;
+                        uint32_t loadPermille;
+                    };
+
+                    std::vector<
+                        Candidate
+                    > candidates;
+
+                    std::vector<uint64_t> coreLoads(
+                        static_cast<std::size_t>(coreCount),
+                        0
+                    );
+
+                    for (
+                        const ThreadRecord& record :
+                        records
+                    ) {
+                        const auto current =
+                            std::find_if(
+                                samples.begin(),
+                                samples.end(),
+                                [&record](const RebalanceSample& sample) {
+                                    return sample.thread == record.thread;
+                                }
+                            );
+
+                        if (current == samples.end()) {
+                            continue;
+                        }
+
+                        const auto previous =
+                            std::find_if(
+                                _rebalanceSamples.begin(),
+                                _rebalanceSamples.end(),
+                                [&record](const RebalanceSample& sample) {
+                                    return
+                                        sample.thread == record.thread &&
+                                        sample.id == record.id;
+                                }
+                            );
+
+                        if (
+                            previous == _rebalanceSamples.end() ||
+                            current->runningNanoseconds <=
+                                previous->runningNanoseconds ||
+                            current->cpuNanoseconds <
+                                previous->cpuNanoseconds ||
+                            current->coreID < 0 ||
+                            current->coreID >= coreCount
+                        ) {
+                            continue;
+                        }
+
+                        const Candidate candidate{
+                            record,
+                            current->coreID,
+                            current->pinned,
+                            static_cast<uint32_t>(
+                                std::min<uint64_t>(
+                                    1000,
+                                    (current->cpuNanoseconds -
+                                        previous->cpuNanoseconds) *
+                                        1000 /
+                                        (current->runningNanoseconds -
+                                            previous->runningNanoseconds)
+                                )
+                            )
+                        };
+
+                        coreLoads[candidate.coreID] +=
+                            candidate.loadPermille;
+
+                        candidates.push_back(
+                            candidate
+                        );
+                    }
+
+                    // A Thread removed while the counters were read must not
+                    // leave an entry behind.
+                    _withThreadsSharedReadLock(
+                        [&samples](
+                            const std::vector<
+                                ThreadRecord
+                            >& threads
+                        ) {
+                            samples.erase(
+                                std::remove_if(
+                                    samples.begin(),
+                                    samples.end(),
+                                    [&threads](const RebalanceSample& sample) {
+                                        return
+                                            std::none_of(
+                                                threads.begin(),
+                                                threads.end(),
+                                                [&sample](const ThreadRecord& record) {
+                                                    return
+                                                        record.thread == sample.thread &&
+                                                        record.id == sample.id;
+                                                }
+                                            );
+                                    }
+                                ),
+                                samples.end()
+                            );
+                        }
+                    );
+
+                    _rebalanceSamples =
+                        std::move(samples);
+
+                    const auto busiest =
+                        std::max_element(
+                            coreLoads.begin(),
+                            coreLoads.end()
+                        );
+
+                    const auto idlest =
+                        std::min_element(
+                            coreLoads.begin(),
+                            coreLoads.end()
+                        );
+
+                    const uint64_t imbalance =
+                        *busiest - *idlest;
+
+                    if (
+                        imbalance <=
+                        ESPRESSIO_THREAD_REBALANCE_THRESHOLD_PERMILLE
+                    ) {
+                        return false;
+                    }
+
+                    const int busiestCoreID =
+                        static_cast<int>(
+                            busiest - coreLoads.begin()
+                        );
+
+                    const int idlestCoreID =
+                        static_cast<int>(
+                            idlest - coreLoads.begin()
+                        );
+
+                    // Moving load L leaves an imbalance of |imbalance - 2L|;
+                    // the best move brings that closest to zero, and only a
+                    // move that shrinks it is worth making.
+                    const Candidate* chosen = nullptr;
+                    uint64_t chosenImbalance = imbalance;
+
+                    for (
+                        const Candidate& candidate :
+                        candidates
+                    ) {
+                        if (
+                            candidate.pinned ||
+                            candidate.coreID != busiestCoreID ||
+                            candidate.loadPermille == 0
+                        ) {
+                            continue;
+                        }
+
+                        const uint64_t moved =
+                            2 * static_cast<uint64_t>(
+                                candidate.loadPermille
+                            );
+
+                        const uint64_t remaining =
+                            moved > imbalance
+                                ? moved - imbalance
+                                : imbalance - moved;
+
+                        if (remaining < chosenImbalance) {
+                            chosen = &candidate;
+                            chosenImbalance = remaining;
+                        }
+                    }
+
+                    if (chosen == nullptr) {
+                        return false;
+                    }
+
+                    // Observers are notified without the placement lock.
+                    lock.unlock();
+
+                    if (!pinned.IsAlive(chosen->record)) {
+                        return false;
+                    }
+
+                    return
+                        _migrate(
+                            chosen->record,
+                            idlestCoreID
+                        );
+                }
+
+
+                /// Runs `Rebalance()` after every sample of the sampler task
+                /// started with `StartSampling(intervalMilliseconds)`.
+                bool StartRebalancing(
+                    uint32_t intervalMilliseconds
+                ) {
+                    _rebalancingEnabled.store(
+                        true,
+                        std::memory_order_release
+                    );
+
+                    return
+                        StartSampling(
+                            intervalMilliseconds
+                        );
+                }
+
+
+                /// Stops rebalancing; sampling continues until StopSampling().
+                void StopRebalancing() {
+                    _rebalancingEnabled.store(
+                        false,
+                        std::memory_order_release
+                    );
+                }
+
+
+                /// Calls `SampleRuntime()` every `intervalMilliseconds` on a
+                /// low-priority sampler task, so stack high-water marks and
+                /// runtime accounting are captured while Threads run. Calling
+                /// it again changes the interval; 0 stops sampling. Returns
+                /// `false` if the sampler task cannot be created.
+                bool StartSampling(
+                    uint32_t intervalMilliseconds
+                ) {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_samplerMutex);
+
+                    _samplingIntervalMilliseconds.store(
+                        intervalMilliseconds,
+                        std::memory_order_release
+                    );
+
+                    if (_samplerTask != nullptr) {
+                        xTaskNotifyGive(
+                            _samplerTask
+                        );
+
+                        return true;
+                    }
+
+                    if (intervalMilliseconds == 0) {
+                        return true;
+                    }
+
+                    if (
+                        xTaskCreate(
+                            _samplerEntry,
+                            "threadManagerSampler",
+                            ESPRESSIO_THREAD_MANAGER_SAMPLER_STACK_SIZE,
+                            this,
+                            ESPRESSIO_THREAD_MANAGER_SAMPLER_PRIORITY,
+                            &_samplerTask
+                        ) != pdPASS
+                    ) {
+                        _samplerTask = nullptr;
+
+                        _samplingIntervalMilliseconds.store(
+                            0,
+                            std::memory_order_release
+                        );
+
+                        return false;
+                    }
+
+                    return true;
+                }
+
+
+                void StopSampling() {
+                    static_cast<void>(
+                        StartSampling(
+                            0
+                        )
+                    );
+                }
+
+
+                /// `events` selects the callbacks `observer` receives; the
+                /// others are skipped with a bit test instead of a virtual
+                /// call. Registering again replaces the mask.
+                Observable::ObserverHandlePtr
+                RegisterObserver(
+                    IThreadManagerObserver* observer,
+                    ThreadManagerObserverEvents events =
+                        ThreadManagerObserverEvent::All
+                ) {
+                    _observable->SetInterests(
+                        observer,
+                        events
+                    );
+
                     return
                         _observable->RegisterObserver(
                             observer
@@ -1006,13 +2413,17 @@ namespace ESPressio {
                     _observable->UnregisterObserver(
                         observer
                     );
+
+                    _observable->RemoveInterests(
+                        observer
+                    );
                 }
 
 
                 std::size_t GetThreadCount() {
                     std::size_t result = 0;
 
-                    _threads.WithSharedReadLock(
+                    _withThreadsSharedReadLock(
                         [&result](
                             const std::vector<
                                 ThreadRecord
@@ -14,6 +14,34 @@ namespace Threads {
         ThreadState State = ThreadState::Uninitialized;
         bool FreeOnTerminate = false;
         bool StartOnInitialize = true;
+        /// 0 when the Thread belongs to no affinity group.
+        uint8_t AffinityGroup = 0;
+    };
+
+
+    /// What a placement policy knows about one Thread.
+    struct ThreadPlacementLoad {
+        ThreadManagerThreadSnapshot Thread;
+        unsigned int Priority = 0;
+
+        /// `true` once the Thread has runtime accounting for time spent
+        /// Running; see ESPRESSIO_THREAD_RUNTIME_STATISTICS.
+        bool LoadMeasured = false;
+        /// Loop CPU time per Running wall time, in thousandths of a core.
+        uint32_t LoadPermille = 0;
+    };
+
+
+    struct ThreadRuntimeSnapshot {
+        ThreadManagerThreadSnapshot Thread;
+
+        /// `false` when the Thread keeps no runtime accounting.
+        bool Available = false;
+        ThreadRuntimeStatistics Runtime;
+
+        /// `false` when the Thread does not track its stack usage.
+        bool StackAvailable = false;
+        ThreadStackStatistics Stack;
     };
 
 
@@ -0,0 +1,1223 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "ESPressio_ClockTypes.hpp"
+#include "ESPressio_IThread.hpp"
+#include "ESPressio_SystemClock.hpp"
+#include "ESPressio_TimeTraits.hpp"
+
+// define as 1 to have the library record its built-in metrics. The metric
+// types themselves are always available.
+#ifndef ESPRESSIO_THREAD_METRICS
+    #define ESPRESSIO_THREAD_METRICS 0
+#endif
+
+// Histogram sub-buckets per power of two, as a power of two. 3 gives 8 and
+// a worst-case relative error of 12.5%.
+#ifndef ESPRESSIO_THREAD_METRICS_HISTOGRAM_PRECISION_BITS
+    #define ESPRESSIO_THREAD_METRICS_HISTOGRAM_PRECISION_BITS 3
+#endif
+
+// Histograms resolve values below 2^N; larger values share the top bucket.
+// 36 is about 68 seconds in nanoseconds.
+#ifndef ESPRESSIO_THREAD_METRICS_HISTOGRAM_RANGE_BITS
+    #define ESPRESSIO_THREAD_METRICS_HISTOGRAM_RANGE_BITS 36
+#endif
+
+// Application metrics ThreadMetrics can hold besides its built-ins.
+#ifndef ESPRESSIO_THREAD_METRICS_CAPACITY
+    #define ESPRESSIO_THREAD_METRICS_CAPACITY 16
+#endif
+
+static_assert(
+    ESPRESSIO_THREAD_METRICS_HISTOGRAM_PRECISION_BITS >= 1 &&
+    ESPRESSIO_THREAD_METRICS_HISTOGRAM_PRECISION_BITS <
+        ESPRESSIO_THREAD_METRICS_HISTOGRAM_RANGE_BITS &&
+    ESPRESSIO_THREAD_METRICS_HISTOGRAM_RANGE_BITS <= 64,
+    "Histogram precision must be at least 1 bit and below its range"
+);
+
+namespace ESPressio {
+namespace Threads {
+
+    /*
+     * Whether recording a metric is free of locks. Counters, gauges and
+     * histogram totals are 64-bit atomics, which no ESP32 core updates
+     * natively; libatomic then wraps each update in a short critical
+     * section (an interrupt mask, plus a spinlock across cores). Recording
+     * never waits on a mutex or blocks the task either way, but on those
+     * targets it is not lock-free and briefly delays interrupts.
+     */
+    constexpr bool ThreadMetricsLockFree =
+        std::atomic<uint64_t>::is_always_lock_free &&
+        std::atomic<int64_t>::is_always_lock_free;
+
+
+    enum class ThreadMetricType : uint8_t {
+        Counter = 1,
+        Gauge = 2,
+        Histogram = 3
+    };
+
+
+    /// A monotonic count. Each core adds to its own slot, and the slots
+    /// are summed on read; see ThreadMetricsLockFree for the cost of an
+    /// update.
+    class ThreadMetricCounter {
+        private:
+            static constexpr int _coreCount =
+                #if defined(portNUM_PROCESSORS)
+                    portNUM_PROCESSORS > 0
+                        ? portNUM_PROCESSORS
+                        : 1;
+                #else
+                    1;
+                #endif
+
+
+            std::atomic<uint64_t> _values[
+                _coreCount
+            ] = {};
+
+
+            static int _currentCore() {
+                #if defined(ESP_PLATFORM)
+                    const int coreID =
+                        static_cast<int>(
+                            xPortGetCoreID()
+                        );
+
+                    return
+                        coreID < _coreCount
+                            ? coreID
+                            : 0;
+                #else
+                    return 0;
+                #endif
+            }
+
+
+        public:
+            void Add(
+                uint64_t amount = 1
+            ) {
+                _values[_currentCore()].fetch_add(
+                    amount,
+                    std::memory_order_relaxed
+                );
+            }
+
+
+            uint64_t GetValue() const {
+                uint64_t value = 0;
+
+                for (
+                    const std::atomic<uint64_t>& coreValue :
+                    _values
+                ) {
+                    value +=
+                        coreValue.load(
+                            std::memory_order_relaxed
+                        );
+                }
+
+                return value;
+            }
+
+
+            void Reset() {
+                for (
+                    std::atomic<uint64_t>& coreValue :
+                    _values
+                ) {
+                    coreValue.store(
+                        0,
+                        std::memory_order_relaxed
+                    );
+                }
+            }
+    };
+
+
+    /// A value that goes up and down.
+    class ThreadMetricGauge {
+        private:
+            std::atomic<int64_t>
+                _value{
+                    0
+                };
+
+
+        public:
+            void Set(
+                int64_t value
+            ) {
+                _value.store(
+                    value,
+                    std::memory_order_relaxed
+                );
+            }
+
+
+            void Add(
+                int64_t amount
+            ) {
+                _value.fetch_add(
+                    amount,
+                    std::memory_order_relaxed
+                );
+            }
+
+
+            int64_t GetValue() const {
+                return
+                    _value.load(
+                        std::memory_order_relaxed
+                    );
+            }
+
+
+            void Reset() {
+                Set(0);
+            }
+    };
+
+
+    /*
+     * Bucket layout shared by every histogram, in the HDR style: values
+     * below SubBucketCount have a bucket each, and every further power of
+     * two is split into SubBucketCount / 2 equal buckets, so the relative
+     * error is bounded across the whole range with a fixed bucket count.
+     */
+    struct ThreadMetricHistogramLayout {
+        static constexpr uint32_t PrecisionBits =
+            ESPRESSIO_THREAD_METRICS_HISTOGRAM_PRECISION_BITS;
+
+        static constexpr uint32_t RangeBits =
+            ESPRESSIO_THREAD_METRICS_HISTOGRAM_RANGE_BITS;
+
+        static constexpr uint32_t SubBucketCount =
+            1u << PrecisionBits;
+
+        static constexpr uint32_t BucketCount =
+            SubBucketCount +
+            (RangeBits - PrecisionBits) * (SubBucketCount / 2);
+
+        static_assert(
+            BucketCount <= std::numeric_limits<uint16_t>::max(),
+            "Histogram bucket indices are exported as 16 bits"
+        );
+
+
+        static uint32_t GetBucketIndex(
+            uint64_t value
+        ) {
+            if (value < SubBucketCount) {
+                return static_cast<uint32_t>(value);
+            }
+
+            const uint32_t mostSignificantBit =
+                63 - static_cast<uint32_t>(
+                    __builtin_clzll(value)
+                );
+
+            if (mostSignificantBit >= RangeBits) {
+                return BucketCount - 1;
+            }
+
+            const uint32_t shift =
+                mostSignificantBit - PrecisionBits + 1;
+
+            return
+                SubBucketCount +
+                (shift - 1) * (SubBucketCount / 2) +
+                static_cast<uint32_t>(
+                    (value >> shift) - SubBucketCount / 2
+                );
+        }
+
+
+        /// Smallest value counted in bucket `index`.
+        static uint64_t GetBucketLowerBound(
+            uint32_t index
+        ) {
+            if (index < SubBucketCount) {
+                return index;
+            }
+
+            const uint32_t offset =
+                index - SubBucketCount;
+
+            const uint32_t shift =
+                offset / (SubBucketCount / 2) + 1;
+
+            const uint64_t mantissa =
+                offset % (SubBucketCount / 2) +
+                SubBucketCount / 2;
+
+            return mantissa << shift;
+        }
+
+
+        /// Largest value counted in bucket `index`.
+        static uint64_t GetBucketUpperBound(
+            uint32_t index
+        ) {
+            if (index + 1 >= BucketCount) {
+                return std::numeric_limits<uint64_t>::max();
+            }
+
+            return GetBucketLowerBound(index + 1) - 1;
+        }
+    };
+
+
+    /// A copy of a histogram at one moment.
+    struct ThreadMetricHistogramSnapshot {
+        uint64_t Count = 0;
+        uint64_t Sum = 0;
+
+        // Meaningful only when Count > 0.
+        uint64_t Minimum = 0;
+        uint64_t Maximum = 0;
+
+        uint32_t Buckets[
+            ThreadMetricHistogramLayout::BucketCount
+        ] = {};
+
+
+        double GetMean() const {
+            return
+                Count > 0
+                    ? static_cast<double>(Sum) /
+                        static_cast<double>(Count)
+                    : 0.0;
+        }
+
+
+        /// The value at or below which `quantile` (0 to 1) of the samples
+        /// lie, to the histogram's precision. 0 when empty.
+        uint64_t GetPercentile(
+            double quantile
+        ) const {
+            uint64_t total = 0;
+
+            for (const uint32_t bucket : Buckets) {
+                total += bucket;
+            }
+
+            if (total == 0) {
+                return 0;
+            }
+
+            if (quantile <= 0.0) {
+                return Minimum;
+            }
+
+            uint64_t rank =
+                static_cast<uint64_t>(
+                    quantile * static_cast<double>(total) + 0.5
+                );
+
+            if (rank < 1) {
+                rank = 1;
+            }
+
+            uint64_t seen = 0;
+
+            for (
+                uint32_t index = 0;
+                index < ThreadMetricHistogramLayout::BucketCount;
+                ++index
+            ) {
+                seen += Buckets[index];
+
+                if (seen >= rank) {
+                    const uint64_t upper =
+                        ThreadMetricHistogramLayout::
+                            GetBucketUpperBound(index);
+
+                    return
+                        upper < Maximum
+                            ? upper
+                            : Maximum;
+                }
+            }
+
+            return Maximum;
+        }
+    };
+
+
+    /*
+     * Distribution of non-negative values, usually nanoseconds, in fixed
+     * memory. Recording is a handful of relaxed atomic operations and takes
+     * no mutex, so any task may record while another takes a snapshot; the
+     * snapshot is then consistent to within the samples in flight. See
+     * ThreadMetricsLockFree for the 64-bit totals.
+     */
+    class ThreadMetricHistogram {
+        private:
+            std::atomic<uint32_t> _buckets[
+                ThreadMetricHistogramLayout::BucketCount
+            ] = {};
+
+            std::atomic<uint64_t>
+                _count{
+                    0
+                };
+
+            std::atomic<uint64_t>
+                _sum{
+                    0
+                };
+
+            std::atomic<uint64_t>
+                _minimum{
+                    std::numeric_limits<uint64_t>::max()
+                };
+
+            std::atomic<uint64_t>
+                _maximum{
+                    0
+                };
+
+
+        public:
+            void Record(
+                uint64_t value
+            ) {
+                _buckets[
+                    ThreadMetricHistogramLayout::GetBucketIndex(
+                        value
+                    )
+                ].fetch_add(
+                    1,
+                    std::memory_order_relaxed
+                );
+
+                _count.fetch_add(
+                    1,
+                    std::memory_order_relaxed
+                );
+
+                _sum.fetch_add(
+                    value,
+                    std::memory_order_relaxed
+                );
+
+                uint64_t minimum =
+                    _minimum.load(
+                        std::memory_order_relaxed
+                    );
+
+                while (
+                    value < minimum &&
+                    !_minimum.compare_exchange_weak(
+                        minimum,
+                        value,
+                        std::memory_order_relaxed
+                    )
+                ) {
+                }
+
+                uint64_t maximum =
+                    _maximum.load(
+                        std::memory_order_relaxed
+                    );
+
+                while (
+                    value > maximum &&
+                    !_maximum.compare_exchange_weak(
+                        maximum,
+                        value,
+                        std::memory_order_relaxed
+                    )
+                ) {
+                }
+            }
+
+
+            void GetSnapshot(
+                ThreadMetricHistogramSnapshot& snapshot
+            ) const {
+                for (
+                    uint32_t index = 0;
+                    index < ThreadMetricHistogramLayout::BucketCount;
+                    ++index
+                ) {
+                    snapshot.Buckets[index] =
+                        _buckets[index].load(
+                            std::memory_order_relaxed
+                        );
+                }
+
+                snapshot.Count =
+                    _count.load(
+                        std::memory_order_relaxed
+                    );
+
+                snapshot.Sum =
+                    _sum.load(
+                        std::memory_order_relaxed
+                    );
+
+                snapshot.Maximum =
+                    _maximum.load(
+                        std::memory_order_relaxed
+                    );
+
+                snapshot.Minimum =
+                    snapshot.Count > 0
+                        ? _minimum.load(
+                            std::memory_order_relaxed
+                          )
+                        : 0;
+            }
+
+
+            ThreadMetricHistogramSnapshot GetSnapshot() const {
+                ThreadMetricHistogramSnapshot snapshot;
+
+                GetSnapshot(
+                    snapshot
+                );
+
+                return snapshot;
+            }
+
+
+            void Reset() {
+                for (
+                    std::atomic<uint32_t>& bucket :
+                    _buckets
+                ) {
+                    bucket.store(
+                        0,
+                        std::memory_order_relaxed
+                    );
+                }
+
+                _count.store(
+                    0,
+                    std::memory_order_relaxed
+                );
+
+                _sum.store(
+                    0,
+                    std::memory_order_relaxed
+                );
+
+                _minimum.store(
+                    std::numeric_limits<uint64_t>::max(),
+                    std::memory_order_relaxed
+                );
+
+                _maximum.store(
+                    0,
+                    std::memory_order_relaxed
+                );
+            }
+    };
+
+
+    /// One metric in a ThreadMetrics snapshot.
+    struct ThreadMetricSample {
+        // Prometheus-style, labels included, e.g. `name{label="value"}`.
+        const char* Name = nullptr;
+
+        ThreadMetricType Type =
+            ThreadMetricType::Counter;
+
+        // Counters and gauges.
+        int64_t Value = 0;
+
+        // Histograms.
+        ThreadMetricHistogramSnapshot Histogram;
+    };
+
+
+    /// Header of ThreadMetrics::ExportBinary(), followed by MetricCount
+    /// records. Fields are little-endian, as on every ESP32.
+    struct ThreadMetricsBinaryHeader {
+        char Magic[4];
+        uint16_t Version;
+        uint16_t MetricCount;
+        uint8_t PrecisionBits;
+        uint8_t RangeBits;
+        uint16_t Reserved;
+    };
+
+    static_assert(
+        sizeof(ThreadMetricsBinaryHeader) == 12,
+        "ThreadMetricsBinaryHeader is a fixed 12-byte record"
+    );
+
+
+    /*
+     * The library's built-in metrics and any the application registers.
+     *
+     * Built-ins are recorded only with ESPRESSIO_THREAD_METRICS, all times
+     * in nanoseconds of the Timing SystemClock. GetSnapshot() copies every
+     * metric; ExportText() and ExportBinary() write one for a telemetry
+     * task to send on.
+     */
+    class ThreadMetrics {
+        public:
+            using TWrite =
+                std::function<
+                    void(
+                        const uint8_t*,
+                        std::size_t
+                    )
+                >;
+
+
+            // Transitions into each ThreadState, by Thread::SetThreadState.
+            ThreadMetricCounter StateTransitions[
+                ThreadStateCount
+            ];
+
+            // From ThreadTerminationDispatcher::Dispatch() to the end of
+            // the Thread's termination dispatch.
+            ThreadMetricHistogram TerminationDispatchLatency;
+
+            // One garbage collection pass.
+            ThreadMetricHistogram GarbageCollectionDuration;
+
+            // Waiting for the ThreadManager's registry lock.
+            ThreadMetricHistogram ManagerLockWait;
+
+            // One PrecisionThread Iterate(), across every PrecisionThread.
+            ThreadMetricHistogram IterationDuration;
+
+            // How late a PrecisionThread iteration started against its
+            // scheduled time.
+            ThreadMetricHistogram IterationJitter;
+
+
+        private:
+            struct Registration {
+                const char* Name;
+                ThreadMetricType Type;
+                void* Metric;
+            };
+
+
+            mutable std::mutex _registrationMutex;
+
+            Registration _registrations[
+                ESPRESSIO_THREAD_METRICS_CAPACITY
+            ];
+
+            std::size_t _registrationCount = 0;
+
+
+            ThreadMetrics() = default;
+
+
+            bool _register(
+                const char* name,
+                ThreadMetricType type,
+                void* metric
+            ) {
+                std::lock_guard<
+                    std::mutex
+                > lock(_registrationMutex);
+
+                if (
+                    name == nullptr ||
+                    metric == nullptr ||
+                    _registrationCount >= ESPRESSIO_THREAD_METRICS_CAPACITY
+                ) {
+                    return false;
+                }
+
+                _registrations[_registrationCount++] = {
+                    name,
+                    type,
+                    metric
+                };
+
+                return true;
+            }
+
+
+            static void _appendCounter(
+                std::vector<ThreadMetricSample>& samples,
+                const char* name,
+                const ThreadMetricCounter& counter
+            ) {
+                samples.emplace_back();
+                samples.back().Name = name;
+                samples.back().Type = ThreadMetricType::Counter;
+
+                samples.back().Value =
+                    static_cast<int64_t>(
+                        counter.GetValue()
+                    );
+            }
+
+
+            static void _appendHistogram(
+                std::vector<ThreadMetricSample>& samples,
+                const char* name,
+                const ThreadMetricHistogram& histogram
+            ) {
+                samples.emplace_back();
+                samples.back().Name = name;
+                samples.back().Type = ThreadMetricType::Histogram;
+
+                histogram.GetSnapshot(
+                    samples.back().Histogram
+                );
+            }
+
+
+            static void _writeText(
+                const TWrite& write,
+                const char* text
+            ) {
+                write(
+                    reinterpret_cast<const uint8_t*>(text),
+                    std::strlen(text)
+                );
+            }
+
+
+            // Writes `name` with `label` added to its label set.
+            static void _writeName(
+                const TWrite& write,
+                const char* name,
+                const char* suffix,
+                const char* label
+            ) {
+                const char* labels =
+                    std::strchr(name, '{');
+
+                const std::size_t baseLength =
+                    labels != nullptr
+                        ? static_cast<std::size_t>(labels - name)
+                        : std::strlen(name);
+
+                write(
+                    reinterpret_cast<const uint8_t*>(name),
+                    baseLength
+                );
+
+                _writeText(
+                    write,
+                    suffix
+                );
+
+                if (labels == nullptr) {
+                    if (label[0] != '\0') {
+                        _writeText(write, "{");
+                        _writeText(write, label);
+                        _writeText(write, "}");
+                    }
+
+                    return;
+                }
+
+                const std::size_t labelsLength =
+                    std::strlen(labels);
+
+                if (label[0] == '\0') {
+                    write(
+                        reinterpret_cast<const uint8_t*>(labels),
+                        labelsLength
+                    );
+
+                    return;
+                }
+
+                // Everything before the closing brace, then the label.
+                write(
+                    reinterpret_cast<const uint8_t*>(labels),
+                    labelsLength - 1
+                );
+
+                _writeText(write, ",");
+                _writeText(write, label);
+                _writeText(write, "}");
+            }
+
+
+            static void _writeBytes(
+                const TWrite& write,
+                const void* data,
+                std::size_t size
+            ) {
+                write(
+                    static_cast<const uint8_t*>(data),
+                    size
+                );
+            }
+
+
+        public:
+            static ThreadMetrics*
+            GetInstance() {
+                // Process-lifetime by design: metrics may be recorded
+                // during static destruction.
+                static ThreadMetrics* instance =
+                    new ThreadMetrics();
+
+                return instance;
+            }
+
+
+            ThreadMetrics(
+                const ThreadMetrics&
+            ) = delete;
+
+            ThreadMetrics& operator=(
+                const ThreadMetrics&
+            ) = delete;
+
+
+            /// Current time in nanoseconds, for the built-in metrics.
+            static uint64_t GetNowNanoseconds() {
+                return
+                    Timing::TimeTraits<
+                        Timing::DefaultClockTime
+                    >::template ToNanoseconds<
+                        uint64_t
+                    >(
+                        Timing::SystemClock<
+                            Timing::DefaultClockTime
+                        >::GetInstance().GetTime()
+                    );
+            }
+
+
+            /// Adds an application metric to snapshots and exports. `name`
+            /// and the metric must outlive the registry. Returns `false`
+            /// once ESPRESSIO_THREAD_METRICS_CAPACITY are registered.
+            bool Register(
+                const char* name,
+                ThreadMetricCounter& counter
+            ) {
+                return _register(
+                    name,
+                    ThreadMetricType::Counter,
+                    &counter
+                );
+            }
+
+
+            bool Register(
+                const char* name,
+                ThreadMetricGauge& gauge
+            ) {
+                return _register(
+                    name,
+                    ThreadMetricType::Gauge,
+                    &gauge
+                );
+            }
+
+
+            bool Register(
+                const char* name,
+                ThreadMetricHistogram& histogram
+            ) {
+                return _register(
+                    name,
+                    ThreadMetricType::Histogram,
+                    &histogram
+                );
+            }
+
+
+            /// Resets the built-in metrics.
+            void Reset() {
+                for (ThreadMetricCounter& counter : StateTransitions) {
+                    counter.Reset();
+                }
+
+                TerminationDispatchLatency.Reset();
+                GarbageCollectionDuration.Reset();
+                ManagerLockWait.Reset();
+                IterationDuration.Reset();
+                IterationJitter.Reset();
+            }
+
+
+            /// Copies every built-in and registered metric.
+            std::vector<ThreadMetricSample> GetSnapshot() const {
+                static const char* const stateNames[] = {
+                    "espressio_thread_state_transitions_total{state=\"Uninitialized\"}",
+                    "espressio_thread_state_transitions_total{state=\"Initialized\"}",
+                    "espressio_thread_state_transitions_total{state=\"Running\"}",
+                    "espressio_thread_state_transitions_total{state=\"Paused\"}",
+                    "espressio_thread_state_transitions_total{state=\"Terminating\"}",
+                    "espressio_thread_state_transitions_total{state=\"Terminated\"}",
+                    "espressio_thread_state_transitions_total{state=\"Destroyed\"}"
+                };
+
+                static_assert(
+                    sizeof(stateNames) / sizeof(stateNames[0]) ==
+                        sizeof(StateTransitions) /
+                        sizeof(StateTransitions[0]),
+                    "Every ThreadState needs a metric name"
+                );
+
+                std::vector<ThreadMetricSample> samples;
+
+                std::lock_guard<
+                    std::mutex
+                > lock(_registrationMutex);
+
+                samples.reserve(
+                    sizeof(stateNames) / sizeof(stateNames[0]) +
+                    5 +
+                    _registrationCount
+                );
+
+                for (
+                    std::size_t state = 0;
+                    state < sizeof(stateNames) / sizeof(stateNames[0]);
+                    ++state
+                ) {
+                    _appendCounter(
+                        samples,
+                        stateNames[state],
+                        StateTransitions[state]
+                    );
+                }
+
+                _appendHistogram(
+                    samples,
+                    "espressio_thread_termination_dispatch_latency_nanoseconds",
+                    TerminationDispatchLatency
+                );
+
+                _appendHistogram(
+                    samples,
+                    "espressio_thread_garbage_collection_duration_nanoseconds",
+                    GarbageCollectionDuration
+                );
+
+                _appendHistogram(
+                    samples,
+                    "espressio_thread_manager_lock_wait_nanoseconds",
+                    ManagerLockWait
+                );
+
+                _appendHistogram(
+                    samples,
+                    "espressio_thread_iteration_duration_nanoseconds",
+                    IterationDuration
+                );
+
+                _appendHistogram(
+                    samples,
+                    "espressio_thread_iteration_jitter_nanoseconds",
+                    IterationJitter
+                );
+
+                for (
+                    std::size_t index = 0;
+                    index < _registrationCount;
+                    ++index
+                ) {
+                    const Registration& registration =
+                        _registrations[index];
+
+                    switch (registration.Type) {
+                        case ThreadMetricType::Counter:
+                            _appendCounter(
+                                samples,
+                                registration.Name,
+                                *static_cast<ThreadMetricCounter*>(
+                                    registration.Metric
+                                )
+                            );
+                            break;
+
+                        case ThreadMetricType::Gauge:
+                            samples.emplace_back();
+                            samples.back().Name = registration.Name;
+                            samples.back().Type = ThreadMetricType::Gauge;
+
+                            samples.back().Value =
+                                static_cast<ThreadMetricGauge*>(
+                                    registration.Metric
+                                )->GetValue();
+                            break;
+
+                        case ThreadMetricType::Histogram:
+                            _appendHistogram(
+                                samples,
+                                registration.Name,
+                                *static_cast<ThreadMetricHistogram*>(
+                                    registration.Metric
+                                )
+                            );
+                            break;
+                    }
+                }
+
+                return samples;
+            }
+
+
+            /*
+             * Writes a snapshot in the Prometheus text exposition format.
+             * Histograms are written as summaries with the 0.5, 0.9, 0.99
+             * and 0.999 quantiles, plus _sum, _count and _max.
+             */
+            void ExportText(
+                const TWrite& write
+            ) const {
+                static const struct {
+                    double Quantile;
+                    const char* Label;
+                } quantiles[] = {
+                    { 0.5, "quantile=\"0.5\"" },
+                    { 0.9, "quantile=\"0.9\"" },
+                    { 0.99, "quantile=\"0.99\"" },
+                    { 0.999, "quantile=\"0.999\"" }
+                };
+
+                const std::vector<ThreadMetricSample> samples =
+                    GetSnapshot();
+
+                const char* previousName = nullptr;
+                std::size_t previousLength = 0;
+
+                char number[32];
+
+                for (const ThreadMetricSample& sample : samples) {
+                    const char* labels =
+                        std::strchr(sample.Name, '{');
+
+                    const std::size_t baseLength =
+                        labels != nullptr
+                            ? static_cast<std::size_t>(labels - sample.Name)
+                            : std::strlen(sample.Name);
+
+                    // One TYPE line per metric family.
+                    if (
+                        previousName == nullptr ||
+                        previousLength != baseLength ||
+                        std::strncmp(
+                            previousName,
+                            sample.Name,
+                            baseLength
+                        ) != 0
+                    ) {
+                        _writeText(write, "# TYPE ");
+
+                        write(
+                            reinterpret_cast<const uint8_t*>(sample.Name),
+                            baseLength
+                        );
+
+                        _writeText(
+                            write,
+                            sample.Type == ThreadMetricType::Counter
+                                ? " counter\n"
+                                : sample.Type == ThreadMetricType::Gauge
+                                    ? " gauge\n"
+                                    : " summary\n"
+                        );
+
+                        previousName = sample.Name;
+                        previousLength = baseLength;
+                    }
+
+                    if (sample.Type != ThreadMetricType::Histogram) {
+                        _writeName(write, sample.Name, "", "");
+
+                        std::snprintf(
+                            number,
+                            sizeof(number),
+                            " %" PRId64 "\n",
+                            sample.Value
+                        );
+
+                        _writeText(write, number);
+                        continue;
+                    }
+
+                    for (const auto& quantile : quantiles) {
+                        _writeName(
+                            write,
+                            sample.Name,
+                            "",
+                            quantile.Label
+                        );
+
+                        std::snprintf(
+                            number,
+                            sizeof(number),
+                            " %" PRIu64 "\n",
+                            sample.Histogram.GetPercentile(
+                                quantile.Quantile
+                            )
+                        );
+
+                        _writeText(write, number);
+                    }
+
+                    const struct {
+                        const char* Suffix;
+                        uint64_t Value;
+                    } totals[] = {
+                        { "_sum", sample.Histogram.Sum },
+                        { "_count", sample.Histogram.Count },
+                        { "_max", sample.Histogram.Maximum }
+                    };
+
+                    for (const auto& total : totals) {
+                        _writeName(
+                            write,
+                            sample.Name,
+                            total.Suffix,
+                            ""
+                        );
+
+                        std::snprintf(
+                            number,
+                            sizeof(number),
+                            " %" PRIu64 "\n",
+                            total.Value
+                        );
+
+                        _writeText(write, number);
+                    }
+                }
+            }
+
+
+            /*
+             * Writes a snapshot compactly: a ThreadMetricsBinaryHeader,
+             * then per metric its type (u8), name length (u8) and name,
+             * followed by a counter's u64 or a gauge's i64, or a
+             * histogram's count, sum, minimum and maximum (u64 each), the
+             * number of non-empty buckets (u16) and, per such bucket, its
+             * index (u16) and count (u32). tools/espressio_metrics.py
+             * decodes it.
+             */
+            void ExportBinary(
+                const TWrite& write
+            ) const {
+                const std::vector<ThreadMetricSample> samples =
+                    GetSnapshot();
+
+                ThreadMetricsBinaryHeader header;
+
+                std::memcpy(
+                    header.Magic,
+                    "ESPM",
+                    4
+                );
+
+                header.Version = 1;
+
+                header.MetricCount =
+                    static_cast<uint16_t>(
+                        samples.size()
+                    );
+
+                header.PrecisionBits =
+                    ThreadMetricHistogramLayout::PrecisionBits;
+
+                header.RangeBits =
+                    ThreadMetricHistogramLayout::RangeBits;
+
+                header.Reserved = 0;
+
+                _writeBytes(
+                    write,
+                    &header,
+                    sizeof(header)
+                );
+
+                for (const ThreadMetricSample& sample : samples) {
+                    const std::size_t fullLength =
+                        std::strlen(sample.Name);
+
+                    const uint8_t record[2] = {
+                        static_cast<uint8_t>(sample.Type),
+                        static_cast<uint8_t>(
+                            fullLength < 255
+                                ? fullLength
+                                : 255
+                        )
+                    };
+
+                    _writeBytes(write, record, sizeof(record));
+                    _writeBytes(write, sample.Name, record[1]);
+
+                    if (sample.Type != ThreadMetricType::Histogram) {
+                        _writeBytes(
+                            write,
+                            &sample.Value,
+                            sizeof(sample.Value)
+                        );
+
+                        continue;
+                    }
+
+                    const ThreadMetricHistogramSnapshot& histogram =
+                        sample.Histogram;
+
+                    const uint64_t totals[4] = {
+                        histogram.Count,
+                        histogram.Sum,
+                        histogram.Minimum,
+                        histogram.Maximum
+                    };
+
+                    _writeBytes(write, totals, sizeof(totals));
+
+                    uint16_t used = 0;
+
+                    for (const uint32_t bucket : histogram.Buckets) {
+                        if (bucket != 0) {
+                            ++used;
+                        }
+                    }
+
+                    _writeBytes(write, &used, sizeof(used));
+
+                    for (
+                        uint16_t index = 0;
+                        index < ThreadMetricHistogramLayout::BucketCount;
+                        ++index
+                    ) {
+                        if (histogram.Buckets[index] == 0) {
+                            continue;
+                        }
+
+                        _writeBytes(write, &index, sizeof(index));
+
+                        _writeBytes(
+                            write,
+                            &histogram.Buckets[index],
+                            sizeof(histogram.Buckets[index])
+                        );
+                    }
+                }
+            }
+    };
+
+}
+}
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ESPressio_IThreadPlacementPolicy.hpp"
+
+// Load assumed for a Thread without runtime accounting, in thousandths of a
+// core. Without ESPRESSIO_THREAD_RUNTIME_STATISTICS every Thread counts as
+// this much, so least-loaded placement balances Thread counts.
+#ifndef ESPRESSIO_THREAD_PLACEMENT_DEFAULT_LOAD_PERMILLE
+    #define ESPRESSIO_THREAD_PLACEMENT_DEFAULT_LOAD_PERMILLE 100
+#endif
+
+namespace ESPressio {
+namespace Threads {
+
+    /*
+     * Places each Thread on the core with the least measured CPU load.
+     *
+     * Ties go to the core with fewer Threads, then to the lower core.
+     */
+    class LeastLoadedThreadPlacementPolicy :
+        public IThreadPlacementPolicy {
+
+        public:
+            int PlaceThread(
+                IThread*,
+                const ThreadPlacementLoad&,
+                const std::vector<
+                    ThreadPlacementLoad
+                >& activeThreads,
+                int coreCount
+            ) override {
+                std::vector<
+                    std::pair<uint64_t, uint32_t>
+                > cores(
+                    static_cast<std::size_t>(coreCount)
+                );
+
+                for (
+                    const ThreadPlacementLoad& active :
+                    activeThreads
+                ) {
+                    const int coreID =
+                        active.Thread.CoreID;
+
+                    if (
+                        coreID < 0 ||
+                        coreID >= coreCount
+                    ) {
+                        continue;
+                    }
+
+                    cores[coreID].first +=
+                        active.LoadMeasured
+                            ? active.LoadPermille
+                            : ESPRESSIO_THREAD_PLACEMENT_DEFAULT_LOAD_PERMILLE;
+
+                    ++cores[coreID].second;
+                }
+
+                int chosen = 0;
+
+                for (
+                    int coreID = 1;
+                    coreID < coreCount;
+                    ++coreID
+                ) {
+                    if (cores[coreID] < cores[chosen]) {
+                        chosen = coreID;
+                    }
+                }
+
+                return chosen;
+            }
+    };
+
+
+    /*
+     * Spreads Threads of equal or higher priority across cores, so two
+     * high-priority Threads do not compete for the same core while another
+     * runs only idle work.
+     *
+     * Ties go to the core with fewer Threads overall, then to the lower core.
+     */
+    class PrioritySpreadThreadPlacementPolicy :
+        public IThreadPlacementPolicy {
+
+        public:
+            int PlaceThread(
+                IThread*,
+                const ThreadPlacementLoad& placing,
+                const std::vector<
+                    ThreadPlacementLoad
+                >& activeThreads,
+                int coreCount
+            ) override {
+                std::vector<
+                    std::pair<uint32_t, uint32_t>
+                > cores(
+                    static_cast<std::size_t>(coreCount)
+                );
+
+                for (
+                    const ThreadPlacementLoad& active :
+                    activeThreads
+                ) {
+                    const int coreID =
+                        active.Thread.CoreID;
+
+                    if (
+                        coreID < 0 ||
+                        coreID >= coreCount
+                    ) {
+                        continue;
+                    }
+
+                    if (active.Priority >= placing.Priority) {
+                        ++cores[coreID].first;
+                    }
+
+                    ++cores[coreID].second;
+                }
+
+                int chosen = 0;
+
+                for (
+                    int coreID = 1;
+                    coreID < coreCount;
+                    ++coreID
+                ) {
+                    if (cores[coreID] < cores[chosen]) {
+                        chosen = coreID;
+                    }
+                }
+
+                return chosen;
+            }
+    };
+
+
+    /*
+     * Keeps Threads of one affinity group on one core.
+     *
+     * Set a Thread's group with ThreadManager::SetAffinityGroup(). A group
+     * bound with BindGroup() always uses its core; an unbound group follows
+     * its first active member. The first member of an unbound group, and
+     * every Thread outside a group, is placed by the fallback policy
+     * (least-loaded unless one is given). The fallback is not owned.
+     */
+    class AffinityGroupThreadPlacementPolicy :
+        public IThreadPlacementPolicy {
+
+        private:
+            IThreadPlacementPolicy* _fallback;
+            LeastLoadedThreadPlacementPolicy _leastLoaded;
+
+            std::mutex _bindingsMutex;
+
+            std::vector<
+                std::pair<uint8_t, int>
+            > _bindings;
+
+
+            bool _boundCore(
+                uint8_t group,
+                int& coreID
+            ) {
+                std::lock_guard<
+                    std::mutex
+                > lock(_bindingsMutex);
+
+                for (
+                    const std::pair<uint8_t, int>& binding :
+                    _bindings
+                ) {
+                    if (binding.first == group) {
+                        coreID = binding.second;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+
+        public:
+            explicit AffinityGroupThreadPlacementPolicy(
+                IThreadPlacementPolicy* fallback = nullptr
+            ) :
+                _fallback(fallback) {
+            }
+
+
+            /// Places every member of `group` on `coreID`. Group 0 cannot be
+            /// bound.
+            void BindGroup(
+                uint8_t group,
+                int coreID
+            ) {
+                if (group == 0) {
+                    return;
+                }
+
+                std::lock_guard<
+                    std::mutex
+                > lock(_bindingsMutex);
+
+                for (
+                    std::pair<uint8_t, int>& binding :
+                    _bindings
+                ) {
+                    if (binding.first == group) {
+                        binding.second = coreID;
+                        return;
+                    }
+                }
+
+                _bindings.emplace_back(
+                    group,
+                    coreID
+                );
+            }
+
+
+            void UnbindGroup(
+                uint8_t group
+            ) {
+                std::lock_guard<
+                    std::mutex
+                > lock(_bindingsMutex);
+
+                for (
+                    auto binding = _bindings.begin();
+                    binding != _bindings.end();
+                    ++binding
+                ) {
+                    if (binding->first == group) {
+                        _bindings.erase(binding);
+                        return;
+                    }
+                }
+            }
+
+
+            int PlaceThread(
+                IThread* thread,
+                const ThreadPlacementLoad& placing,
+                const std::vector<
+                    ThreadPlacementLoad
+                >& activeThreads,
+                int coreCount
+            ) override {
+                const uint8_t group =
+                    placing.Thread.AffinityGroup;
+
+                if (group != 0) {
+                    int coreID = 0;
+
+                    if (_boundCore(group, coreID)) {
+                        return coreID;
+                    }
+
+                    for (
+                        const ThreadPlacementLoad& active :
+                        activeThreads
+                    ) {
+                        if (active.Thread.AffinityGroup == group) {
+                            return active.Thread.CoreID;
+                        }
+                    }
+                }
+
+                IThreadPlacementPolicy* fallback =
+                    _fallback != nullptr
+                        ? _fallback
+                        : &_leastLoaded;
+
+                return
+                    fallback->PlaceThread(
+                        thread,
+                        placing,
+                        activeThreads,
+                        coreCount
+                    );
+            }
+    };
+
+}
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// define as 1 to park the FreeRTOS task of a terminated Thread for reuse by
+// the next Thread initialized with the same core, stack size and priority.
+#ifndef ESPRESSIO_THREAD_TASK_RECYCLING
+    #define ESPRESSIO_THREAD_TASK_RECYCLING 0
+#endif
+
+#ifndef ESPRESSIO_THREAD_TASK_POOL_CAPACITY
+    #define ESPRESSIO_THREAD_TASK_POOL_CAPACITY 8
+#endif
+
+namespace ESPressio {
+namespace Threads {
+
+    struct ThreadTaskPoolStatistics {
+        std::size_t ParkedTasks = 0;
+        std::size_t TasksParked = 0;
+        std::size_t TasksClaimed = 0;
+        std::size_t ParkRejected = 0;
+        std::size_t ClaimMissed = 0;
+    };
+
+
+    /*
+     * Pool of idle Thread worker tasks.
+     *
+     * A parked task is blocked on its task notification, with its stack and
+     * TCB still allocated. Claiming a task removes it from the pool; the
+     * claiming Thread then binds itself through the task's TLS slot and
+     * releases it with the same notification that gates a freshly created
+     * task. Tasks are only interchangeable when core, stack size and
+     * priority all match exactly.
+     */
+    class ThreadTaskPool {
+        private:
+            struct TaskRecord {
+                TaskHandle_t Task;
+                int CoreID;
+                uint32_t StackSize;
+                unsigned int Priority;
+            };
+
+
+            mutable std::mutex _mutex;
+
+            std::vector<TaskRecord> _tasks;
+
+            ThreadTaskPoolStatistics _statistics;
+
+
+            ThreadTaskPool() {
+                _tasks.reserve(
+                    ESPRESSIO_THREAD_TASK_POOL_CAPACITY
+                );
+            }
+
+
+        public:
+            static ThreadTaskPool*
+            GetInstance() {
+                // Process-lifetime by design: parked tasks may outlive any
+                // static destruction order.
+                static ThreadTaskPool* instance =
+                    new ThreadTaskPool();
+
+                return instance;
+            }
+
+
+            ThreadTaskPool(
+                const ThreadTaskPool&
+            ) = delete;
+
+            ThreadTaskPool& operator=(
+                const ThreadTaskPool&
+            ) = delete;
+
+
+            /// Offers the calling worker task to the pool. Returns `false`
+            /// when the pool is full, in which case the task must delete
+            /// itself.
+            bool Park(
+                TaskHandle_t task,
+                int coreID,
+                uint32_t stackSize,
+                unsigned int priority
+            ) {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                if (
+                    task == nullptr ||
+                    _tasks.size() >=
+                        ESPRESSIO_THREAD_TASK_POOL_CAPACITY
+                ) {
+                    ++_statistics.ParkRejected;
+                    return false;
+                }
+
+                _tasks.push_back({
+                    task,
+                    coreID,
+                    stackSize,
+                    priority
+                });
+
+                ++_statistics.TasksParked;
+
+                return true;
+            }
+
+
+            /// Removes and returns a parked task with exactly matching
+            /// attributes, or `nullptr` when none is parked.
+            TaskHandle_t Claim(
+                int coreID,
+                uint32_t stackSize,
+                unsigned int priority
+            ) {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                const auto matching =
+                    std::find_if(
+                        _tasks.begin(),
+                        _tasks.end(),
+                        [&](const TaskRecord& record) {
+                            return
+                                record.CoreID == coreID &&
+                                record.StackSize == stackSize &&
+                                record.Priority == priority;
+                        }
+                    );
+
+                if (matching == _tasks.end()) {
+                    ++_statistics.ClaimMissed;
+                    return nullptr;
+                }
+
+                const TaskHandle_t task =
+                    matching->Task;
+
+                _tasks.erase(matching);
+
+                ++_statistics.TasksClaimed;
+
+                return task;
+            }
+
+
+            /// Deletes every parked task, returning their memory to the heap.
+            std::size_t Drain() {
+                std::vector<TaskRecord> tasks;
+
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+
+                    tasks.swap(_tasks);
+                }
+
+                for (const TaskRecord& record : tasks) {
+                    vTaskDelete(record.Task);
+                }
+
+                return tasks.size();
+            }
+
+
+            ThreadTaskPoolStatistics GetStatistics() const {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                ThreadTaskPoolStatistics statistics =
+                    _statistics;
+
+                statistics.ParkedTasks =
+                    _tasks.size();
+
+                return statistics;
+            }
+    };
+
+}
+}
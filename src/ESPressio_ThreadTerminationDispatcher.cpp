@@ -1,5 +1,9 @@
 #include "ESPressio_ThreadTerminationDispatcher.hpp"
 #include "ESPressio_Thread.hpp"
+#include "ESPressio_ThreadGarbageCollector.hpp"
+
+#include <mutex>
+#include <string>
 
 namespace ESPressio {
 namespace Threads {
@@ -34,43 +38,86 @@ namespace Threads {
             return snapshot;
         }
 
-    }
 
+        constexpr int DispatcherCount =
+            #if ESPRESSIO_THREAD_TERMINATION_DISPATCHER_PER_CORE
+                #if defined(portNUM_PROCESSORS)
+                    portNUM_PROCESSORS > 0
+                        ? portNUM_PROCESSORS
+                        : 1;
+                #elif defined(configNUMBER_OF_CORES)
+                    configNUMBER_OF_CORES > 0
+                        ? configNUMBER_OF_CORES
+                        : 1;
+                #else
+                    1;
+                #endif
+            #else
+                1;
+            #endif
 
-    ThreadTerminationDispatcher::
-    ThreadTerminationDispatcher() {
-        _queue =
-            xQueueCreate(
-                ESPRESSIO_THREAD_TERMINATION_QUEUE_LENGTH,
-                sizeof(DispatchRecord)
-            );
 
-        if (_queue == nullptr) {
-            _observable->Initialized(false);
-            return;
-        }
+        std::once_flag
+            DispatcherOnce[DispatcherCount];
 
-        const BaseType_t result =
-            xTaskCreate(
-                _taskEntry,
-                "threadTerminationDispatcher",
-                ESPRESSIO_THREAD_TERMINATION_DISPATCHER_STACK_SIZE,
-                this,
-                ESPRESSIO_THREAD_TERMINATION_DISPATCHER_PRIORITY,
-                &_taskHandle
-            );
+        std::atomic<ThreadTerminationDispatcher*>
+            Dispatchers[DispatcherCount] = {};
+
+    }
 
-        if (result != pdPASS) {
-            vQueueDelete(_queue);
 
-            _queue = nullptr;
-            _taskHandle = nullptr;
+    ThreadTerminationDispatcher::
+    ThreadTerminationDispatcher(
+        int coreID
+    ) :
+        _coreID(coreID) {
+    }
 
-            _observable->Initialized(false);
-            return;
-        }
 
-        _observable->Initialized(true);
+    bool ThreadTerminationDispatcher::
+    EnsureStarted() {
+        std::call_once(
+            _startOnce,
+            [this]() {
+                const std::string taskName =
+                    _coreID == tskNO_AFFINITY
+                        ? "threadTerminationDispatcher"
+                        : "termDispatcher" +
+                          std::to_string(_coreID);
+
+                TaskHandle_t createdTask =
+                    nullptr;
+
+                const BaseType_t result =
+                    xTaskCreatePinnedToCore(
+                        _taskEntry,
+                        taskName.c_str(),
+                        ESPRESSIO_THREAD_TERMINATION_DISPATCHER_STACK_SIZE,
+                        this,
+                        ESPRESSIO_THREAD_TERMINATION_DISPATCHER_PRIORITY,
+                        &createdTask,
+                        _coreID
+                    );
+
+                if (result == pdPASS) {
+                    _taskHandle.store(
+                        createdTask,
+                        std::memory_order_release
+                    );
+                }
+
+                _started.store(
+                    true,
+                    std::memory_order_release
+                );
+
+                _observable->Initialized(
+                    result == pdPASS
+                );
+            }
+        );
+
+        return IsAvailable();
     }
 
 
@@ -91,65 +138,313 @@ namespace Threads {
     }
 
 
+    void ThreadTerminationDispatcher::
+    _push(
+        ThreadTerminationDispatchNode* node
+    ) {
+        ThreadTerminationDispatchNode* head =
+            _pending.load(
+                std::memory_order_relaxed
+            );
+
+        do {
+            node->Next = head;
+        } while (
+            !_pending.compare_exchange_weak(
+                head,
+                node,
+                std::memory_order_release,
+                std::memory_order_relaxed
+            )
+        );
+    }
+
+
+    ThreadTerminationDispatchNode*
+    ThreadTerminationDispatcher::
+    _detach() {
+        ThreadTerminationDispatchNode* node =
+            _pending.exchange(
+                nullptr,
+                std::memory_order_acquire
+            );
+
+        /*
+         * The list is pushed LIFO. Reverse the detached batch so
+         * terminations are dispatched in the order they were reported.
+         */
+        ThreadTerminationDispatchNode* ordered =
+            nullptr;
+
+        while (node != nullptr) {
+            ThreadTerminationDispatchNode* next =
+                node->Next;
+
+            node->Next = ordered;
+            ordered = node;
+            node = next;
+        }
+
+        return ordered;
+    }
+
+
     void ThreadTerminationDispatcher::
     _loop() {
         for (;;) {
-            DispatchRecord record;
+            uint32_t events = 0;
 
             if (
-                xQueueReceive(
-                    _queue,
-                    &record,
+                xTaskNotifyWait(
+                    0,
+                    ~static_cast<uint32_t>(0),
+                    &events,
                     portMAX_DELAY
-                ) != pdTRUE ||
-                record.ThreadPointer ==
-                    nullptr
+                ) != pdTRUE
             ) {
                 continue;
             }
 
-            _observable->Started(
-                record.Snapshot
-            );
+            if ((events & TerminationEvent) != 0) {
+                _dispatchPending();
+            }
 
-            record.ThreadPointer->
-                _dispatchTermination();
+            if ((events & GarbageCollectionEvent) != 0) {
+                /*
+                 * Pending terminations were dispatched first, so the
+                 * collection observes every FreeOnTerminate Thread that
+                 * has finished dispatch by now.
+                 */
+                ThreadGarbageCollector::GetInstance()->
+                    _collect(
+                        ThreadGarbageCollectionExecutionMode::
+                            AsynchronousWorker
+                    );
+            }
+        }
+    }
+
+
+    void ThreadTerminationDispatcher::
+    _dispatchPending() {
+        ThreadTerminationDispatchNode* node =
+            _detach();
 
+        while (node != nullptr) {
             /*
-             * Do not dereference the Thread after termination dispatch:
-             * automatic GC can now own its eventual destruction.
+             * The node is embedded in the Thread. Copy everything
+             * required before dispatch: automatic GC can own the
+             * Thread's destruction once dispatch has completed.
              */
-            _observable->Completed(
-                record.Snapshot
-            );
+            ThreadTerminationDispatchNode* next =
+                node->Next;
+
+            Thread* thread =
+                node->ThreadPointer;
+
+            const ThreadManagerThreadSnapshot snapshot =
+                node->Snapshot;
+
+            #if ESPRESSIO_THREAD_METRICS
+                const uint64_t queuedNanoseconds =
+                    node->QueuedNanoseconds;
+            #endif
+
+            node->Next = nullptr;
+
+            if (thread != nullptr) {
+                _observable->Started(
+                    snapshot
+                );
+
+                RecordThreadTrace(
+                    ThreadTraceEventType::DispatchBegin,
+                    snapshot.ThreadID
+                );
+
+                thread->
+                    _dispatchTermination();
+
+                RecordThreadTrace(
+                    ThreadTraceEventType::DispatchEnd,
+                    snapshot.ThreadID
+                );
+
+                #if ESPRESSIO_THREAD_METRICS
+                    const uint64_t dispatchedNanoseconds =
+                        ThreadMetrics::GetNowNanoseconds();
+
+                    ThreadMetrics::GetInstance()->
+                        TerminationDispatchLatency.Record(
+                            dispatchedNanoseconds >= queuedNanoseconds
+                                ? dispatchedNanoseconds - queuedNanoseconds
+                                : 0
+                        );
+                #endif
+
+                /*
+                 * Do not dereference the Thread after termination
+                 * dispatch: automatic GC can now own its eventual
+                 * destruction.
+                 */
+                _observable->Completed(
+                    snapshot
+                );
+            }
+
+            node = next;
         }
     }
 
 
+    std::shared_ptr<
+        ThreadTerminationDispatcher::DispatcherObservable
+    >
+    ThreadTerminationDispatcher::
+    _sharedObservable() {
+        static std::shared_ptr<DispatcherObservable>
+            observable =
+                std::make_shared<
+                    DispatcherObservable
+                >();
+
+        return observable;
+    }
+
+
     ThreadTerminationDispatcher*
     ThreadTerminationDispatcher::
     GetInstance() {
-        static ThreadTerminationDispatcher
-            instance;
+        return GetInstance(0);
+    }
+
 
-        return &instance;
+    ThreadTerminationDispatcher*
+    ThreadTerminationDispatcher::
+    GetInstance(
+        int coreID
+    ) {
+        const int index =
+            coreID >= 0 &&
+            coreID < DispatcherCount
+                ? coreID
+                : 0;
+
+        // Process-lifetime by design, matching the other infrastructure
+        // singletons.
+        std::call_once(
+            DispatcherOnce[index],
+            [index]() {
+                Dispatchers[index].store(
+                    new ThreadTerminationDispatcher(
+                        ESPRESSIO_THREAD_TERMINATION_DISPATCHER_PER_CORE
+                            ? index
+                            : tskNO_AFFINITY
+                    ),
+                    std::memory_order_release
+                );
+            }
+        );
+
+        return Dispatchers[index].load(
+            std::memory_order_acquire
+        );
+    }
+
+
+    bool ThreadTerminationDispatcher::
+    RequestGarbageCollection(
+        bool* coalesced
+    ) {
+        if (!IsAvailable()) {
+            return false;
+        }
+
+        uint32_t previousEvents = 0;
+
+        xTaskNotifyAndQuery(
+            _taskHandle.load(
+                std::memory_order_acquire
+            ),
+            GarbageCollectionEvent,
+            eSetBits,
+            &previousEvents
+        );
+
+        if (coalesced != nullptr) {
+            *coalesced =
+                (previousEvents & GarbageCollectionEvent) != 0;
+        }
+
+        return true;
+    }
+
+
+    bool ThreadTerminationDispatcher::
+    IsAnyDispatcherTask() {
+        for (
+            int index = 0;
+            index < DispatcherCount;
+            ++index
+        ) {
+            const ThreadTerminationDispatcher* dispatcher =
+                Dispatchers[index].load(
+                    std::memory_order_acquire
+                );
+
+            if (
+                dispatcher != nullptr &&
+                dispatcher->IsCurrentTask()
+            ) {
+                return true;
+            }
+        }
+
+        return false;
     }
 
 
     bool ThreadTerminationDispatcher::
     IsAvailable() const {
         return
-            _queue != nullptr &&
-            _taskHandle != nullptr;
+            _taskHandle.load(
+                std::memory_order_acquire
+            ) != nullptr;
     }
 
 
     bool ThreadTerminationDispatcher::
     IsCurrentTask() const {
+        const TaskHandle_t taskHandle =
+            _taskHandle.load(
+                std::memory_order_acquire
+            );
+
         return
-            _taskHandle != nullptr &&
+            taskHandle != nullptr &&
             xTaskGetCurrentTaskHandle() ==
-                _taskHandle;
+                taskHandle;
+    }
+
+
+    uint32_t ThreadTerminationDispatcher::
+    GetStackHighWaterMark() const {
+        // The dispatcher task never exits, so the handle stays valid.
+        const TaskHandle_t taskHandle =
+            _taskHandle.load(
+                std::memory_order_acquire
+            );
+
+        if (taskHandle == nullptr) {
+            return 0;
+        }
+
+        return
+            static_cast<uint32_t>(
+                uxTaskGetStackHighWaterMark(
+                    taskHandle
+                )
+            );
     }
 
 
@@ -157,43 +452,61 @@ namespace Threads {
     Dispatch(
         Thread* thread
     ) {
-        if (
-            !IsAvailable() ||
-            thread == nullptr
-        ) {
+        if (thread == nullptr) {
+            return false;
+        }
+
+        /*
+         * The list itself cannot overflow, so the only failure left is a
+         * dispatcher task that could not be created. The exiting Thread is
+         * then released without OnTerminated or TaskExited notifications.
+         */
+        if (!IsAvailable()) {
+            _observable->QueueFailed(
+                SnapshotThread(thread)
+            );
+
             return false;
         }
 
-        DispatchRecord record;
+        ThreadTerminationDispatchNode& node =
+            thread->_terminationDispatchNode;
 
-        record.ThreadPointer =
+        node.ThreadPointer =
             thread;
 
-        record.Snapshot =
+        node.Snapshot =
             SnapshotThread(thread);
 
+        #if ESPRESSIO_THREAD_METRICS
+            node.QueuedNanoseconds =
+                ThreadMetrics::GetNowNanoseconds();
+        #endif
+
+        /*
+         * Report before linking so observers always see Queued ahead of
+         * Started: the dispatcher may consume the node immediately.
+         */
+        _observable->Queued(
+            node.Snapshot
+        );
+
         /*
          * Dispatch is called from FreeRTOS task-deletion cleanup, where
-         * waiting for queue capacity is unsafe.
+         * blocking is unsafe. Linking the Thread's embedded node never
+         * blocks and never fails, so no termination can be dropped.
          */
-        const bool queued =
-            xQueueSend(
-                _queue,
-                &record,
-                0
-            ) == pdTRUE;
-
-        if (queued) {
-            _observable->Queued(
-                record.Snapshot
-            );
-        } else {
-            _observable->QueueFailed(
-                record.Snapshot
-            );
-        }
+        _push(&node);
+
+        xTaskNotify(
+            _taskHandle.load(
+                std::memory_order_acquire
+            ),
+            TerminationEvent,
+            eSetBits
+        );
 
-        return queued;
+        return true;
     }
 
 }
@@ -1,14 +1,16 @@
 #pragma once
 
 #include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
 #include "freertos/task.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 
 #include <ESPressio_IObservable.hpp>
 
 #include "ESPressio_IThreadTerminationDispatcherObserver.hpp"
+#include "ESPressio_ThreadTerminationDispatcherTypes.hpp"
 #include "ESPressio_ThreadSafeObservable.hpp"
 
 #ifndef ESPRESSIO_THREAD_TERMINATION_DISPATCHER_STACK_SIZE
@@ -19,8 +21,16 @@
     #define ESPRESSIO_THREAD_TERMINATION_DISPATCHER_PRIORITY 2
 #endif
 
-#ifndef ESPRESSIO_THREAD_TERMINATION_QUEUE_LENGTH
-    #define ESPRESSIO_THREAD_TERMINATION_QUEUE_LENGTH 256
+// define as 1 to run one dispatcher task pinned to each core. Terminations
+// are then dispatched on the exiting Thread's own core, in parallel.
+#ifndef ESPRESSIO_THREAD_TERMINATION_DISPATCHER_PER_CORE
+    #define ESPRESSIO_THREAD_TERMINATION_DISPATCHER_PER_CORE 0
+#endif
+
+// define as 1 to run garbage collection on the (primary) termination
+// dispatcher task instead of a dedicated collector task and semaphore.
+#ifndef ESPRESSIO_THREAD_UNIFIED_INFRASTRUCTURE
+    #define ESPRESSIO_THREAD_UNIFIED_INFRASTRUCTURE 0
 #endif
 
 namespace ESPressio {
@@ -32,6 +42,11 @@ namespace Threads {
     class ThreadTerminationDispatcher {
 
     private:
+        // Task-notification event bits consumed by the dispatcher task.
+        static constexpr uint32_t TerminationEvent = 1u << 0;
+        static constexpr uint32_t GarbageCollectionEvent = 1u << 1;
+
+
         class DispatcherObservable final :
             public Observable::ThreadSafeObservable {
 
@@ -122,23 +137,34 @@ namespace Threads {
         };
 
 
-        struct DispatchRecord {
-            Thread* ThreadPointer = nullptr;
-            ThreadManagerThreadSnapshot Snapshot;
-        };
+        /*
+         * Multiple-producer, single-consumer intrusive list. Producers push
+         * embedded Thread nodes with a CAS; the dispatcher task detaches the
+         * whole list in one exchange and restores FIFO order locally.
+         */
+        std::atomic<ThreadTerminationDispatchNode*>
+            _pending{nullptr};
+
+        std::atomic<TaskHandle_t> _taskHandle{nullptr};
 
+        // The task is created on first need rather than construction.
+        std::once_flag _startOnce;
+        std::atomic<bool> _started{false};
 
-        QueueHandle_t _queue = nullptr;
-        TaskHandle_t _taskHandle = nullptr;
+        int _coreID;
 
+        // Shared by every dispatcher so observers see all cores.
         std::shared_ptr<DispatcherObservable>
             _observable =
-                std::make_shared<
-                    DispatcherObservable
-                >();
+                _sharedObservable();
 
 
-        ThreadTerminationDispatcher();
+        explicit ThreadTerminationDispatcher(
+            int coreID
+        );
+
+        static std::shared_ptr<DispatcherObservable>
+        _sharedObservable();
 
         static void _taskEntry(
             void* parameter
@@ -146,6 +172,14 @@ namespace Threads {
 
         void _loop();
 
+        void _dispatchPending();
+
+        void _push(
+            ThreadTerminationDispatchNode* node
+        );
+
+        ThreadTerminationDispatchNode* _detach();
+
 
     public:
         ThreadTerminationDispatcher(
@@ -158,14 +192,48 @@ namespace Threads {
         ) = delete;
 
 
+        /// Returns the primary dispatcher. With per-core dispatch enabled
+        /// this is the dispatcher pinned to core 0.
         static ThreadTerminationDispatcher*
         GetInstance();
 
+        /// Returns the dispatcher serving Threads pinned to `coreID`. Without
+        /// per-core dispatch, or for an out-of-range core, this is the
+        /// primary dispatcher. Per-core dispatchers are created on first use.
+        static ThreadTerminationDispatcher*
+        GetInstance(int coreID);
+
+        /// Returns whether the calling task is any termination dispatcher.
+        static bool IsAnyDispatcherTask();
+
+
+        /// Creates the dispatcher task on first call and returns whether it
+        /// is available. Thread initialization calls this, so the task only
+        /// exists once a Thread actually needs dispatch.
+        bool EnsureStarted();
 
         bool IsAvailable() const;
         bool IsCurrentTask() const;
+
+        /// Returns the least free stack the dispatcher task has had, in
+        /// ESPRESSIO_THREAD_TERMINATION_DISPATCHER_STACK_SIZE units, or 0
+        /// before the task exists.
+        uint32_t GetStackHighWaterMark() const;
         bool Dispatch(Thread* thread);
 
+        /// Queues a garbage-collection event on this dispatcher's task.
+        /// Used by the unified infrastructure runtime. `coalesced` reports
+        /// whether a collection event was already pending.
+        bool RequestGarbageCollection(
+            bool* coalesced = nullptr
+        );
+
+        /// Returns the core this dispatcher is pinned to, or
+        /// `tskNO_AFFINITY` for the shared dispatcher.
+        int GetCoreID() const {
+            return _coreID;
+        }
+
 
         Observable::ObserverHandlePtr
         RegisterObserver(
@@ -176,7 +244,14 @@ namespace Threads {
                     observer
                 );
 
-            if (observer != nullptr) {
+            // Before first need there is nothing to report yet; the
+            // observer is notified when the task is created.
+            if (
+                observer != nullptr &&
+                _started.load(
+                    std::memory_order_acquire
+                )
+            ) {
                 try {
                     observer->
                         OnThreadTerminationDispatcherInitialized(
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "ESPressio_ThreadManagerTypes.hpp"
+#include "ESPressio_ThreadMetrics.hpp"
+
+namespace ESPressio {
+namespace Threads {
+
+    class Thread;
+
+
+    /*
+     * Intrusive termination-dispatch node.
+     *
+     * Every Thread embeds exactly one node. A Thread can have at most one
+     * termination dispatch outstanding (guarded by its pending flag), so the
+     * node can be linked onto the dispatcher's lock-free list without any
+     * allocation and without a bounded queue that could overflow.
+     */
+    struct ThreadTerminationDispatchNode {
+        ThreadTerminationDispatchNode* Next = nullptr;
+        Thread* ThreadPointer = nullptr;
+        ThreadManagerThreadSnapshot Snapshot;
+
+        #if ESPRESSIO_THREAD_METRICS
+            // When Dispatch() queued the node.
+            uint64_t QueuedNanoseconds = 0;
+        #endif
+    };
+
+}
+}
@@ -0,0 +1,553 @@
+#pragma once
+
+#include <cstdint>
+
+// define as 1 to compile in the binary trace recorder. When 0 every trace
+// point is an empty inline function.
+#ifndef ESPRESSIO_THREAD_TRACE
+    #define ESPRESSIO_THREAD_TRACE 0
+#endif
+
+// Events kept per core; a power of two. The oldest are overwritten.
+#ifndef ESPRESSIO_THREAD_TRACE_RING_CAPACITY
+    #define ESPRESSIO_THREAD_TRACE_RING_CAPACITY 256
+#endif
+
+#if ESPRESSIO_THREAD_TRACE
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "ESPressio_ClockTypes.hpp"
+#include "ESPressio_SystemClock.hpp"
+#include "ESPressio_TimeTraits.hpp"
+
+static_assert(
+    ESPRESSIO_THREAD_TRACE_RING_CAPACITY >= 2 &&
+    (
+        ESPRESSIO_THREAD_TRACE_RING_CAPACITY &
+        (ESPRESSIO_THREAD_TRACE_RING_CAPACITY - 1)
+    ) == 0,
+    "ESPRESSIO_THREAD_TRACE_RING_CAPACITY must be a power of two"
+);
+
+#endif
+
+namespace ESPressio {
+namespace Threads {
+
+    /// Kinds of trace event. Begin/End pairs nest per Thread.
+    enum class ThreadTraceEventType : uint8_t {
+        // Argument: old state << 8 | new state.
+        StateChanged = 0,
+
+        LoopBegin = 1,
+        LoopEnd = 2,
+        IterationBegin = 3,
+        IterationEnd = 4,
+        WorkWake = 5,
+
+        // Argument: iterations skipped.
+        IterationsSkipped = 6,
+
+        // Termination dispatch of the Thread in ThreadID.
+        DispatchBegin = 7,
+        DispatchEnd = 8,
+
+        // Garbage collection pass; CollectEnd's argument is Threads deleted.
+        CollectBegin = 9,
+        CollectEnd = 10,
+
+        // Contended lock; argument is a ThreadTraceLock.
+        LockWaitBegin = 11,
+        LockWaitEnd = 12,
+
+        // Application-defined; argument is free.
+        Marker = 13
+    };
+
+
+    /// Locks reported by LockWaitBegin/LockWaitEnd.
+    enum class ThreadTraceLock : uint32_t {
+        StateTransition = 1
+    };
+
+
+    /// One recorded event, 16 bytes, as written by Dump().
+    struct ThreadTraceEvent {
+        uint64_t TimestampNanoseconds;
+        uint32_t Argument;
+        uint8_t Type;
+        uint8_t ThreadID;
+        uint8_t CoreID;
+        uint8_t Reserved;
+    };
+
+    static_assert(
+        sizeof(ThreadTraceEvent) == 16,
+        "ThreadTraceEvent is a fixed 16-byte record"
+    );
+
+
+    /// Header written by Dump(), followed by EventCount events ordered by
+    /// time. Fields are little-endian, as on every ESP32.
+    struct ThreadTraceDumpHeader {
+        char Magic[4];
+        uint16_t Version;
+        uint16_t EventSize;
+        uint32_t EventCount;
+
+        // Events overwritten before the dump.
+        uint32_t Overwritten;
+    };
+
+    static_assert(
+        sizeof(ThreadTraceDumpHeader) == 16,
+        "ThreadTraceDumpHeader is a fixed 16-byte record"
+    );
+
+
+    #if ESPRESSIO_THREAD_TRACE
+
+        /*
+         * Records fixed-size trace events into one ring per core.
+         *
+         * Recording claims a slot with one atomic increment on the calling
+         * core's ring and marks it complete through the slot's sequence
+         * number, so it never blocks and never allocates. When a ring is
+         * full the oldest events are overwritten. Timestamps come from the
+         * Timing SystemClock. Convert a Dump() with tools/espressio_trace.py.
+         */
+        class ThreadTraceRecorder {
+            private:
+                struct Slot {
+                    // Odd while being written; 2 * (index + 1) when done.
+                    std::atomic<uint32_t> Sequence{
+                        0
+                    };
+
+                    ThreadTraceEvent Event;
+                };
+
+
+                struct Ring {
+                    std::atomic<uint32_t> Next{
+                        0
+                    };
+
+                    Slot Slots[
+                        ESPRESSIO_THREAD_TRACE_RING_CAPACITY
+                    ];
+                };
+
+
+                static constexpr int _coreCount =
+                    #if defined(portNUM_PROCESSORS)
+                        portNUM_PROCESSORS > 0
+                            ? portNUM_PROCESSORS
+                            : 1;
+                    #else
+                        1;
+                    #endif
+
+
+                Ring _rings[
+                    _coreCount
+                ];
+
+                std::atomic<bool>
+                    _recording{
+                        false
+                    };
+
+
+                ThreadTraceRecorder() = default;
+
+
+                static uint8_t _currentCore() {
+                    #if defined(ESP_PLATFORM)
+                        const int coreID =
+                            static_cast<int>(
+                                xPortGetCoreID()
+                            );
+
+                        return
+                            static_cast<uint8_t>(
+                                coreID < _coreCount
+                                    ? coreID
+                                    : 0
+                            );
+                    #else
+                        return 0;
+                    #endif
+                }
+
+
+                static uint64_t _now() {
+                    return
+                        Timing::TimeTraits<
+                            Timing::DefaultClockTime
+                        >::template ToNanoseconds<
+                            uint64_t
+                        >(
+                            Timing::SystemClock<
+                                Timing::DefaultClockTime
+                            >::GetInstance().GetTime()
+                        );
+                }
+
+
+            public:
+                static ThreadTraceRecorder*
+                GetInstance() {
+                    // Process-lifetime by design: trace points may run
+                    // during static destruction.
+                    static ThreadTraceRecorder* instance =
+                        new ThreadTraceRecorder();
+
+                    return instance;
+                }
+
+
+                ThreadTraceRecorder(
+                    const ThreadTraceRecorder&
+                ) = delete;
+
+                ThreadTraceRecorder& operator=(
+                    const ThreadTraceRecorder&
+                ) = delete;
+
+
+                void Start() {
+                    _recording.store(
+                        true,
+                        std::memory_order_release
+                    );
+                }
+
+
+                void Stop() {
+                    _recording.store(
+                        false,
+                        std::memory_order_release
+                    );
+                }
+
+
+                bool IsRecording() const {
+                    return
+                        _recording.load(
+                            std::memory_order_relaxed
+                        );
+                }
+
+
+                /// Discards every recorded event. Call while stopped.
+                void Clear() {
+                    for (Ring& ring : _rings) {
+                        for (Slot& slot : ring.Slots) {
+                            slot.Sequence.store(
+                                0,
+                                std::memory_order_relaxed
+                            );
+                        }
+
+                        ring.Next.store(
+                            0,
+                            std::memory_order_release
+                        );
+                    }
+                }
+
+
+                void Record(
+                    ThreadTraceEventType type,
+                    uint8_t threadID,
+                    uint32_t argument
+                ) {
+                    if (!IsRecording()) {
+                        return;
+                    }
+
+                    const uint8_t coreID =
+                        _currentCore();
+
+                    Ring& ring =
+                        _rings[coreID];
+
+                    const uint32_t index =
+                        ring.Next.fetch_add(
+                            1,
+                            std::memory_order_relaxed
+                        );
+
+                    Slot& slot =
+                        ring.Slots[
+                            index &
+                            (ESPRESSIO_THREAD_TRACE_RING_CAPACITY - 1)
+                        ];
+
+                    slot.Sequence.store(
+                        2 * index + 1,
+                        std::memory_order_relaxed
+                    );
+
+                    std::atomic_thread_fence(
+                        std::memory_order_release
+                    );
+
+                    slot.Event.TimestampNanoseconds = _now();
+                    slot.Event.Argument = argument;
+                    slot.Event.Type = static_cast<uint8_t>(type);
+                    slot.Event.ThreadID = threadID;
+                    slot.Event.CoreID = coreID;
+                    slot.Event.Reserved = 0;
+
+                    slot.Sequence.store(
+                        2 * (index + 1),
+                        std::memory_order_release
+                    );
+                }
+
+
+                /// Copies every complete event, ordered by time and, within a
+                /// core, by recording order. Events being written at that
+                /// moment are skipped.
+                std::vector<ThreadTraceEvent> GetEvents() const {
+                    struct Entry {
+                        uint32_t Sequence;
+                        ThreadTraceEvent Event;
+                    };
+
+                    std::vector<Entry> entries;
+
+                    for (const Ring& ring : _rings) {
+                        for (const Slot& slot : ring.Slots) {
+                            const uint32_t before =
+                                slot.Sequence.load(
+                                    std::memory_order_acquire
+                                );
+
+                            if (
+                                before == 0 ||
+                                (before & 1) != 0
+                            ) {
+                                continue;
+                            }
+
+                            const ThreadTraceEvent event =
+                                slot.Event;
+
+                            std::atomic_thread_fence(
+                                std::memory_order_acquire
+                            );
+
+                            if (
+                                slot.Sequence.load(
+                                    std::memory_order_relaxed
+                                ) == before
+                            ) {
+                                entries.push_back({
+                                    before,
+                                    event
+                                });
+                            }
+                        }
+                    }
+
+                    // The clock may be coarser than back-to-back events.
+                    std::sort(
+                        entries.begin(),
+                        entries.end(),
+                        [](
+                            const Entry& left,
+                            const Entry& right
+                        ) {
+                            if (
+                                left.Event.TimestampNanoseconds !=
+                                right.Event.TimestampNanoseconds
+                            ) {
+                                return
+                                    left.Event.TimestampNanoseconds <
+                                    right.Event.TimestampNanoseconds;
+                            }
+
+                            if (left.Event.CoreID != right.Event.CoreID) {
+                                return
+                                    left.Event.CoreID <
+                                    right.Event.CoreID;
+                            }
+
+                            return
+                                left.Sequence <
+                                right.Sequence;
+                        }
+                    );
+
+                    std::vector<ThreadTraceEvent> events;
+
+                    events.reserve(
+                        entries.size()
+                    );
+
+                    for (const Entry& entry : entries) {
+                        events.push_back(
+                            entry.Event
+                        );
+                    }
+
+                    return events;
+                }
+
+
+                /// Events lost to ring wrap-around since the last Clear().
+                uint32_t GetOverwrittenCount() const {
+                    uint32_t overwritten = 0;
+
+                    for (const Ring& ring : _rings) {
+                        const uint32_t recorded =
+                            ring.Next.load(
+                                std::memory_order_acquire
+                            );
+
+                        if (recorded > ESPRESSIO_THREAD_TRACE_RING_CAPACITY) {
+                            overwritten +=
+                                recorded -
+                                ESPRESSIO_THREAD_TRACE_RING_CAPACITY;
+                        }
+                    }
+
+                    return overwritten;
+                }
+
+
+                /// Writes a ThreadTraceDumpHeader and the events through
+                /// `write` (for example to Serial or a file). Recording is
+                /// paused meanwhile.
+                void Dump(
+                    const std::function<
+                        void(
+                            const uint8_t*,
+                            std::size_t
+                        )
+                    >& write
+                ) {
+                    const bool wasRecording =
+                        _recording.exchange(
+                            false,
+                            std::memory_order_acq_rel
+                        );
+
+                    const std::vector<ThreadTraceEvent> events =
+                        GetEvents();
+
+                    ThreadTraceDumpHeader header;
+
+                    std::memcpy(
+                        header.Magic,
+                        "ESPT",
+                        4
+                    );
+
+                    header.Version = 1;
+                    header.EventSize = sizeof(ThreadTraceEvent);
+
+                    header.EventCount =
+                        static_cast<uint32_t>(
+                            events.size()
+                        );
+
+                    header.Overwritten =
+                        GetOverwrittenCount();
+
+                    write(
+                        reinterpret_cast<const uint8_t*>(
+                            &header
+                        ),
+                        sizeof(header)
+                    );
+
+                    if (!events.empty()) {
+                        write(
+                            reinterpret_cast<const uint8_t*>(
+                                events.data()
+                            ),
+                            events.size() *
+                                sizeof(ThreadTraceEvent)
+                        );
+                    }
+
+                    if (wasRecording) {
+                        Start();
+                    }
+                }
+        };
+
+    #endif
+
+
+    /// Records a trace event; compiled out unless ESPRESSIO_THREAD_TRACE.
+    inline void RecordThreadTrace(
+        ThreadTraceEventType type,
+        uint8_t threadID,
+        uint32_t argument = 0
+    ) {
+        #if ESPRESSIO_THREAD_TRACE
+            ThreadTraceRecorder::GetInstance()->
+                Record(
+                    type,
+                    threadID,
+                    argument
+                );
+        #else
+            static_cast<void>(type);
+            static_cast<void>(threadID);
+            static_cast<void>(argument);
+        #endif
+    }
+
+
+    /// Locks `mutex`, recording the wait when it is contended.
+    template <
+        typename TMutex
+    >
+    void LockWithThreadTrace(
+        TMutex& mutex,
+        uint8_t threadID,
+        ThreadTraceLock lock
+    ) {
+        #if ESPRESSIO_THREAD_TRACE
+            if (mutex.try_lock()) {
+                return;
+            }
+
+            RecordThreadTrace(
+                ThreadTraceEventType::LockWaitBegin,
+                threadID,
+                static_cast<uint32_t>(lock)
+            );
+
+            mutex.lock();
+
+            RecordThreadTrace(
+                ThreadTraceEventType::LockWaitEnd,
+                threadID,
+                static_cast<uint32_t>(lock)
+            );
+        #else
+            static_cast<void>(threadID);
+            static_cast<void>(lock);
+
+            mutex.lock();
+        #endif
+    }
+
+}
+}
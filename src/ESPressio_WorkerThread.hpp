@@ -0,0 +1,350 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ESPressio_IThreadExecutor.hpp"
+#include "ESPressio_Thread.hpp"
+
+// Most work items a ThreadWorkQueue holds before Post() returns false.
+#ifndef ESPRESSIO_THREAD_WORK_QUEUE_CAPACITY
+    #define ESPRESSIO_THREAD_WORK_QUEUE_CAPACITY 32
+#endif
+
+// Longest a WorkerThread waits for work, so Pause() and Terminate() are
+// noticed.
+#ifndef ESPRESSIO_THREAD_WORKER_MAX_WAIT_MILLISECONDS
+    #define ESPRESSIO_THREAD_WORKER_MAX_WAIT_MILLISECONDS 10
+#endif
+
+namespace ESPressio {
+namespace Threads {
+
+    /*
+     * Bounded FIFO of work shared by one or more WorkerThreads.
+     *
+     * A counting semaphore tracks queued items, so an idle worker blocks
+     * until there is work rather than polling.
+     */
+    class ThreadWorkQueue {
+        private:
+            std::mutex _mutex;
+
+            std::deque<
+                std::function<void()>
+            > _work;
+
+            SemaphoreHandle_t _available;
+
+
+        public:
+            ThreadWorkQueue() :
+                _available(
+                    xSemaphoreCreateCounting(
+                        ESPRESSIO_THREAD_WORK_QUEUE_CAPACITY,
+                        0
+                    )
+                ) {
+            }
+
+
+            ~ThreadWorkQueue() {
+                if (_available != nullptr) {
+                    vSemaphoreDelete(
+                        _available
+                    );
+                }
+            }
+
+
+            ThreadWorkQueue(
+                const ThreadWorkQueue&
+            ) = delete;
+
+            ThreadWorkQueue& operator=(
+                const ThreadWorkQueue&
+            ) = delete;
+
+
+            /// Returns `false` when the queue is full or `work` is empty.
+            bool Push(
+                std::function<void()> work
+            ) {
+                if (
+                    work == nullptr ||
+                    _available == nullptr
+                ) {
+                    return false;
+                }
+
+                {
+                    std::lock_guard<
+                        std::mutex
+                    > lock(_mutex);
+
+                    if (
+                        _work.size() >=
+                            ESPRESSIO_THREAD_WORK_QUEUE_CAPACITY
+                    ) {
+                        return false;
+                    }
+
+                    _work.push_back(
+                        std::move(work)
+                    );
+                }
+
+                xSemaphoreGive(
+                    _available
+                );
+
+                return true;
+            }
+
+
+            /// Waits up to `ticks` for work. Returns `false` on timeout.
+            bool Pop(
+                std::function<void()>& work,
+                TickType_t ticks
+            ) {
+                if (
+                    _available == nullptr ||
+                    xSemaphoreTake(
+                        _available,
+                        ticks
+                    ) != pdTRUE
+                ) {
+                    return false;
+                }
+
+                std::lock_guard<
+                    std::mutex
+                > lock(_mutex);
+
+                work =
+                    std::move(
+                        _work.front()
+                    );
+
+                _work.pop_front();
+
+                return true;
+            }
+
+
+            std::size_t GetCount() {
+                std::lock_guard<
+                    std::mutex
+                > lock(_mutex);
+
+                return _work.size();
+            }
+    };
+
+
+    /*
+     * A Thread that runs posted work in order.
+     *
+     * Several WorkerThreads may share one ThreadWorkQueue; WorkerThreadPool
+     * does this. Work that throws does not end the Thread: the exception is
+     * passed to OnWorkFailed() and the next item runs.
+     */
+    class WorkerThread :
+        public Thread,
+        public IThreadExecutor {
+
+        private:
+            std::shared_ptr<ThreadWorkQueue> _queue;
+
+
+        protected:
+            void OnLoop() override {
+                std::function<void()> work;
+
+                if (
+                    !_queue->Pop(
+                        work,
+                        pdMS_TO_TICKS(
+                            ESPRESSIO_THREAD_WORKER_MAX_WAIT_MILLISECONDS
+                        )
+                    )
+                ) {
+                    return;
+                }
+
+                try {
+                    work();
+                } catch (...) {
+                    try {
+                        OnWorkFailed(
+                            std::current_exception()
+                        );
+                    } catch (...) {
+                    }
+                }
+            }
+
+
+            /// Called on the worker task when posted work throws.
+            virtual void OnWorkFailed(
+                std::exception_ptr exception
+            ) {
+                (void)exception;
+            }
+
+
+        public:
+            WorkerThread() :
+                Thread(),
+                _queue(
+                    std::make_shared<ThreadWorkQueue>()
+                ) {
+            }
+
+
+            explicit WorkerThread(
+                bool freeOnTerminate
+            ) :
+                Thread(
+                    freeOnTerminate
+                ),
+                _queue(
+                    std::make_shared<ThreadWorkQueue>()
+                ) {
+            }
+
+
+            /// Takes work from `queue`, shared with other WorkerThreads.
+            explicit WorkerThread(
+                std::shared_ptr<ThreadWorkQueue> queue
+            ) :
+                Thread(),
+                _queue(
+                    queue != nullptr
+                        ? std::move(queue)
+                        : std::make_shared<ThreadWorkQueue>()
+                ) {
+            }
+
+
+            /// Stops the worker. Work still queued is destroyed without
+            /// running once no WorkerThread shares the queue.
+            ~WorkerThread() override {
+                Shutdown();
+            }
+
+
+            bool Post(
+                std::function<void()> work
+            ) override {
+                return
+                    _queue->Push(
+                        std::move(work)
+                    );
+            }
+
+
+            std::shared_ptr<ThreadWorkQueue> GetQueue() {
+                return _queue;
+            }
+    };
+
+
+    /*
+     * WorkerThreads sharing one queue: posted work runs on whichever worker
+     * is free first.
+     *
+     * Configure each worker through GetWorker() (core, stack size, priority)
+     * before Initialize().
+     */
+    class WorkerThreadPool :
+        public IThreadExecutor {
+
+        private:
+            std::shared_ptr<ThreadWorkQueue> _queue;
+
+            std::vector<
+                std::unique_ptr<WorkerThread>
+            > _workers;
+
+
+        public:
+            explicit WorkerThreadPool(
+                std::size_t workerCount
+            ) :
+                _queue(
+                    std::make_shared<ThreadWorkQueue>()
+                ) {
+                _workers.reserve(
+                    workerCount
+                );
+
+                for (
+                    std::size_t index = 0;
+                    index < workerCount;
+                    ++index
+                ) {
+                    _workers.emplace_back(
+                        new WorkerThread(
+                            _queue
+                        )
+                    );
+                }
+            }
+
+
+            WorkerThreadPool(
+                const WorkerThreadPool&
+            ) = delete;
+
+            WorkerThreadPool& operator=(
+                const WorkerThreadPool&
+            ) = delete;
+
+
+            void Initialize() {
+                for (
+                    std::unique_ptr<WorkerThread>& worker :
+                    _workers
+                ) {
+                    worker->Initialize();
+                }
+            }
+
+
+            bool Post(
+                std::function<void()> work
+            ) override {
+                return
+                    _queue->Push(
+                        std::move(work)
+                    );
+            }
+
+
+            std::size_t GetWorkerCount() const {
+                return _workers.size();
+            }
+
+
+            WorkerThread* GetWorker(
+                std::size_t index
+            ) {
+                return
+                    index < _workers.size()
+                        ? _workers[index].get()
+                        : nullptr;
+            }
+    };
+
+}
+}
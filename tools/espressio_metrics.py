@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Decodes an ESPressio-Threads binary metrics export.
+
+Capture the bytes written by ThreadMetrics::ExportBinary() to a file, then:
+
+    python3 espressio_metrics.py metrics.bin
+
+Prints each metric; histograms with their count, mean, minimum, maximum and
+percentiles. --json prints the decoded metrics as JSON instead.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+HEADER = struct.Struct("<4sHHBBH")
+TOTALS = struct.Struct("<QQQQ")
+BUCKET = struct.Struct("<HI")
+
+MAGIC = b"ESPM"
+VERSION = 1
+
+COUNTER = 1
+GAUGE = 2
+HISTOGRAM = 3
+
+PERCENTILES = (0.5, 0.9, 0.99, 0.999)
+
+
+class Layout:
+    """Mirror of ThreadMetricHistogramLayout."""
+
+    def __init__(self, precision_bits, range_bits):
+        self.sub_bucket_count = 1 << precision_bits
+        self.bucket_count = (
+            self.sub_bucket_count
+            + (range_bits - precision_bits) * (self.sub_bucket_count // 2)
+        )
+
+    def lower_bound(self, index):
+        if index < self.sub_bucket_count:
+            return index
+
+        half = self.sub_bucket_count // 2
+        offset = index - self.sub_bucket_count
+        shift = offset // half + 1
+        return (offset % half + half) << shift
+
+    def upper_bound(self, index):
+        if index + 1 >= self.bucket_count:
+            return 2 ** 64 - 1
+
+        return self.lower_bound(index + 1) - 1
+
+
+def percentile(layout, histogram, quantile):
+    """Same rule as ThreadMetricHistogramSnapshot::GetPercentile()."""
+    total = sum(count for _, count in histogram["buckets"])
+
+    if total == 0:
+        return 0
+
+    rank = max(1, int(quantile * total + 0.5))
+    seen = 0
+
+    for index, count in histogram["buckets"]:
+        seen += count
+
+        if seen >= rank:
+            return min(layout.upper_bound(index), histogram["maximum"])
+
+    return histogram["maximum"]
+
+
+def read_export(data):
+    """Returns (layout, metrics) from the bytes of one export."""
+    if len(data) < HEADER.size:
+        raise ValueError("export is shorter than its header")
+
+    magic, version, count, precision_bits, range_bits, _ = HEADER.unpack_from(data)
+
+    if magic != MAGIC:
+        raise ValueError("not an ESPressio-Threads metrics export")
+
+    if version != VERSION:
+        raise ValueError("unsupported export version %d" % version)
+
+    layout = Layout(precision_bits, range_bits)
+    offset = HEADER.size
+    metrics = []
+
+    for _ in range(count):
+        metric_type, name_length = struct.unpack_from("<BB", data, offset)
+        offset += 2
+
+        name = data[offset:offset + name_length].decode("utf-8", "replace")
+        offset += name_length
+
+        metric = {"name": name}
+
+        if metric_type == COUNTER:
+            metric["type"] = "counter"
+            metric["value"] = struct.unpack_from("<q", data, offset)[0]
+            offset += 8
+        elif metric_type == GAUGE:
+            metric["type"] = "gauge"
+            metric["value"] = struct.unpack_from("<q", data, offset)[0]
+            offset += 8
+        elif metric_type == HISTOGRAM:
+            total, value_sum, minimum, maximum = TOTALS.unpack_from(data, offset)
+            offset += TOTALS.size
+
+            (used,) = struct.unpack_from("<H", data, offset)
+            offset += 2
+
+            buckets = []
+
+            for _ in range(used):
+                buckets.append(BUCKET.unpack_from(data, offset))
+                offset += BUCKET.size
+
+            metric.update({
+                "type": "histogram",
+                "count": total,
+                "sum": value_sum,
+                "minimum": minimum,
+                "maximum": maximum,
+                "buckets": buckets,
+            })
+
+            metric["percentiles"] = {
+                str(quantile): percentile(layout, metric, quantile)
+                for quantile in PERCENTILES
+            }
+        else:
+            raise ValueError("unknown metric type %d for %s" % (metric_type, name))
+
+        metrics.append(metric)
+
+    return layout, metrics
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("export", help="bytes from ThreadMetrics::ExportBinary()")
+    parser.add_argument("--json", action="store_true", help="print JSON")
+    options = parser.parse_args()
+
+    with open(options.export, "rb") as source:
+        _, metrics = read_export(source.read())
+
+    if options.json:
+        json.dump(metrics, sys.stdout, indent=2)
+        print()
+        return
+
+    for metric in metrics:
+        if metric["type"] != "histogram":
+            print("%s %d" % (metric["name"], metric["value"]))
+            continue
+
+        if metric["count"] == 0:
+            print("%s count=0" % metric["name"])
+            continue
+
+        print(
+            "%s count=%d mean=%.1f min=%d max=%d %s" % (
+                metric["name"],
+                metric["count"],
+                metric["sum"] / metric["count"],
+                metric["minimum"],
+                metric["maximum"],
+                " ".join(
+                    "p%g=%d" % (float(quantile) * 100, value)
+                    for quantile, value in metric["percentiles"].items()
+                ),
+            )
+        )
+
+
+if __name__ == "__main__":
+    main()
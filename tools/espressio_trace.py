@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""Converts an ESPressio-Threads trace dump to Chrome trace JSON.
+
+Capture the bytes written by ThreadTraceRecorder::Dump() to a file, then:
+
+    python3 espressio_trace.py trace.bin trace.json
+
+Open the result in https://ui.perfetto.dev or chrome://tracing. Each core is
+shown as a process and each Thread ID as a thread.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+HEADER = struct.Struct("<4sHHII")
+EVENT = struct.Struct("<QIBBBB")
+
+MAGIC = b"ESPT"
+VERSION = 1
+
+STATES = [
+    "Uninitialized",
+    "Initialized",
+    "Running",
+    "Paused",
+    "Terminating",
+    "Terminated",
+    "Destroyed",
+]
+
+LOCKS = {
+    1: "StateTransition",
+}
+
+# Event type: (phase, name). "B"/"E" open and close a slice, "i" is instant.
+EVENT_TYPES = {
+    0: ("i", "StateChanged"),
+    1: ("B", "Loop"),
+    2: ("E", "Loop"),
+    3: ("B", "Iteration"),
+    4: ("E", "Iteration"),
+    5: ("i", "WorkWake"),
+    6: ("i", "IterationsSkipped"),
+    7: ("B", "TerminationDispatch"),
+    8: ("E", "TerminationDispatch"),
+    9: ("B", "GarbageCollection"),
+    10: ("E", "GarbageCollection"),
+    11: ("B", "LockWait"),
+    12: ("E", "LockWait"),
+    13: ("i", "Marker"),
+}
+
+
+def _state_name(value):
+    if value < len(STATES):
+        return STATES[value]
+
+    return str(value)
+
+
+def _arguments(event_type, argument):
+    if event_type == 0:
+        return {
+            "from": _state_name(argument >> 8),
+            "to": _state_name(argument & 0xFF),
+        }
+
+    if event_type == 6:
+        return {"skipped": argument}
+
+    if event_type == 10:
+        return {"threadsDeleted": argument}
+
+    if event_type in (11, 12):
+        return {"lock": LOCKS.get(argument, str(argument))}
+
+    if event_type == 13:
+        return {"value": argument}
+
+    return {}
+
+
+def read_dump(data):
+    """Returns (events, overwritten) from the bytes of one dump."""
+    if len(data) < HEADER.size:
+        raise ValueError("dump is shorter than its header")
+
+    magic, version, event_size, count, overwritten = HEADER.unpack_from(data)
+
+    if magic != MAGIC:
+        raise ValueError("not an ESPressio-Threads trace dump")
+
+    if version != VERSION or event_size != EVENT.size:
+        raise ValueError(
+            "unsupported dump version %d (event size %d)" % (version, event_size)
+        )
+
+    available = (len(data) - HEADER.size) // EVENT.size
+
+    if available < count:
+        print(
+            "warning: dump truncated, %d of %d events" % (available, count),
+            file=sys.stderr,
+        )
+        count = available
+
+    events = [
+        EVENT.unpack_from(data, HEADER.size + index * EVENT.size)
+        for index in range(count)
+    ]
+
+    return events, overwritten
+
+
+def to_chrome(events, overwritten):
+    """Builds the Chrome trace JSON object for decoded events."""
+    trace_events = []
+    cores = set()
+    threads = set()
+
+    # Open slices per (core, thread, name); an end whose begin was
+    # overwritten is dropped.
+    open_slices = {}
+
+    for timestamp, argument, event_type, thread_id, core_id, _ in events:
+        phase, name = EVENT_TYPES.get(event_type, ("i", "Unknown%d" % event_type))
+
+        key = (core_id, thread_id, name)
+
+        if phase == "B":
+            open_slices[key] = open_slices.get(key, 0) + 1
+        elif phase == "E":
+            if not open_slices.get(key):
+                continue
+
+            open_slices[key] -= 1
+
+        cores.add(core_id)
+        threads.add((core_id, thread_id))
+
+        record = {
+            "name": name,
+            "ph": phase,
+            "ts": timestamp / 1000.0,
+            "pid": core_id,
+            "tid": thread_id,
+        }
+
+        if phase == "i":
+            record["s"] = "t"
+
+        arguments = _arguments(event_type, argument)
+
+        if arguments:
+            record["args"] = arguments
+
+        trace_events.append(record)
+
+    for core_id in sorted(cores):
+        trace_events.append({
+            "name": "process_name",
+            "ph": "M",
+            "pid": core_id,
+            "args": {"name": "Core %d" % core_id},
+        })
+
+    for core_id, thread_id in sorted(threads):
+        trace_events.append({
+            "name": "thread_name",
+            "ph": "M",
+            "pid": core_id,
+            "tid": thread_id,
+            "args": {
+                "name": "Infrastructure" if thread_id == 0
+                else "Thread %d" % thread_id
+            },
+        })
+
+    return {
+        "traceEvents": trace_events,
+        "displayTimeUnit": "ns",
+        "otherData": {"overwritten": overwritten},
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="binary dump from ThreadTraceRecorder::Dump()")
+    parser.add_argument("output", nargs="?", help="JSON file (default: stdout)")
+    options = parser.parse_args()
+
+    with open(options.dump, "rb") as source:
+        events, overwritten = read_dump(source.read())
+
+    if overwritten:
+        print(
+            "warning: %d events were overwritten before the dump" % overwritten,
+            file=sys.stderr,
+        )
+
+    trace = to_chrome(events, overwritten)
+
+    if options.output:
+        with open(options.output, "w") as target:
+            json.dump(trace, target)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()